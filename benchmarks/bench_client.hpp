@@ -0,0 +1,153 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_BENCH_CLIENT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_BENCH_CLIENT_HPP_INCLUDED
+
+/// \file bench_client.hpp
+/// \brief Minimal blocking message-mode client used by the benchmarks.
+
+#include "SimpleNamedPipe/NamedPipeServer/Transport.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <system_error>
+
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace SimpleNamedPipe {
+namespace bench {
+
+    /// \class BlockingClient
+    /// \brief Connects to the server and exchanges whole messages synchronously.
+    class BlockingClient {
+    public:
+        BlockingClient() = default;
+        BlockingClient(const BlockingClient&) = delete;
+        BlockingClient& operator=(const BlockingClient&) = delete;
+
+        ~BlockingClient() {
+            close();
+        }
+
+        /// \brief Connects, retrying until the timeout expires.
+        /// \throws std::system_error on failure.
+        void open(const std::string& pipe_name, int timeout_ms = 5000) {
+            close();
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+            std::string path = "\\\\.\\pipe\\" + pipe_name;
+            for (;;) {
+                m_pipe = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+                if (m_pipe != INVALID_HANDLE_VALUE) break;
+                DWORD err = GetLastError();
+                if ((err != ERROR_PIPE_BUSY && err != ERROR_FILE_NOT_FOUND) ||
+                    std::chrono::steady_clock::now() >= deadline) {
+                    throw std::system_error(static_cast<int>(err), std::system_category(), "Failed to open pipe");
+                }
+                if (err == ERROR_PIPE_BUSY) {
+                    WaitNamedPipeA(path.c_str(), 100);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+            DWORD mode = PIPE_READMODE_MESSAGE;
+            SetNamedPipeHandleState(m_pipe, &mode, nullptr, nullptr);
+#else
+            sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::string path = detail::make_unix_socket_path(pipe_name);
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            for (;;) {
+                m_fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+                if (m_fd < 0) {
+                    throw std::system_error(errno, std::system_category(), "Failed to create socket");
+                }
+                if (::connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) break;
+                int err = errno;
+                ::close(m_fd);
+                m_fd = -1;
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    throw std::system_error(err, std::system_category(), "Failed to connect");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+#endif
+        }
+
+        /// \brief Closes the connection.
+        void close() {
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+            if (m_pipe != INVALID_HANDLE_VALUE) {
+                CloseHandle(m_pipe);
+                m_pipe = INVALID_HANDLE_VALUE;
+            }
+#else
+            if (m_fd >= 0) {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+#endif
+        }
+
+        /// \brief Sends one message.
+        bool write(const std::string& message) {
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+            DWORD written = 0;
+            return WriteFile(m_pipe, message.data(), static_cast<DWORD>(message.size()), &written, nullptr) &&
+                written == message.size();
+#else
+            ssize_t sent;
+            do {
+                sent = ::send(m_fd, message.data(), message.size(), MSG_NOSIGNAL);
+            } while (sent < 0 && errno == EINTR);
+            return sent == static_cast<ssize_t>(message.size());
+#endif
+        }
+
+        /// \brief Receives one message.
+        /// \return false when the connection is closed.
+        bool read(std::string& message) {
+            if (m_buffer.empty()) m_buffer.resize(1 << 20);
+            message.clear();
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+            for (;;) {
+                DWORD bytes = 0;
+                BOOL ok = ReadFile(m_pipe, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), &bytes, nullptr);
+                message.append(m_buffer.data(), bytes);
+                if (ok) return true;
+                if (GetLastError() != ERROR_MORE_DATA) return false;
+            }
+#else
+            ssize_t received;
+            do {
+                received = ::recv(m_fd, &m_buffer[0], m_buffer.size(), 0);
+            } while (received < 0 && errno == EINTR);
+            if (received <= 0) return false;
+            message.assign(m_buffer.data(), static_cast<size_t>(received));
+            return true;
+#endif
+        }
+
+    private:
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+        HANDLE m_pipe = INVALID_HANDLE_VALUE;
+#else
+        int    m_fd = -1;
+#endif
+        std::vector<char> m_buffer;
+    };
+
+} // namespace bench
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_BENCH_CLIENT_HPP_INCLUDED
@@ -0,0 +1,444 @@
+/// \file benchmark_suite.cpp
+/// \brief Regression suite: ping-pong latency, one-way throughput, fan-out and send_to() contention.
+///
+/// Every scenario runs an in-process server against blocking clients and
+/// reports machine-readable results, so runs can be compared across releases.
+///
+/// Usage: benchmark_suite [--scenarios pingpong,throughput,fanout,contention]
+///                        [--format text|json|csv] [--output FILE] [--quick]
+///                        [--pingpong-sizes 64,1024,16384] [--throughput-sizes 64,...,1048576]
+///                        [--fanout-clients N] [--producers N]
+///
+/// CSV output is in long format: scenario,case,metric,value.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "bench_client.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::vector<std::string> scenarios{"pingpong", "throughput", "fanout", "contention"};
+        std::string format = "text";
+        std::string output;
+        bool quick = false;
+        std::vector<size_t> pingpong_sizes{64, 1024, 16384};
+        std::vector<size_t> throughput_sizes{64, 1024, 16384, 65536, 1048576};
+        size_t fanout_clients = 32;
+        size_t producers = 4;
+    };
+
+    /// \brief One measured case: named numeric metrics, formatted when added.
+    struct Result {
+        std::string scenario;
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> metrics;
+
+        /// Counts and sizes, printed exactly.
+        void add(const std::string& key, uint64_t value) {
+            metrics.emplace_back(key, std::to_string(value));
+        }
+
+        /// Rates and latencies, printed without an exponent.
+        void add(const std::string& key, double value) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(3) << value;
+            metrics.emplace_back(key, text.str());
+        }
+    };
+
+    std::vector<std::string> split(const std::string& text) {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    std::vector<size_t> split_sizes(const std::string& text) {
+        std::vector<size_t> sizes;
+        for (const auto& item : split(text)) sizes.push_back(std::strtoul(item.c_str(), nullptr, 10));
+        return sizes;
+    }
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--quick") {
+                options.quick = true;
+                continue;
+            }
+            if (i + 1 >= argc) break;
+            const std::string value = argv[++i];
+            if (arg == "--scenarios") options.scenarios = split(value);
+            else if (arg == "--format") options.format = value;
+            else if (arg == "--output") options.output = value;
+            else if (arg == "--pingpong-sizes") options.pingpong_sizes = split_sizes(value);
+            else if (arg == "--throughput-sizes") options.throughput_sizes = split_sizes(value);
+            else if (arg == "--fanout-clients") options.fanout_clients = std::strtoul(value.c_str(), nullptr, 10);
+            else if (arg == "--producers") options.producers = std::strtoul(value.c_str(), nullptr, 10);
+        }
+        return options;
+    }
+
+    ServerConfig make_config(const std::string& name) {
+        ServerConfig config("SimpleNamedPipeSuite_" + name, 65536);
+        config.write_limits.max_message_size = 4 * 1024 * 1024;
+        config.write_limits.max_pending_writes_per_client = 1 << 20;
+        return config;
+    }
+
+    double seconds_since(Clock::time_point started) {
+        return std::chrono::duration<double>(Clock::now() - started).count();
+    }
+
+    double percentile(const std::vector<double>& sorted, double q) {
+        if (sorted.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+        return sorted[(std::min)(rank, sorted.size() - 1)];
+    }
+
+    /// \brief Collects the ids of connecting clients.
+    class ClientIds {
+    public:
+        void add(int client_id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ids.push_back(client_id);
+        }
+
+        std::vector<int> wait(size_t count) {
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_ids.size() >= count) return m_ids;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<int> m_ids;
+    };
+
+    void wait_for(const std::atomic<size_t>& counter, size_t target) {
+        while (counter.load(std::memory_order_acquire) < target) std::this_thread::yield();
+    }
+
+    /// \brief Round trips of one client against an echo server.
+    void run_pingpong(const Options& options, std::vector<Result>& results) {
+        ServerConfig config = make_config("pingpong");
+        NamedPipeServer server(config);
+        server.on_message_view = [&server](int client_id, MessageView message) {
+            server.send_to(client_id, message.to_string());
+        };
+        server.start();
+
+        bench::BlockingClient client;
+        client.open(config.pipe_name);
+
+        const size_t count = options.quick ? 500 : 5000;
+        std::string reply;
+        for (size_t size : options.pingpong_sizes) {
+            const std::string payload(size, 'p');
+            for (size_t i = 0; i < count / 10; ++i) {
+                client.write(payload);
+                client.read(reply);
+            }
+
+            std::vector<double> rtt_us;
+            rtt_us.reserve(count);
+            const auto started = Clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                const auto sent = Clock::now();
+                client.write(payload);
+                client.read(reply);
+                rtt_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+            }
+            const double seconds = seconds_since(started);
+            std::sort(rtt_us.begin(), rtt_us.end());
+
+            Result result{"pingpong", "size=" + std::to_string(size), {}};
+            result.add("size", static_cast<uint64_t>(size));
+            result.add("messages", static_cast<uint64_t>(count));
+            result.add("round_trips_per_sec", count / seconds);
+            result.add("rtt_p50_us", percentile(rtt_us, 0.50));
+            result.add("rtt_p90_us", percentile(rtt_us, 0.90));
+            result.add("rtt_p99_us", percentile(rtt_us, 0.99));
+            result.add("rtt_p999_us", percentile(rtt_us, 0.999));
+            result.add("rtt_max_us", rtt_us.back());
+            results.push_back(result);
+        }
+
+        client.close();
+        server.stop();
+    }
+
+    /// \brief Server-to-client stream of one shared payload per message size.
+    void run_throughput(const Options& options, std::vector<Result>& results) {
+        ServerConfig config = make_config("throughput");
+        NamedPipeServer server(config);
+        ClientIds ids;
+        server.on_connected = [&ids](int client_id) { ids.add(client_id); };
+        server.start();
+
+        bench::BlockingClient client;
+        client.open(config.pipe_name);
+        const int client_id = ids.wait(1).front();
+
+        std::atomic<size_t> received{0};
+        std::thread reader([&client, &received] {
+            std::string chunk;
+            while (client.read(chunk)) {
+                received.fetch_add(chunk.size(), std::memory_order_acq_rel);
+            }
+        });
+
+        const size_t volume = options.quick ? (size_t(8) << 20) : (size_t(128) << 20);
+        for (size_t size : options.throughput_sizes) {
+            const size_t count = (std::max)(volume / (std::max)(size, size_t(1)), size_t(16));
+            BufferPtr payload = make_buffer(std::string(size, 't'));
+            const size_t target = received.load() + count * size;
+
+            const auto before = server.get_metrics().traffic.write_latency;
+            const auto started = Clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                server.send_to(client_id, payload);
+            }
+            wait_for(received, target);
+            const double seconds = seconds_since(started);
+
+            LatencyHistogram latency = server.get_metrics().traffic.write_latency;
+            for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) latency.counts[i] -= before.counts[i];
+
+            Result result{"throughput", "size=" + std::to_string(size), {}};
+            result.add("size", static_cast<uint64_t>(size));
+            result.add("messages", static_cast<uint64_t>(count));
+            result.add("messages_per_sec", count / seconds);
+            result.add("mib_per_sec", count * size / seconds / (1024.0 * 1024.0));
+            result.add("queue_latency_p50_us", latency.percentile_us(0.50));
+            result.add("queue_latency_p99_us", latency.percentile_us(0.99));
+            results.push_back(result);
+        }
+
+        server.stop();
+        reader.join();
+    }
+
+    /// \brief broadcast() of small messages to many clients.
+    void run_fanout(const Options& options, std::vector<Result>& results) {
+        ServerConfig config = make_config("fanout");
+        NamedPipeServer server(config);
+        ClientIds ids;
+        server.on_connected = [&ids](int client_id) { ids.add(client_id); };
+        server.start();
+
+        const size_t clients_count = options.quick ? (std::min)(options.fanout_clients, size_t(8)) : options.fanout_clients;
+        const size_t count = options.quick ? 500 : 5000;
+        const size_t size = 64;
+
+        std::vector<std::unique_ptr<bench::BlockingClient>> clients;
+        std::vector<std::thread> readers;
+        std::atomic<size_t> delivered{0};
+        for (size_t i = 0; i < clients_count; ++i) {
+            clients.emplace_back(new bench::BlockingClient());
+            clients.back()->open(config.pipe_name);
+            bench::BlockingClient* client = clients.back().get();
+            readers.emplace_back([client, &delivered] {
+                std::string message;
+                while (client->read(message)) {
+                    delivered.fetch_add(1, std::memory_order_acq_rel);
+                }
+            });
+        }
+        ids.wait(clients_count);
+
+        BufferPtr payload = make_buffer(std::string(size, 'f'));
+        const auto started = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            server.broadcast(payload);
+        }
+        wait_for(delivered, count * clients_count);
+        const double seconds = seconds_since(started);
+
+        Result result{"fanout", "clients=" + std::to_string(clients_count), {}};
+        result.add("clients", static_cast<uint64_t>(clients_count));
+        result.add("size", static_cast<uint64_t>(size));
+        result.add("broadcasts", static_cast<uint64_t>(count));
+        result.add("broadcasts_per_sec", count / seconds);
+        result.add("deliveries_per_sec", count * clients_count / seconds);
+        results.push_back(result);
+
+        server.stop();
+        for (auto& reader : readers) reader.join();
+    }
+
+    /// \brief Several threads calling send_to() for the same clients.
+    void run_contention(const Options& options, std::vector<Result>& results) {
+        ServerConfig config = make_config("contention");
+        NamedPipeServer server(config);
+        ClientIds ids;
+        server.on_connected = [&ids](int client_id) { ids.add(client_id); };
+        server.start();
+
+        const size_t clients_count = 8;
+        const size_t per_producer = options.quick ? 20000 : 200000;
+        const size_t size = 32;
+
+        std::vector<std::unique_ptr<bench::BlockingClient>> clients;
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < clients_count; ++i) {
+            clients.emplace_back(new bench::BlockingClient());
+            clients.back()->open(config.pipe_name);
+            bench::BlockingClient* client = clients.back().get();
+            readers.emplace_back([client] {
+                std::string message;
+                while (client->read(message)) {}
+            });
+        }
+        const std::vector<int> client_ids = ids.wait(clients_count);
+
+        const size_t total = options.producers * per_producer;
+        std::atomic<size_t> completed{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<bool> go{false};
+        std::vector<double> send_ns(options.producers);
+        std::vector<std::thread> producers;
+        const std::string payload(size, 'c');
+
+        for (size_t p = 0; p < options.producers; ++p) {
+            producers.emplace_back([&, p] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                const auto started = Clock::now();
+                for (size_t n = 0; n < per_producer; ++n) {
+                    server.send_to(client_ids[(p + n) % client_ids.size()], payload, [&](const std::error_code& ec) {
+                        if (ec) failed.fetch_add(1, std::memory_order_relaxed);
+                        completed.fetch_add(1, std::memory_order_acq_rel);
+                    });
+                }
+                send_ns[p] = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / per_producer;
+            });
+        }
+
+        const auto started = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& producer : producers) producer.join();
+        wait_for(completed, total);
+        const double seconds = seconds_since(started);
+
+        double ns_per_send = 0.0;
+        for (double ns : send_ns) ns_per_send += ns;
+        ns_per_send /= (std::max)(options.producers, size_t(1));
+
+        Result result{"contention", "producers=" + std::to_string(options.producers), {}};
+        result.add("producers", static_cast<uint64_t>(options.producers));
+        result.add("clients", static_cast<uint64_t>(clients_count));
+        result.add("size", static_cast<uint64_t>(size));
+        result.add("messages", static_cast<uint64_t>(total));
+        result.add("send_to_ns", ns_per_send);
+        result.add("messages_per_sec", total / seconds);
+        result.add("failed", static_cast<uint64_t>(failed.load()));
+        results.push_back(result);
+
+        server.stop();
+        for (auto& reader : readers) reader.join();
+    }
+
+    std::string timestamp() {
+        std::time_t now = std::time(nullptr);
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        return text;
+    }
+
+    const char* backend_name() {
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+        return "win32";
+#else
+        return "unix";
+#endif
+    }
+
+    void write_json(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+        out << "{\n"
+            << "  \"suite\": \"SimpleNamedPipe\",\n"
+            << "  \"timestamp\": \"" << timestamp() << "\",\n"
+            << "  \"backend\": \"" << backend_name() << "\",\n"
+            << "  \"cores\": " << std::thread::hardware_concurrency() << ",\n"
+            << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n"
+            << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            out << "    {\"scenario\": \"" << result.scenario << "\", \"case\": \"" << result.name << "\"";
+            for (const auto& metric : result.metrics) {
+                out << ", \"" << metric.first << "\": " << metric.second;
+            }
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    void write_csv(std::ostream& out, const std::vector<Result>& results) {
+        out << "scenario,case,metric,value\n";
+        for (const auto& result : results) {
+            for (const auto& metric : result.metrics) {
+                out << result.scenario << ',' << result.name << ',' << metric.first << ',' << metric.second << '\n';
+            }
+        }
+    }
+
+    void write_text(std::ostream& out, const std::vector<Result>& results) {
+        for (const auto& result : results) {
+            out << std::left << std::setw(12) << result.scenario << std::setw(16) << result.name;
+            for (const auto& metric : result.metrics) {
+                out << ' ' << metric.first << '=' << metric.second;
+            }
+            out << '\n';
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Options options = parse_options(argc, argv);
+
+    std::vector<Result> results;
+    for (const auto& scenario : options.scenarios) {
+        std::cerr << "running " << scenario << "..." << std::endl;
+        if (scenario == "pingpong") run_pingpong(options, results);
+        else if (scenario == "throughput") run_throughput(options, results);
+        else if (scenario == "fanout") run_fanout(options, results);
+        else if (scenario == "contention") run_contention(options, results);
+        else std::cerr << "unknown scenario: " << scenario << std::endl;
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "cannot open " << options.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    if (options.format == "json") write_json(out, options, results);
+    else if (options.format == "csv") write_csv(out, results);
+    else write_text(out, results);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/// \file io_poll_benchmark.cpp
+/// \brief Echo latency and completion-queue waits per message with and without ServerConfig::io_spin_us.
+///
+/// Usage: io_poll_benchmark [--messages N] [--size BYTES] [--clients N] [--spin-us N]
+///
+/// Every client does a ping-pong with the server; one-way latency is half of
+/// the round trip. `waits/msg` counts the server's completion-queue dequeues
+/// (one system call each) per echoed message, `events/wait` how many
+/// completions one dequeue returned. Busy-polling trades a core and extra
+/// non-blocking dequeues for a server that is already awake when a message
+/// arrives; it pays off only with a free core per I/O thread.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "bench_client.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    struct Options {
+        size_t messages = 20000;    ///< Per client
+        size_t size = 64;
+        size_t clients = 8;
+        size_t spin_us = 50;
+    };
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* value = argv[i + 1];
+            if (std::strcmp(argv[i], "--messages") == 0) options.messages = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--size") == 0) options.size = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--clients") == 0) options.clients = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--spin-us") == 0) options.spin_us = std::strtoul(value, nullptr, 10);
+        }
+        return options;
+    }
+
+    struct Result {
+        double p50_ns = 0;
+        double p99_ns = 0;
+        double waits_per_message = 0;
+        double events_per_wait = 0;
+        size_t failures = 0;
+    };
+
+    Result run(const Options& options, size_t clients, size_t spin_us) {
+        ServerConfig config("SimpleNamedPipePollBench", 65536);
+        config.io_spin_us = spin_us;
+        config.metrics.enabled = true;
+        NamedPipeServer server(config);
+        server.on_message_view = [&server](int client_id, MessageView message) {
+            server.send_to(client_id, message.to_string());
+        };
+        server.start();
+
+        std::vector<std::unique_ptr<bench::BlockingClient>> connections;
+        for (size_t i = 0; i < clients; ++i) {
+            connections.emplace_back(new bench::BlockingClient());
+            connections.back()->open(config.pipe_name);
+        }
+
+        // Connects and listens do not count
+        const ServerMetrics before = server.get_metrics();
+        std::atomic<size_t> failures{0};
+        std::vector<std::vector<double>> samples(clients);
+        std::vector<std::thread> threads;
+        const std::string payload(options.size, 'x');
+        for (size_t i = 0; i < clients; ++i) {
+            threads.emplace_back([&, i] {
+                std::string reply;
+                samples[i].reserve(options.messages);
+                for (size_t n = 0; n < options.messages; ++n) {
+                    auto started = std::chrono::steady_clock::now();
+                    if (!connections[i]->write(payload) || !connections[i]->read(reply)) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    samples[i].push_back(std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - started).count() / 2);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        const ServerMetrics after = server.get_metrics();
+
+        connections.clear();
+        server.stop();
+
+        Result result;
+        result.failures = failures.load();
+        std::vector<double> all;
+        for (const auto& items : samples) all.insert(all.end(), items.begin(), items.end());
+        std::sort(all.begin(), all.end());
+        if (!all.empty()) {
+            result.p50_ns = all[all.size() / 2];
+            result.p99_ns = all[all.size() * 99 / 100];
+        }
+        const double waits = static_cast<double>(after.io_waits - before.io_waits);
+        const double events = static_cast<double>(after.io_events - before.io_events);
+        const double echoed = static_cast<double>(after.traffic.messages_out - before.traffic.messages_out);
+        if (echoed > 0) result.waits_per_message = waits / echoed;
+        if (waits > 0) result.events_per_wait = events / waits;
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+    std::cout << "messages=" << options.messages << " per client"
+              << " size=" << options.size
+              << " cores=" << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(8) << "clients" << std::setw(16) << "mode"
+              << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns"
+              << std::setw(12) << "waits/msg" << std::setw(13) << "events/wait" << std::endl;
+
+    const size_t client_counts[] = {1, options.clients};
+    for (size_t clients : client_counts) {
+        for (size_t spin_us : {size_t(0), options.spin_us}) {
+            Result result = run(options, clients, spin_us);
+            std::cout << std::setw(8) << clients
+                      << std::setw(16) << (spin_us ? "spin " + std::to_string(spin_us) + " us" : std::string("blocking"))
+                      << std::fixed << std::setprecision(0)
+                      << std::setw(12) << result.p50_ns << std::setw(12) << result.p99_ns
+                      << std::setprecision(2)
+                      << std::setw(12) << result.waits_per_message << std::setw(13) << result.events_per_wait;
+            if (result.failures) std::cout << "  (" << result.failures << " clients failed)";
+            std::cout << std::endl;
+        }
+        if (options.clients == 1) break;
+    }
+    return 0;
+}
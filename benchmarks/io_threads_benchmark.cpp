@@ -0,0 +1,129 @@
+/// \file io_threads_benchmark.cpp
+/// \brief Echo throughput of many concurrent clients for different ServerConfig::io_threads values.
+///
+/// Usage: io_threads_benchmark [--clients N] [--messages N] [--size BYTES]
+///                             [--work-us N] [--threads 1,2,4]
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "bench_client.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    struct Options {
+        size_t clients = 128;
+        size_t messages = 2000;
+        size_t size = 64;
+        size_t work_us = 0;
+        std::vector<size_t> threads;
+    };
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* value = argv[i + 1];
+            if (std::strcmp(argv[i], "--clients") == 0) options.clients = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--messages") == 0) options.messages = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--size") == 0) options.size = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--work-us") == 0) options.work_us = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--threads") == 0) {
+                std::stringstream ss(value);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    options.threads.push_back(std::strtoul(item.c_str(), nullptr, 10));
+                }
+            }
+        }
+        if (options.threads.empty()) {
+            size_t cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+            for (size_t n = 1; n < cores; n *= 2) options.threads.push_back(n);
+            options.threads.push_back(cores);
+        }
+        return options;
+    }
+
+    // Simulates CPU work done by a message handler
+    void spin_for(size_t microseconds) {
+        if (microseconds == 0) return;
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+
+    double run(const Options& options, size_t io_threads) {
+        ServerConfig config("SimpleNamedPipeBench", 65536);
+        config.io_threads = io_threads;
+        NamedPipeServer server(config);
+        server.on_message = [&server, &options](int client_id, const std::string& message) {
+            spin_for(options.work_us);
+            server.send_to(client_id, message);
+        };
+        server.start();
+
+        std::vector<std::unique_ptr<bench::BlockingClient>> clients;
+        for (size_t i = 0; i < options.clients; ++i) {
+            clients.emplace_back(new bench::BlockingClient());
+            clients.back()->open(config.pipe_name);
+        }
+
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::atomic<size_t> failures{0};
+        std::vector<std::thread> threads;
+        const std::string payload(options.size, 'x');
+        for (size_t i = 0; i < options.clients; ++i) {
+            bench::BlockingClient* client = clients[i].get();
+            threads.emplace_back([&, client] {
+                std::string reply;
+                ++ready;
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (size_t n = 0; n < options.messages; ++n) {
+                    if (!client->write(payload) || !client->read(reply) || reply.size() != payload.size()) {
+                        ++failures;
+                        return;
+                    }
+                }
+            });
+        }
+        while (ready.load() < options.clients) std::this_thread::yield();
+
+        auto started = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) thread.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        clients.clear();
+        server.stop();
+        if (failures) {
+            std::cerr << "io_threads=" << io_threads << ": " << failures << " clients failed" << std::endl;
+        }
+        return static_cast<double>(options.clients * options.messages) / seconds;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+    std::cout << "clients=" << options.clients
+              << " messages=" << options.messages
+              << " size=" << options.size
+              << " work_us=" << options.work_us
+              << " cores=" << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(12) << "io_threads" << std::setw(16) << "msg/s" << std::setw(10) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    for (size_t io_threads : options.threads) {
+        double rate = run(options, io_threads);
+        if (baseline == 0.0) baseline = rate;
+        std::cout << std::setw(12) << io_threads
+                  << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(10) << std::setprecision(2) << rate / baseline << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+/// \file journal_replay.cpp
+/// \brief Replays a journal recorded with ServerConfig::journal.
+///
+/// Usage: journal_replay --journal PATH [--mode clients|server] [--pipe NAME]
+///                       [--speed max|FACTOR] [--wait-ms N]
+///
+/// `--mode clients` (the default) connects one NamedPipeClient per journaled
+/// client id to the server at `--pipe` and sends the inbound messages, so a
+/// server under test sees the recorded traffic. `--mode server` runs a stub
+/// server at `--pipe` that sends the outbound messages to the clients under
+/// test; the n-th client to connect plays the n-th journaled client id.
+///
+/// Messages keep their recorded spacing, scaled by `--speed` (2 is twice as
+/// fast); `--speed max` sends them back to back.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "SimpleNamedPipe/NamedPipeClient.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    struct Options {
+        std::string journal;
+        std::string pipe = "ExamplePipe";
+        bool is_server = false;
+        double speed = 1.0;            ///< 0 sends as fast as possible
+        size_t wait_ms = 10000;        ///< Server mode: how long to wait for the clients
+    };
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* value = argv[i + 1];
+            if (std::strcmp(argv[i], "--journal") == 0) options.journal = value;
+            else if (std::strcmp(argv[i], "--pipe") == 0) options.pipe = value;
+            else if (std::strcmp(argv[i], "--mode") == 0) options.is_server = std::strcmp(value, "server") == 0;
+            else if (std::strcmp(argv[i], "--speed") == 0) {
+                options.speed = std::strcmp(value, "max") == 0 ? 0.0 : std::strtod(value, nullptr);
+            }
+            else if (std::strcmp(argv[i], "--wait-ms") == 0) options.wait_ms = std::strtoul(value, nullptr, 10);
+        }
+        return options;
+    }
+
+    struct Message {
+        uint64_t    time_ns;
+        int         client_id;
+        std::string data;
+    };
+
+    /// Messages of one direction in journal order; streamed chunks are joined
+    std::vector<Message> load(const std::string& path, JournalDirection direction) {
+        JournalReader reader;
+        std::error_code ec;
+        if (!reader.open(path, ec)) {
+            throw std::system_error(ec, "Failed to open journal " + path);
+        }
+        std::vector<Message> messages;
+        std::map<int, std::string> partial;
+        JournalRecord record;
+        while (reader.next(record)) {
+            if (record.direction != direction) continue;
+            auto it = partial.find(record.client_id);
+            if (!record.is_partial && it == partial.end()) {
+                messages.push_back(Message{record.time_ns, record.client_id, record.data.to_string()});
+                continue;
+            }
+            std::string& data = partial[record.client_id];
+            data.append(record.data.data(), record.data.size());
+            if (record.is_partial) continue;
+            messages.push_back(Message{record.time_ns, record.client_id, std::move(data)});
+            partial.erase(record.client_id);
+        }
+        if (reader.error()) {
+            std::cerr << "journal is damaged after " << messages.size() << " messages: "
+                      << reader.error().message() << std::endl;
+        }
+        return messages;
+    }
+
+    /// Sleeps until the recorded offset of `message`, scaled by the speed
+    class Pacer {
+    public:
+        Pacer(const std::vector<Message>& messages, double speed)
+            : m_speed(speed), m_first_ns(messages.empty() ? 0 : messages.front().time_ns),
+              m_started(std::chrono::steady_clock::now()) {}
+
+        void wait(const Message& message) const {
+            if (m_speed <= 0) return;
+            const auto offset = std::chrono::nanoseconds(
+                static_cast<int64_t>(static_cast<double>(message.time_ns - m_first_ns) / m_speed));
+            std::this_thread::sleep_until(m_started + offset);
+        }
+
+        double elapsed_s() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_started).count();
+        }
+
+    private:
+        double m_speed;
+        uint64_t m_first_ns;
+        std::chrono::steady_clock::time_point m_started;
+    };
+
+    struct Totals {
+        std::atomic<size_t> sent{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<size_t> received{0};
+    };
+
+    void report(const std::vector<Message>& messages, const Totals& totals, double elapsed_s) {
+        size_t bytes = 0;
+        for (const auto& message : messages) bytes += message.data.size();
+        const double recorded_s = messages.empty() ? 0.0
+            : static_cast<double>(messages.back().time_ns - messages.front().time_ns) / 1e9;
+        std::cout << std::fixed << std::setprecision(3)
+                  << "messages=" << messages.size() << " bytes=" << bytes
+                  << " recorded_s=" << recorded_s << " replay_s=" << elapsed_s << std::endl
+                  << "sent=" << totals.sent.load() << " failed=" << totals.failed.load()
+                  << " received=" << totals.received.load()
+                  << " msg_per_s=" << std::setprecision(0) << (elapsed_s > 0 ? totals.sent.load() / elapsed_s : 0.0)
+                  << std::endl;
+    }
+
+    NamedPipeClient::DoneCallback count_done(Totals& totals) {
+        return [&totals](const std::error_code& ec) {
+            if (ec) totals.failed.fetch_add(1, std::memory_order_relaxed);
+            else totals.sent.fetch_add(1, std::memory_order_relaxed);
+        };
+    }
+
+    void replay_clients(const Options& options) {
+        const std::vector<Message> messages = load(options.journal, JournalDirection::Inbound);
+        Totals totals;
+        // Clients connect when their first message is due, like the recorded ones
+        std::map<int, std::unique_ptr<NamedPipeClient>> clients;
+        Pacer pacer(messages, options.speed);
+        for (const Message& message : messages) {
+            pacer.wait(message);
+            std::unique_ptr<NamedPipeClient>& client = clients[message.client_id];
+            if (!client) {
+                ClientConfig config(options.pipe);
+                config.write_limits.max_pending_writes = (std::numeric_limits<size_t>::max)();
+                config.write_limits.max_message_size = (std::numeric_limits<size_t>::max)();
+                // Without a server the queued messages fail instead of waiting forever
+                config.reconnect.max_attempts = 20;
+                client.reset(new NamedPipeClient(config));
+                client->on_message_view = [&totals](MessageView) {
+                    totals.received.fetch_add(1, std::memory_order_relaxed);
+                };
+                client->start();
+            }
+            client->send(message.data, count_done(totals));
+        }
+        while (totals.sent.load() + totals.failed.load() < messages.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const double elapsed_s = pacer.elapsed_s();
+        // Late replies
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        for (auto& item : clients) item.second->stop();
+        report(messages, totals, elapsed_s);
+    }
+
+    void replay_server(const Options& options) {
+        const std::vector<Message> messages = load(options.journal, JournalDirection::Outbound);
+        std::vector<int> recorded_ids;
+        for (const Message& message : messages) {
+            if (std::find(recorded_ids.begin(), recorded_ids.end(), message.client_id) == recorded_ids.end()) {
+                recorded_ids.push_back(message.client_id);
+            }
+        }
+
+        ServerConfig config(options.pipe);
+        config.write_limits.max_pending_writes_per_client = (std::numeric_limits<size_t>::max)();
+        config.write_limits.max_message_size = (std::numeric_limits<size_t>::max)();
+        NamedPipeServer server(config);
+        Totals totals;
+        std::mutex mutex;
+        std::vector<int> live_ids;
+        server.on_connected = [&](int client_id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            live_ids.push_back(client_id);
+        };
+        server.on_message_view = [&totals](int, MessageView) {
+            totals.received.fetch_add(1, std::memory_order_relaxed);
+        };
+        server.start();
+
+        std::cout << "waiting for " << recorded_ids.size() << " clients on " << options.pipe << std::endl;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.wait_ms);
+        std::map<int, int> id_map;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = id_map.size(); i < live_ids.size() && i < recorded_ids.size(); ++i) {
+                    id_map[recorded_ids[i]] = live_ids[i];
+                }
+            }
+            if (id_map.size() == recorded_ids.size() || std::chrono::steady_clock::now() >= deadline) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (id_map.size() < recorded_ids.size()) {
+            std::cout << "only " << id_map.size() << " clients connected, messages to the others are skipped" << std::endl;
+        }
+
+        size_t expected = 0;
+        Pacer pacer(messages, options.speed);
+        for (const Message& message : messages) {
+            auto it = id_map.find(message.client_id);
+            if (it == id_map.end()) continue;
+            pacer.wait(message);
+            server.send_to(it->second, message.data, count_done(totals));
+            ++expected;
+        }
+        while (totals.sent.load() + totals.failed.load() < expected) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const double elapsed_s = pacer.elapsed_s();
+        server.stop();
+        report(messages, totals, elapsed_s);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+    if (options.journal.empty()) {
+        std::cerr << "usage: journal_replay --journal PATH [--mode clients|server] [--pipe NAME]"
+                     " [--speed max|FACTOR] [--wait-ms N]" << std::endl;
+        return 1;
+    }
+    try {
+        if (options.is_server) replay_server(options);
+        else replay_clients(options);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
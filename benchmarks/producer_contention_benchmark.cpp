@@ -0,0 +1,123 @@
+/// \file producer_contention_benchmark.cpp
+/// \brief Many producer threads calling send_to() concurrently.
+///
+/// Reports the producer-side cost of send_to() and the end-to-end rate until
+/// every completion callback has run.
+///
+/// Usage: producer_contention_benchmark [--producers N] [--clients N]
+///                                      [--messages N] [--size BYTES]
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "bench_client.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    struct Options {
+        size_t producers = 8;
+        size_t clients = 16;
+        size_t messages = 200000;   ///< Per producer
+        size_t size = 32;
+    };
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            size_t value = std::strtoul(argv[i + 1], nullptr, 10);
+            if (std::strcmp(argv[i], "--producers") == 0) options.producers = value;
+            else if (std::strcmp(argv[i], "--clients") == 0) options.clients = value;
+            else if (std::strcmp(argv[i], "--messages") == 0) options.messages = value;
+            else if (std::strcmp(argv[i], "--size") == 0) options.size = value;
+        }
+        return options;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+
+    ServerConfig config("SimpleNamedPipeContention", 65536);
+    config.write_limits.max_pending_writes_per_client = options.messages * options.producers;
+    NamedPipeServer server(config);
+
+    std::mutex ids_mutex;
+    std::vector<int> client_ids;
+    server.on_connected = [&](int client_id) {
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        client_ids.push_back(client_id);
+    };
+    server.start();
+
+    // Clients only drain what the server sends
+    std::vector<std::unique_ptr<bench::BlockingClient>> clients;
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < options.clients; ++i) {
+        clients.emplace_back(new bench::BlockingClient());
+        clients.back()->open(config.pipe_name);
+        bench::BlockingClient* client = clients.back().get();
+        readers.emplace_back([client] {
+            std::string message;
+            while (client->read(message)) {}
+        });
+    }
+    for (;;) {
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        if (client_ids.size() == options.clients) break;
+    }
+
+    const size_t total = options.producers * options.messages;
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<bool> go{false};
+    std::vector<double> enqueue_ns(options.producers);
+    std::vector<std::thread> producers;
+    const std::string payload(options.size, 'q');
+
+    for (size_t p = 0; p < options.producers; ++p) {
+        producers.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            auto started = std::chrono::steady_clock::now();
+            for (size_t n = 0; n < options.messages; ++n) {
+                int client_id = client_ids[(p + n) % client_ids.size()];
+                server.send_to(client_id, payload, [&](const std::error_code& ec) {
+                    if (ec) ++failed;
+                    ++completed;
+                });
+            }
+            enqueue_ns[p] = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - started).count() / options.messages;
+        });
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& producer : producers) producer.join();
+    while (completed.load() < total) std::this_thread::yield();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    double ns_per_send = 0.0;
+    for (double ns : enqueue_ns) ns_per_send += ns;
+    ns_per_send /= options.producers;
+
+    std::cout << "producers=" << options.producers
+              << " clients=" << options.clients
+              << " messages=" << total
+              << " size=" << options.size
+              << " cores=" << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "send_to ns/op (producer side): " << ns_per_send << std::endl
+              << "end-to-end msg/s:              " << total / seconds << std::endl
+              << "failed:                        " << failed.load() << std::endl;
+
+    // Stopping the server closes every connection, which ends the readers
+    server.stop();
+    for (auto& reader : readers) reader.join();
+    return 0;
+}
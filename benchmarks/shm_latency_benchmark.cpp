@@ -0,0 +1,119 @@
+/// \file shm_latency_benchmark.cpp
+/// \brief Ping-pong latency of NamedPipeClient over the pipe and over the shared-memory rings.
+///
+/// Usage: shm_latency_benchmark [--messages N] [--size BYTES] [--spin-us N]
+///
+/// One-way latency is reported as half of the round trip. Without spinning
+/// both sides still wake each other through the pipe; sub-microsecond numbers
+/// need `--spin-us` and at least two free cores.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "SimpleNamedPipe/NamedPipeClient.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+namespace {
+
+    struct Options {
+        size_t messages = 100000;
+        size_t size = 64;
+        size_t spin_us = 50;
+    };
+
+    Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* value = argv[i + 1];
+            if (std::strcmp(argv[i], "--messages") == 0) options.messages = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--size") == 0) options.size = std::strtoul(value, nullptr, 10);
+            else if (std::strcmp(argv[i], "--spin-us") == 0) options.spin_us = std::strtoul(value, nullptr, 10);
+        }
+        return options;
+    }
+
+    struct Result {
+        double p50_ns = 0;
+        double p99_ns = 0;
+        bool is_shared_memory = false;
+    };
+
+    Result run(const Options& options, bool use_shared_memory, size_t spin_us) {
+        ServerConfig config("SimpleNamedPipeShmBench", 65536);
+        config.shared_memory.enabled = use_shared_memory;
+        config.shared_memory.spin_us = spin_us;
+        NamedPipeServer server(config);
+        server.on_message_view = [&server](int client_id, MessageView message) {
+            server.send_to(client_id, message.to_string());
+        };
+        server.start();
+
+        ClientConfig client_config(config.pipe_name, 65536);
+        client_config.shared_memory.enabled = use_shared_memory;
+        client_config.shared_memory.spin_us = spin_us;
+        NamedPipeClient client(client_config);
+        std::atomic<size_t> received{0};
+        client.on_message_view = [&received](MessageView) {
+            received.fetch_add(1, std::memory_order_release);
+        };
+        client.start();
+
+        Result result;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((!client.is_connected() || client.is_shared_memory() != use_shared_memory) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        result.is_shared_memory = client.is_shared_memory();
+
+        const std::string payload(options.size, 'x');
+        std::vector<double> samples;
+        samples.reserve(options.messages);
+        for (size_t n = 0; n < options.messages; ++n) {
+            auto started = std::chrono::steady_clock::now();
+            client.send(payload);
+            while (received.load(std::memory_order_acquire) != n + 1) {}
+            samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / 2);
+        }
+
+        client.stop();
+        server.stop();
+
+        std::sort(samples.begin(), samples.end());
+        if (!samples.empty()) {
+            result.p50_ns = samples[samples.size() / 2];
+            result.p99_ns = samples[samples.size() * 99 / 100];
+        }
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+    std::cout << "messages=" << options.messages
+              << " size=" << options.size
+              << " cores=" << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(22) << "path" << std::setw(14) << "p50 ns" << std::setw(14) << "p99 ns" << std::endl;
+
+    struct Case { const char* name; bool use_shared_memory; size_t spin_us; };
+    const Case cases[] = {
+        {"pipe", false, 0},
+        {"shared memory", true, 0},
+        {"shared memory + spin", true, options.spin_us},
+    };
+    for (const Case& c : cases) {
+        Result result = run(options, c.use_shared_memory, c.spin_us);
+        std::cout << std::setw(22) << c.name
+                  << std::setw(14) << std::fixed << std::setprecision(0) << result.p50_ns
+                  << std::setw(14) << result.p99_ns;
+        if (result.is_shared_memory != c.use_shared_memory) std::cout << "  (fell back to the pipe)";
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "SimpleNamedPipe/MessageCodec.hpp"
+#include <iostream>
+#include <string>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+// Same fields in the same order as the MQL5 structs:
+//
+//     struct Tick  { int symbol_id; double bid; double ask; long time_msc; char symbol[16]; };
+//     struct Order { int symbol_id; int side; double volume; double price; };
+struct Tick {
+    int32_t symbol_id;
+    double  bid;
+    double  ask;
+    int64_t time_msc;
+    char    symbol[16];
+};
+
+enum class Side : int32_t {
+    Buy  = 0,
+    Sell = 1
+};
+
+struct Order {
+    int32_t symbol_id;
+    Side    side;
+    double  volume;
+    double  price;
+};
+
+namespace SimpleNamedPipe {
+
+    template <>
+    struct MessageSchema<Tick> : Schema<1, 1,
+        SNP_FIELD(Tick, symbol_id), SNP_FIELD(Tick, bid), SNP_FIELD(Tick, ask),
+        SNP_FIELD(Tick, time_msc), SNP_FIELD(Tick, symbol)> {};
+
+    template <>
+    struct MessageSchema<Order> : Schema<2, 1,
+        SNP_FIELD(Order, symbol_id), SNP_FIELD(Order, side),
+        SNP_FIELD(Order, volume), SNP_FIELD(Order, price)> {};
+
+} // namespace SimpleNamedPipe
+
+int main() {
+    ServerConfig config;
+    config.pipe_name = "ExamplePipe";
+
+    NamedPipeServer server(config);
+
+    server.on_connected = [](int client_id) {
+        std::cout << "client(" << client_id << ") connected." << std::endl;
+    };
+
+    // Ticks are decoded straight from the receive buffer; every tick with
+    // a spread below 2 points is answered with an order
+    server.on_message_view = [&server](int client_id, MessageView message) {
+        Tick tick = Tick();
+        if (!decode_message(message, tick)) {
+            std::cout << "client(" << client_id << ") sent an unknown message" << std::endl;
+            return;
+        }
+        std::cout << "client(" << client_id << ") tick "
+                  << std::string(tick.symbol, strnlen(tick.symbol, sizeof(tick.symbol)))
+                  << " " << tick.bid << "/" << tick.ask << std::endl;
+        if (tick.ask - tick.bid >= 0.0002) return;
+
+        Order order;
+        order.symbol_id = tick.symbol_id;
+        order.side = Side::Buy;
+        order.volume = 0.1;
+        order.price = tick.ask;
+        server.send_to(client_id, encode_message(order));
+    };
+
+    server.on_error = [](const std::error_code& error) {
+        std::cerr << "Error: " << error.message() << std::endl;
+    };
+
+    std::cout << "Press Enter to stop the server..." << std::endl;
+    server.start();
+
+    std::cin.get();
+
+    server.stop();
+    return 0;
+}
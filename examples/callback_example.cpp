@@ -1,5 +1,6 @@
 #include "SimpleNamedPipe/NamedPipeServer.hpp"
 #include <iostream>
+#include <unordered_map>
 #include <chrono>
 
 using namespace SimpleNamedPipe;
@@ -14,7 +15,7 @@ int main() {
     NamedPipeServer server(config);
 
     // Counter for messages from each client
-    std::array<int, 256> message_counters{};
+    std::unordered_map<int, int> message_counters;
 
     // Callbacks
     server.on_connected = [](int client_id) {
@@ -30,10 +31,10 @@ int main() {
 
         // Echo the message back
         server.send_to(client_id, "Echo: " + message);
-        message_counters[static_cast<size_t>(client_id)]++;
+        message_counters[client_id]++;
 
         // Disconnect after 10 messages
-        if (message_counters[static_cast<size_t>(client_id)] >= 10) {
+        if (message_counters[client_id] >= 10) {
             server.close(client_id);
         }
     };
@@ -0,0 +1,52 @@
+#include "SimpleNamedPipe/NamedPipeClient.hpp"
+#include <iostream>
+#include <string>
+
+using namespace SimpleNamedPipe;
+
+int main() {
+    // Client configuration; run callback_example first, it serves "ExamplePipe"
+    ClientConfig config;
+    config.pipe_name = "ExamplePipe";
+    config.buffer_size = 1024;
+    config.reconnect.initial_delay_ms = 200;
+    config.reconnect.max_delay_ms = 3000;
+
+    NamedPipeClient client(config);
+
+    // Callbacks
+    client.on_connected = []() {
+        std::cout << "connected." << std::endl;
+    };
+
+    client.on_disconnected = [](const std::error_code& ec) {
+        std::cout << "disconnected: " << ec.message() << std::endl;
+    };
+
+    client.on_reconnecting = [](size_t attempt, const std::error_code& ec) {
+        std::cout << "reconnecting, attempt " << attempt << ": " << ec.message() << std::endl;
+    };
+
+    client.on_message = [](const std::string& message) {
+        std::cout << "received: " << message << std::endl;
+    };
+
+    client.on_error = [](const std::error_code& error) {
+        std::cerr << "Error: " << error.message() << std::endl;
+    };
+
+    client.start();
+
+    // Every line typed is sent to the server; lines typed while the server
+    // is away wait in the queue until the client reconnects
+    std::cout << "Type a message and press Enter, an empty line stops the client..." << std::endl;
+    std::string line;
+    while (std::getline(std::cin, line) && !line.empty()) {
+        client.send(std::move(line), [](const std::error_code& ec) {
+            if (ec) std::cerr << "send failed: " << ec.message() << std::endl;
+        });
+    }
+
+    client.stop();
+    return 0;
+}
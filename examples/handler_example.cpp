@@ -0,0 +1,46 @@
+#include "SimpleNamedPipe/BasicNamedPipeServer.hpp"
+#include <iostream>
+
+using namespace SimpleNamedPipe;
+
+// Handler resolved at compile time: only the events it declares are called,
+// there is no std::function and no Connection object per client
+class EchoHandler {
+public:
+    BasicNamedPipeServer<EchoHandler>* server = nullptr;
+
+    void on_connected(int client_id) {
+        std::cout << "client(" << client_id << ") connected." << std::endl;
+    }
+
+    void on_disconnected(int client_id, const std::error_code& ec) {
+        std::cout << "client(" << client_id << ") disconnected: " << ec.message() << std::endl;
+    }
+
+    // The view points into the receive buffer; without on_message the
+    // server never copies the message into a string
+    void on_message_view(int client_id, MessageView message) {
+        server->send_to(client_id, message.to_buffer());
+    }
+
+    void on_error(const std::error_code& error) {
+        std::cerr << "Error: " << error.message() << std::endl;
+    }
+};
+
+int main() {
+    ServerConfig config;
+    config.pipe_name = "ExamplePipe";
+    config.buffer_size = 1024;
+
+    BasicNamedPipeServer<EchoHandler> server(config);
+    server.handler().server = &server;
+
+    std::cout << "Press Enter to stop the server..." << std::endl;
+    server.start();
+
+    std::cin.get();
+
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "SimpleNamedPipe/MessageCodec.hpp"
+#include <iostream>
+#include <string>
+#include <cstring>
+
+using namespace SimpleNamedPipe;
+
+// Checks MessageCodec.hpp against the wire layout MessageCodec.mqh uses;
+// returns a non-zero exit code if any check fails.
+
+// The Tick from the MessageCodec.mqh doc comment:
+//
+//     struct Tick { int symbol_id; double bid; double ask; long time_msc; char symbol[16]; };
+struct Tick {
+    int32_t symbol_id;
+    double  bid;
+    double  ask;
+    int64_t time_msc;
+    char    symbol[16];
+};
+
+enum class Side : int32_t {
+    Buy  = 0,
+    Sell = 1
+};
+
+struct Order {
+    int32_t symbol_id;
+    Side    side;
+    double  volume;
+    bool    is_limit;
+    Tick    tick;
+};
+
+// Two versions of one message, as an older and a newer build would declare it
+struct QuoteV1 {
+    int32_t symbol_id;
+    double  bid;
+};
+
+struct QuoteV2 {
+    int32_t symbol_id;
+    double  bid;
+    double  ask;
+};
+
+namespace SimpleNamedPipe {
+
+    template <>
+    struct MessageSchema<Tick> : Schema<1, 1,
+        SNP_FIELD(Tick, symbol_id), SNP_FIELD(Tick, bid), SNP_FIELD(Tick, ask),
+        SNP_FIELD(Tick, time_msc), SNP_FIELD(Tick, symbol)> {};
+
+    template <>
+    struct MessageSchema<Order> : Schema<2, 1,
+        SNP_FIELD(Order, symbol_id), SNP_FIELD(Order, side), SNP_FIELD(Order, volume),
+        SNP_FIELD(Order, is_limit), SNP_FIELD(Order, tick)> {};
+
+    template <>
+    struct MessageSchema<QuoteV1> : Schema<3, 1,
+        SNP_FIELD(QuoteV1, symbol_id), SNP_FIELD(QuoteV1, bid)> {};
+
+    template <>
+    struct MessageSchema<QuoteV2> : Schema<3, 2,
+        SNP_FIELD(QuoteV2, symbol_id), SNP_FIELD(QuoteV2, bid), SNP_FIELD(QuoteV2, ask)> {};
+
+} // namespace SimpleNamedPipe
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        std::cout << (condition ? "ok      " : "FAILED  ") << what << std::endl;
+        if (!condition) ++failures;
+    }
+
+    Tick make_tick() {
+        Tick tick = Tick();
+        tick.symbol_id = 0x01020304;
+        tick.bid = 1.5;
+        tick.ask = 2.25;
+        tick.time_msc = 0x0102030405060708LL;
+        std::strcpy(tick.symbol, "EURUSD");
+        return tick;
+    }
+
+    bool same_tick(const Tick& a, const Tick& b) {
+        return a.symbol_id == b.symbol_id && a.bid == b.bid && a.ask == b.ask &&
+               a.time_msc == b.time_msc && std::memcmp(a.symbol, b.symbol, sizeof(a.symbol)) == 0;
+    }
+
+    /// Rewrites the body size in the header after the body was cut.
+    void set_body_size(std::string& message, uint32_t body_size) {
+        for (size_t i = 0; i < 4; ++i) {
+            message[4 + i] = static_cast<char>((body_size >> (8 * i)) & 0xFF);
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Exact bytes: StructToCharArray() of the MQL5 Tick behind an 8-byte header
+    {
+        const unsigned char expected[] = {
+            0x01, 0x00, 0x01, 0x00, 0x2C, 0x00, 0x00, 0x00,         // type 1, version 1, body 44
+            0x04, 0x03, 0x02, 0x01,                                 // symbol_id
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x3F,         // bid 1.5
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x40,         // ask 2.25
+            0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,         // time_msc
+            'E', 'U', 'R', 'U', 'S', 'D', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        };
+        const std::string message = encode_message(make_tick());
+        check(encoded_size<Tick>() == sizeof(expected), "Tick is 8 + 44 bytes on the wire");
+        check(message.size() == sizeof(expected) && std::memcmp(message.data(), expected, sizeof(expected)) == 0,
+              "Tick bytes match the MQL5 pack(1) layout");
+
+        Tick tick = Tick();
+        check(decode_message(MessageView(reinterpret_cast<const char*>(expected), sizeof(expected)), tick) &&
+              same_tick(tick, make_tick()), "Tick decodes from the MQL5 bytes");
+    }
+
+    // Round trip, including enums, bool and a nested struct
+    {
+        Order order = Order();
+        order.symbol_id = -7;
+        order.side = Side::Sell;
+        order.volume = 0.1;
+        order.is_limit = true;
+        order.tick = make_tick();
+
+        char buffer[encoded_size<Order>()];
+        check(encode_message(order, buffer, sizeof(buffer) - 1) == 0, "encode_message rejects a short buffer");
+        check(encode_message(order, buffer, sizeof(buffer)) == sizeof(buffer), "encode_message fills the buffer");
+
+        Order decoded = Order();
+        check(decode_message(MessageView(buffer, sizeof(buffer)), decoded) &&
+              decoded.symbol_id == order.symbol_id && decoded.side == order.side &&
+              decoded.volume == order.volume && decoded.is_limit && same_tick(decoded.tick, order.tick),
+              "Order round trip");
+        check(is_message<Order>(MessageView(buffer, sizeof(buffer))) && !is_message<Tick>(MessageView(buffer, sizeof(buffer))),
+              "is_message tells the types apart");
+        check(!decode_message(MessageView(buffer, sizeof(buffer)), decoded.tick), "a message of another type is rejected");
+    }
+
+    // Older sender, newer reader: the missing field keeps its value
+    {
+        QuoteV1 old_quote = QuoteV1();
+        old_quote.symbol_id = 5;
+        old_quote.bid = 1.25;
+
+        QuoteV2 quote = QuoteV2();
+        quote.ask = -1.0;
+        check(decode_message(encode_message(old_quote), quote) &&
+              quote.symbol_id == 5 && quote.bid == 1.25 && quote.ask == -1.0,
+              "a newer reader keeps the fields an older sender did not have");
+    }
+
+    // Newer sender, older reader: the appended field is skipped
+    {
+        QuoteV2 new_quote = QuoteV2();
+        new_quote.symbol_id = 6;
+        new_quote.bid = 1.5;
+        new_quote.ask = 1.75;
+
+        QuoteV1 quote = QuoteV1();
+        check(decode_message(encode_message(new_quote), quote) && quote.symbol_id == 6 && quote.bid == 1.5,
+              "an older reader ignores the fields a newer sender appended");
+    }
+
+    // Malformed messages
+    {
+        const std::string message = encode_message(make_tick());
+        Tick tick = Tick();
+
+        // The body ends 3 bytes into bid; the header is consistent with it
+        std::string cut = message.substr(0, MESSAGE_HEADER_SIZE + 4 + 3);
+        set_body_size(cut, 4 + 3);
+        check(!decode_message(cut, tick), "a body cut inside a field is rejected");
+
+        // The body ends right after bid, as if the sender had only two fields
+        std::string shorter = message.substr(0, MESSAGE_HEADER_SIZE + 4 + 8);
+        set_body_size(shorter, 4 + 8);
+        check(decode_message(shorter, tick), "a body cut between fields is accepted");
+
+        check(!decode_message(message.substr(0, message.size() - 1), tick),
+              "a message shorter than its header says is rejected");
+        check(!decode_message(message.substr(0, MESSAGE_HEADER_SIZE - 1), tick), "a cut header is rejected");
+    }
+
+    if (failures) {
+        std::cout << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
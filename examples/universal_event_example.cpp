@@ -1,5 +1,6 @@
 #include "SimpleNamedPipe/NamedPipeServer.hpp"
 #include <iostream>
+#include <unordered_map>
 
 using namespace SimpleNamedPipe;
 
@@ -10,7 +11,7 @@ int main() {
     config.timeout = 5000;
 
     NamedPipeServer server(config);
-    std::array<int, 256> message_counters{};
+    std::unordered_map<int, int> message_counters;
 
     server.on_event = [&server, &message_counters](const ServerEvent& ev) {
         switch (ev.type) {
@@ -30,12 +31,21 @@ int main() {
             std::cout << "client(" << ev.client_id << ") received: " << ev.message << std::endl;
             if (ev.connection) {
                 ev.connection->send("Echo: " + ev.message);
-                message_counters[static_cast<size_t>(ev.client_id)]++;
-                if (message_counters[static_cast<size_t>(ev.client_id)] >= 10) {
+                message_counters[ev.client_id]++;
+                if (message_counters[ev.client_id] >= 10) {
                     ev.connection->close();
                 }
             }
             break;
+        case ServerEventType::SessionResumed:
+            std::cout << "client(" << ev.client_id << ") resumed the session of client("
+                      << ev.previous_client_id << ")." << std::endl;
+            message_counters[ev.client_id] = message_counters[ev.previous_client_id];
+            message_counters.erase(ev.previous_client_id);
+            break;
+        case ServerEventType::ClientWritable:
+        case ServerEventType::MetricsReported:
+            break;
         case ServerEventType::ErrorOccurred:
             std::cerr << "Error: " << ev.error.message() << std::endl;
             break;
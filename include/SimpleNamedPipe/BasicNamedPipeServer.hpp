@@ -0,0 +1,19 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_BASIC_SERVER_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_BASIC_SERVER_HPP_INCLUDED
+
+/// \file BasicNamedPipeServer.hpp
+/// \brief BasicNamedPipeServer with its implementation, for servers with a custom handler.
+///
+/// NamedPipeServer.hpp is enough for NamedPipeServer itself. Any other
+/// BasicNamedPipeServer<Handler> is instantiated in the including translation
+/// unit, so it needs the implementation also when SIMPLE_NAMED_PIPE_STATIC_LIB
+/// is defined.
+
+#include "NamedPipeServer.hpp"
+
+#ifdef SIMPLE_NAMED_PIPE_STATIC_LIB
+#include "NamedPipeServer/NamedPipeServer.ipp"
+#endif
+
+#endif // _SIMPLE_NAMED_PIPE_BASIC_SERVER_HPP_INCLUDED
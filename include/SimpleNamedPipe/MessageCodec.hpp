@@ -0,0 +1,357 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_MESSAGE_CODEC_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_MESSAGE_CODEC_HPP_INCLUDED
+
+/// \file MessageCodec.hpp
+/// \brief Fixed-layout binary messages described at compile time.
+///
+/// A message struct gets a schema by specializing MessageSchema:
+///
+///     struct Tick {
+///         int32_t symbol_id;
+///         double  bid;
+///         double  ask;
+///         int64_t time_msc;
+///         char    symbol[16];
+///     };
+///
+///     namespace SimpleNamedPipe {
+///         template <> struct MessageSchema<Tick> : Schema<1, 1,   // type id, version
+///             SNP_FIELD(Tick, symbol_id), SNP_FIELD(Tick, bid), SNP_FIELD(Tick, ask),
+///             SNP_FIELD(Tick, time_msc), SNP_FIELD(Tick, symbol)> {};
+///     }
+///
+/// A message is an 8-byte header (type id, version and body size as
+/// little-endian uint16, uint16 and uint32) followed by the fields in schema
+/// order, little-endian and without padding. That is the layout of an MQL5
+/// struct with the same fields, which MQL5 packs to 1 byte by default, so
+/// MessageCodec.mqh reads and writes it with StructToCharArray() and
+/// CharArrayToStruct().
+///
+/// Fields are integers, bool, float, double, enums, fixed-size arrays of
+/// them (e.g. `char symbol[16]` for a fixed string) and structs that have a
+/// schema themselves.
+///
+/// Versioning: fields are only ever appended. decode_message() ignores
+/// fields a newer sender appended and leaves fields an older sender did not
+/// have at the values `value` held, so it may be filled with defaults first.
+///
+/// Encoding writes straight into the caller's buffer and decoding reads
+/// straight from the received bytes; neither allocates.
+
+#include "NamedPipeServer/MessageView.hpp"
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace SimpleNamedPipe {
+
+    /// \brief Size of the header in front of every encoded message.
+    constexpr size_t MESSAGE_HEADER_SIZE = 8;
+
+    /// \struct MessageHeader
+    /// \brief Header of an encoded message.
+    struct MessageHeader {
+        uint16_t type_id = 0;   ///< MessageSchema::type_id of the sender
+        uint16_t version = 0;   ///< MessageSchema::version of the sender
+        uint32_t body_size = 0; ///< Bytes after the header
+    };
+
+    /// \brief Schema of a message struct; specialize it by deriving from Schema.
+    template <class T>
+    struct MessageSchema {};
+
+namespace detail {
+
+    template <class V, class = void>
+    struct ValueCodec;
+
+    template <class T, class = void>
+    struct has_schema : std::false_type {};
+    template <class T>
+    struct has_schema<T, typename std::conditional<true, void, decltype(MessageSchema<T>::body_size)>::type> : std::true_type {};
+
+    template <class V>
+    struct is_integer : std::integral_constant<bool,
+        std::is_integral<V>::value && !std::is_same<V, bool>::value> {};
+
+    /// \brief Integers: the unsigned bit pattern byte by byte, lowest first.
+    template <class V>
+    struct ValueCodec<V, typename std::enable_if<is_integer<V>::value>::type> {
+        using Bits = typename std::make_unsigned<V>::type;
+        static constexpr size_t size = sizeof(V);
+
+        static char* write(const V& value, char* out) {
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (size_t i = 0; i < sizeof(bits); ++i) {
+                out[i] = static_cast<char>(static_cast<unsigned char>(bits >> (8 * i)));
+            }
+            return out + size;
+        }
+
+        static const char* read(V& value, const char* in) {
+            Bits bits = 0;
+            for (size_t i = 0; i < sizeof(bits); ++i) {
+                bits = static_cast<Bits>(bits | (static_cast<Bits>(static_cast<unsigned char>(in[i])) << (8 * i)));
+            }
+            std::memcpy(&value, &bits, sizeof(bits));
+            return in + size;
+        }
+    };
+
+    /// \brief bool: one byte, 0 or 1.
+    template <>
+    struct ValueCodec<bool, void> {
+        static constexpr size_t size = 1;
+
+        static char* write(const bool& value, char* out) {
+            *out = value ? 1 : 0;
+            return out + size;
+        }
+
+        static const char* read(bool& value, const char* in) {
+            value = *in != 0;
+            return in + size;
+        }
+    };
+
+    /// \brief float and double: their IEEE 754 bits as an integer.
+    template <class V>
+    struct ValueCodec<V, typename std::enable_if<std::is_floating_point<V>::value>::type> {
+        static_assert(sizeof(V) == 4 || sizeof(V) == 8, "Only 32 and 64-bit floating point fields are supported");
+        using Bits = typename std::conditional<sizeof(V) == 4, uint32_t, uint64_t>::type;
+        static constexpr size_t size = sizeof(V);
+
+        static char* write(const V& value, char* out) {
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return ValueCodec<Bits>::write(bits, out);
+        }
+
+        static const char* read(V& value, const char* in) {
+            Bits bits;
+            in = ValueCodec<Bits>::read(bits, in);
+            std::memcpy(&value, &bits, sizeof(bits));
+            return in;
+        }
+    };
+
+    /// \brief Enums: their underlying integer.
+    template <class V>
+    struct ValueCodec<V, typename std::enable_if<std::is_enum<V>::value>::type> {
+        using Underlying = typename std::underlying_type<V>::type;
+        static constexpr size_t size = sizeof(Underlying);
+
+        static char* write(const V& value, char* out) {
+            return ValueCodec<Underlying>::write(static_cast<Underlying>(value), out);
+        }
+
+        static const char* read(V& value, const char* in) {
+            Underlying raw;
+            in = ValueCodec<Underlying>::read(raw, in);
+            value = static_cast<V>(raw);
+            return in;
+        }
+    };
+
+    /// \brief Fixed-size arrays: the elements one after another.
+    template <class V, size_t N>
+    struct ValueCodec<V[N], void> {
+        static constexpr size_t size = ValueCodec<V>::size * N;
+
+        static char* write(const V (&value)[N], char* out) {
+            for (size_t i = 0; i < N; ++i) out = ValueCodec<V>::write(value[i], out);
+            return out;
+        }
+
+        static const char* read(V (&value)[N], const char* in) {
+            for (size_t i = 0; i < N; ++i) in = ValueCodec<V>::read(value[i], in);
+            return in;
+        }
+    };
+
+    /// \brief Nested structs: their own schema's body, without a header.
+    template <class V>
+    struct ValueCodec<V, typename std::enable_if<has_schema<V>::value>::type> {
+        static constexpr size_t size = MessageSchema<V>::body_size;
+
+        static char* write(const V& value, char* out) {
+            return MessageSchema<V>::write_body(value, out);
+        }
+
+        static const char* read(V& value, const char* in) {
+            return MessageSchema<V>::read_body(value, in);
+        }
+    };
+
+    template <class... Fields>
+    struct FieldsSize;
+    template <>
+    struct FieldsSize<> : std::integral_constant<size_t, 0> {};
+    template <class First, class... Rest>
+    struct FieldsSize<First, Rest...> : std::integral_constant<size_t, First::size + FieldsSize<Rest...>::value> {};
+
+    template <class T, class... Fields>
+    struct FieldsOf;
+    template <class T>
+    struct FieldsOf<T> : std::true_type {};
+    template <class T, class First, class... Rest>
+    struct FieldsOf<T, First, Rest...> : std::integral_constant<bool,
+        std::is_same<T, typename First::Owner>::value && FieldsOf<T, Rest...>::value> {};
+
+    using Expander = int[];
+
+} // namespace detail
+
+    /// \struct Field
+    /// \brief One member of a message struct; use SNP_FIELD to name it.
+    template <class T, class V, V T::*Member>
+    struct Field {
+        using Owner = T;
+        static constexpr size_t size = detail::ValueCodec<V>::size;
+
+        static char* write(const T& value, char* out) {
+            return detail::ValueCodec<V>::write(value.*Member, out);
+        }
+
+        /// \brief Reads the field if the body still holds it.
+        /// \param is_valid Cleared if the body ends inside the field.
+        static const char* read(T& value, const char* in, const char* end, bool& is_valid) {
+            const size_t left = static_cast<size_t>(end - in);
+            if (left >= size) return detail::ValueCodec<V>::read(value.*Member, in);
+            // An older sender did not have the field; a cut field is an error
+            if (left > 0) is_valid = false;
+            return end;
+        }
+    };
+
+    /// \struct Schema
+    /// \brief Type id, version and fields of a message struct.
+    /// \tparam TypeId Identifies the message on the wire; unique per protocol.
+    /// \tparam Version Raised whenever fields are appended.
+    /// \tparam Fields SNP_FIELD entries in wire order.
+    template <uint16_t TypeId, uint16_t Version, class... Fields>
+    struct Schema {
+        static constexpr uint16_t type_id = TypeId;
+        static constexpr uint16_t version = Version;
+        static constexpr size_t   body_size = detail::FieldsSize<Fields...>::value;
+
+        template <class T>
+        static char* write_body(const T& value, char* out) {
+            static_assert(detail::FieldsOf<T, Fields...>::value, "Every SNP_FIELD of a schema must belong to its struct");
+            (void)detail::Expander{0, (out = Fields::write(value, out), 0)...};
+            return out;
+        }
+
+        template <class T>
+        static const char* read_body(T& value, const char* in) {
+            bool is_valid = true;
+            const char* end = in + body_size;
+            (void)detail::Expander{0, (in = Fields::read(value, in, end, is_valid), 0)...};
+            return in;
+        }
+
+        /// \brief Reads a body of any size; see the versioning rules in MessageCodec.hpp.
+        template <class T>
+        static bool read_body(T& value, const char* in, size_t size) {
+            bool is_valid = true;
+            const char* end = in + (size < body_size ? size : size_t(body_size));
+            (void)detail::Expander{0, (in = Fields::read(value, in, end, is_valid), 0)...};
+            return is_valid;
+        }
+    };
+
+    /// \brief Names a member of a message struct in a Schema.
+#define SNP_FIELD(Type, member) \
+    ::SimpleNamedPipe::Field<Type, decltype(Type::member), &Type::member>
+
+    /// \brief Size of an encoded message of type T, header included.
+    template <class T>
+    constexpr size_t encoded_size() {
+        return MESSAGE_HEADER_SIZE + MessageSchema<T>::body_size;
+    }
+
+    /// \brief Encodes a message into a caller-provided buffer.
+    /// \param value Message to encode.
+    /// \param data Destination, e.g. a send buffer kept between messages.
+    /// \param capacity Bytes available at `data`.
+    /// \return Bytes written, 0 if `capacity` is below encoded_size<T>().
+    template <class T>
+    size_t encode_message(const T& value, char* data, size_t capacity) {
+        static_assert(detail::has_schema<T>::value, "T needs a MessageSchema<T> specialization");
+        using Layout = MessageSchema<T>;
+        if (capacity < encoded_size<T>()) return 0;
+        char* out = detail::ValueCodec<uint16_t>::write(uint16_t(Layout::type_id), data);
+        out = detail::ValueCodec<uint16_t>::write(uint16_t(Layout::version), out);
+        out = detail::ValueCodec<uint32_t>::write(static_cast<uint32_t>(Layout::body_size), out);
+        Layout::write_body(value, out);
+        return encoded_size<T>();
+    }
+
+    /// \brief Encodes a message into a string, reusing its capacity.
+    ///
+    /// Pass the string to send_to() by move to send it without a copy.
+    template <class T>
+    void encode_message(const T& value, std::string& out) {
+        out.resize(encoded_size<T>());
+        encode_message(value, &out[0], out.size());
+    }
+
+    /// \brief Encodes a message into a new string.
+    template <class T>
+    std::string encode_message(const T& value) {
+        std::string out;
+        encode_message(value, out);
+        return out;
+    }
+
+    /// \brief Reads the header of an encoded message.
+    /// \return false if the message is shorter than its header says.
+    inline bool read_message_header(MessageView message, MessageHeader& header) {
+        if (message.size() < MESSAGE_HEADER_SIZE) return false;
+        const char* in = detail::ValueCodec<uint16_t>::read(header.type_id, message.data());
+        in = detail::ValueCodec<uint16_t>::read(header.version, in);
+        detail::ValueCodec<uint32_t>::read(header.body_size, in);
+        return message.size() - MESSAGE_HEADER_SIZE == header.body_size;
+    }
+
+    inline bool read_message_header(const std::string& message, MessageHeader& header) {
+        return read_message_header(MessageView(message.data(), message.size()), header);
+    }
+
+    /// \brief Checks whether a message is an encoded T.
+    template <class T>
+    bool is_message(MessageView message) {
+        MessageHeader header;
+        return read_message_header(message, header) && header.type_id == MessageSchema<T>::type_id;
+    }
+
+    template <class T>
+    bool is_message(const std::string& message) {
+        return is_message<T>(MessageView(message.data(), message.size()));
+    }
+
+    /// \brief Decodes a message straight from the received bytes.
+    /// \param message E.g. the view passed to on_message_view.
+    /// \param value Receives the fields; fields the sender did not have keep their values.
+    /// \return false if the message is not a T or is malformed.
+    template <class T>
+    bool decode_message(MessageView message, T& value) {
+        static_assert(detail::has_schema<T>::value, "T needs a MessageSchema<T> specialization");
+        MessageHeader header;
+        if (!read_message_header(message, header) || header.type_id != MessageSchema<T>::type_id) return false;
+        return MessageSchema<T>::read_body(value, message.data() + MESSAGE_HEADER_SIZE, header.body_size);
+    }
+
+    template <class T>
+    bool decode_message(const std::string& message, T& value) {
+        return decode_message(MessageView(message.data(), message.size()), value);
+    }
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_MESSAGE_CODEC_HPP_INCLUDED
@@ -0,0 +1,258 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_CLIENT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_CLIENT_HPP_INCLUDED
+
+/// \file NamedPipeClient.hpp
+/// \brief Asynchronous client for NamedPipeServer
+
+#include "NamedPipeClient/ClientConfig.hpp"
+#include "NamedPipeClient/ClientEvent.hpp"
+#include "NamedPipeClient/ClientTransport.hpp"
+#include "NamedPipeServer/ServerConfig.hpp"
+#include "NamedPipeServer/errors.hpp"
+#include "NamedPipeServer/Buffer.hpp"
+#include "NamedPipeServer/MessageView.hpp"
+#include "NamedPipeServer/SharedRing.hpp"
+#include "NamedPipeServer/Session.hpp"
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <random>
+
+namespace SimpleNamedPipe {
+
+    /// \class NamedPipeClient
+    /// \brief Asynchronous named pipe client, the counterpart of NamedPipeServer.
+    ///
+    /// One I/O thread owns the connection: it keeps a read outstanding,
+    /// issues queued messages back to back without waiting for each write to
+    /// finish (up to ClientWriteLimits::max_inflight_writes) and reconnects
+    /// with exponential backoff when the server goes away (see ReconnectPolicy).
+    /// All callbacks run on that thread and never overlap.
+    ///
+    /// send() may be called from any thread, also before the connection is
+    /// up: with ClientWriteLimits::queue_while_disconnected the messages wait
+    /// for the next connection. Messages already handed to the OS when the
+    /// connection drops complete with the disconnect error, because it is
+    /// unknown whether the server got them.
+    ///
+    /// With ClientSharedMemoryConfig::enabled the client offers the server
+    /// shared-memory rings on every connect; messages are held until the
+    /// server answers and then go through the rings, see is_shared_memory().
+    ///
+    /// With ClientSessionConfig::enabled the client opens a session on the
+    /// first connect and resumes it on every reconnect, so messages the
+    /// server sent meanwhile arrive once and in order (see SessionConfig).
+    class NamedPipeClient final {
+    public:
+        using DoneCallback = std::function<void(const std::error_code&)>;
+
+        /// \brief Constructor.
+        NamedPipeClient();
+
+        /// \brief Constructor with config.
+        explicit NamedPipeClient(const ClientConfig& config);
+
+        /// \brief Destructor.
+        ~NamedPipeClient();
+
+        NamedPipeClient(const NamedPipeClient&) = delete;
+        NamedPipeClient& operator=(const NamedPipeClient&) = delete;
+
+        // Callbacks
+        std::function<void(const ClientEvent&)>             on_event;
+        std::function<void()>                               on_connected;
+        std::function<void(const std::error_code&)>         on_disconnected;
+        std::function<void(size_t, const std::error_code&)> on_reconnecting; ///< Next attempt number and the last error
+        std::function<void(const std::string&)>             on_message;
+        std::function<void(MessageView)>                    on_message_view; ///< Allocation-free, see MessageView
+        std::function<void(const ClientConfig&)>            on_start;
+        std::function<void(const ClientConfig&)>            on_stop;
+        std::function<void(const std::error_code&)>         on_error;
+
+        // API
+
+        /// \brief Applies a new client configuration. Takes effect on the next start().
+        /// \param config Configuration to use.
+        void set_config(const ClientConfig& config);
+
+        /// \brief Retrieves the current client configuration.
+        /// \return Copy of the configuration object.
+        const ClientConfig get_config() const;
+
+        /// \brief Starts the client; it connects on its I/O thread.
+        /// \param run_async Whether to run the client in a background thread.
+        /// \throws std::system_error if the transport cannot be created.
+        void start(bool run_async = true);
+
+        /// \brief Stops the client and waits for the thread to finish.
+        void stop();
+
+        /// \brief Checks whether the client is running (connected or reconnecting).
+        bool is_running() const;
+
+        /// \brief Checks whether the client is connected to the server.
+        bool is_connected() const;
+
+        /// \brief Sends a message to the server.
+        /// \param message Message to send.
+        /// \param on_done Optional callback invoked when send completes.
+        void send(const std::string& message, DoneCallback on_done = nullptr);
+
+        /// \brief Sends a message without copying it.
+        /// \param message Message moved into the send queue; written straight from its storage.
+        /// \param on_done Optional callback invoked when send completes.
+        void send(std::string&& message, DoneCallback on_done = nullptr);
+
+        /// \brief Sends a shared payload without copying it.
+        /// \param message Payload kept alive until the write completes.
+        /// \param on_done Optional callback invoked when send completes.
+        void send(BufferPtr message, DoneCallback on_done = nullptr);
+
+        /// \brief Returns what is queued and not yet written.
+        QueueDepth get_queue_depth() const;
+
+        /// \brief Checks whether messages go through shared memory on this connection.
+        bool is_shared_memory() const;
+
+    private:
+        // --- Internal types ---
+        using Transport = detail::ClientTransport;
+        using IoEvent   = detail::IoEvent;
+
+        enum CommandType : uintptr_t {
+            CMD_TYPE_SEND = 0x1,
+            CMD_TYPE_STOP = 0x2,
+        };
+
+        static constexpr size_t MAX_IO_EVENTS = 64;
+        static constexpr size_t SPIN_ROUNDS = 256;  ///< Ring polls between two non-blocking waits
+
+        enum class SessionState {
+            Off,        ///< Messages arrive without sequence numbers
+            Requested,  ///< Hello sent, messages before the welcome have no sequence number
+            Active      ///< Every message starts with its sequence number
+        };
+
+        enum class SharedMemoryState {
+            Off,        ///< Messages go through the pipe
+            Requested,  ///< Waiting for the server's reply, messages are held
+            Active      ///< Messages go through the rings
+        };
+
+        /// \brief Queued message; written straight from `message` or `shared`.
+        struct WriteCommand {
+            std::string message;    ///< Owned payload, unused when `shared` is set
+            BufferPtr shared;       ///< Shared payload
+            DoneCallback on_done;
+
+            const char* data() const { return shared ? shared->data() : message.data(); }
+            size_t size() const { return shared ? shared->size() : message.size(); }
+        };
+
+        // --- Config ---
+        ClientConfig       m_config;
+        mutable std::mutex m_config_mutex;
+        ClientConfig       m_run_config;            ///< Copy used by the running I/O thread
+
+        // --- Transport ---
+        Transport          m_transport;
+        std::atomic<bool>  m_is_connected{false};
+        std::vector<char>  m_read_buffer;
+        std::string        m_message_buffer;        ///< Multi-chunk messages
+
+        // --- Send queue ---
+        mutable std::mutex       m_write_mutex;
+        std::deque<WriteCommand> m_pending_writes;  ///< Guarded by m_write_mutex
+        bool                     m_is_send_posted = false; ///< Guarded by m_write_mutex
+        bool                     m_is_accepting = false;   ///< send() queues messages, guarded by m_write_mutex
+        ClientWriteLimits        m_write_limits;    ///< Guarded by m_write_mutex
+        std::atomic<size_t>      m_queued_count{0}; ///< Messages queued and not yet completed
+        std::atomic<size_t>      m_queued_bytes{0}; ///< Their payload bytes
+        std::deque<WriteCommand> m_active_writes;   ///< I/O thread only; the first m_inflight_writes are with the OS
+        size_t                   m_inflight_writes = 0;
+
+        // --- Shared memory ---
+        SharedMemoryState  m_shm_state = SharedMemoryState::Off;
+        std::unique_ptr<detail::SharedChannel> m_shm;
+        std::string        m_shm_name;              ///< Unlinked once the server has answered
+        std::string        m_shm_request;           ///< Kept until its write completes
+        size_t             m_control_writes = 0;    ///< Request or wakeups in flight; no message write is issued before them
+        std::atomic<bool>  m_is_shm_active{false};
+        bool               m_is_polling = false;    ///< The loop polls ring and queue, send() posts nothing; written under m_write_mutex
+        std::chrono::steady_clock::time_point m_spin_deadline;
+
+        // --- Session ---
+        SessionState       m_session_state = SessionState::Off;
+        std::string        m_session_token;         ///< Kept across reconnects, empty until the server opened a session
+        uint64_t           m_last_sequence = 0;     ///< Newest message delivered in the session
+        std::string        m_session_hello;         ///< Kept until its write completes
+
+        // --- Reconnect ---
+        size_t             m_failed_attempts = 0;
+        size_t             m_reconnect_delay_ms = 0;
+        std::chrono::steady_clock::time_point m_next_attempt;
+        bool               m_is_given_up = false;
+        std::minstd_rand   m_random;
+
+        // --- Threading ---
+        std::atomic<bool>  m_is_running{false};
+        std::atomic<bool>  m_is_stop_client{false};
+        std::thread        m_client_thread;
+        mutable std::mutex m_mutex;
+
+        // --- Internal logic ---
+        void enqueue_write(WriteCommand&& cmd);
+        static void complete_write(WriteCommand& cmd, const std::error_code& ec);
+        void release_write(const WriteCommand& cmd);
+        void main_loop();
+        void run_client_loop();
+        bool handle_io_event(const IoEvent& event);
+        void try_connect();
+        void schedule_reconnect(const std::error_code& ec);
+        int next_wait_timeout() const;
+        void start_read();
+        void handle_read_completion(size_t bytes_transferred, bool more_data, const std::error_code& ec);
+        void handle_disconnect(const std::error_code& ec);
+        void take_pending_writes();
+        void post_next_writes();
+        void handle_write_completion(size_t bytes_transferred, const std::error_code& ec);
+        void fail_writes(std::deque<WriteCommand>& writes, size_t count, const std::error_code& reason);
+        void request_session();
+        void complete_session_handshake(const std::string& token, detail::SessionStatus status);
+        void deliver_message(MessageView message);
+        void request_shared_memory();
+        void complete_shm_handshake(bool is_accepted);
+        void handle_shm_wakeup();
+        bool drain_shared_memory(size_t& delivered);
+        void post_shm_writes();
+        void send_shm_wakeup();
+        void poll_shared_memory();
+        void set_polling(bool is_polling);
+        void reset_shared_memory();
+
+        void notify_connected();
+        void notify_disconnected(const std::error_code& ec);
+        void notify_reconnecting(size_t attempt, const std::error_code& ec, size_t delay_ms);
+        void notify_message(MessageView message);
+        void notify_start(const ClientConfig& config);
+        void notify_stop(const ClientConfig& config);
+        void notify_error(const std::error_code& ec);
+    };
+
+}; // namespace SimpleNamedPipe
+
+/// \note Implementation is included only in header-only mode.
+///       When building as a static library, do NOT include the .ipp here.
+#ifndef SIMPLE_NAMED_PIPE_STATIC_LIB
+#include "NamedPipeClient/NamedPipeClient.ipp"
+#endif
+
+#endif // _SIMPLE_NAMED_PIPE_CLIENT_HPP_INCLUDED
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_CLIENT_CONFIG_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_CLIENT_CONFIG_HPP_INCLUDED
+
+/// \file ClientConfig.hpp
+/// \brief Configuration for the named pipe client.
+
+#include <string>
+
+namespace SimpleNamedPipe {
+
+    /// \struct ReconnectPolicy
+    /// \brief Exponential backoff between connection attempts.
+    ///
+    /// The first attempt is made at once. After a failed attempt or a lost
+    /// connection the client waits `initial_delay_ms`, and every further
+    /// failure multiplies the delay by `multiplier` up to `max_delay_ms`.
+    /// `jitter` spreads the delay randomly by up to that fraction so that
+    /// many clients do not reconnect in lockstep.
+    struct ReconnectPolicy {
+        bool   enabled = true;          ///< Reconnect after a failed attempt or a lost connection
+        size_t initial_delay_ms = 100;  ///< Delay before the first retry
+        size_t max_delay_ms = 5000;     ///< Upper bound of the delay
+        double multiplier = 2.0;        ///< Delay growth per failed attempt
+        double jitter = 0.2;            ///< Random spread of the delay, 0..1
+        size_t max_attempts = 0;        ///< Failed attempts in a row before giving up; 0 retries forever
+    };
+
+    /// \struct ClientWriteLimits
+    /// \brief Limits for the client send queue.
+    ///
+    /// Up to `max_inflight_writes` messages are handed to the OS at once, so
+    /// the client does not wait for one write to finish before issuing the next.
+    struct ClientWriteLimits {
+        size_t max_pending_writes = 1000;       ///< Max messages queued and not yet completed
+        size_t max_message_size = 64 * 1024;    ///< Max single message size (64 KB)
+        size_t max_inflight_writes = 8;         ///< Writes outstanding at the OS level
+        bool   queue_while_disconnected = true; ///< Keep queued messages for the next connection
+                                                ///< instead of failing them with NamedPipeErrc::NotConnected
+    };
+
+    /// \struct ClientSharedMemoryConfig
+    /// \brief Offer the server shared-memory rings instead of pipe writes.
+    ///
+    /// Needs SharedMemoryConfig::enabled on the server; otherwise the client
+    /// reports NamedPipeErrc::SharedMemoryFailed once and stays on the pipe.
+    /// Messages above the ring's capacity less 4 bytes fail with
+    /// NamedPipeErrc::MessageTooLarge on the rings.
+    struct ClientSharedMemoryConfig {
+        bool   enabled = false;         ///< Request the rings on every connect
+        size_t ring_size = 1024 * 1024; ///< Bytes per direction, rounded up to a power of two
+        size_t spin_us = 0;             ///< Poll the ring this long without traffic before sleeping;
+                                        ///< keeps the I/O thread busy for lower latency
+    };
+
+    /// \struct ClientSessionConfig
+    /// \brief Resume the session after a reconnect instead of starting over.
+    ///
+    /// Needs SessionConfig::enabled on the server. The client strips the
+    /// sequence numbers and skips messages it has already delivered, so a
+    /// resumed session continues where the last connection stopped. A
+    /// session that could not be resumed is reported as
+    /// NamedPipeErrc::SessionFailed; messages may be missing then.
+    struct ClientSessionConfig {
+        bool enabled = false;           ///< Open a session on connect and resume it on every reconnect
+    };
+
+    /// \class ClientConfig
+    /// \brief Named pipe client configuration.
+    class ClientConfig {
+    public:
+        std::string       pipe_name;    ///< Named pipe name, the same as ServerConfig::pipe_name
+        ClientWriteLimits write_limits; ///< Limits for the send queue
+        ReconnectPolicy   reconnect;    ///< Backoff between connection attempts
+        ClientSharedMemoryConfig shared_memory; ///< Shared-memory fast path, disabled by default
+        ClientSessionConfig session;    ///< Resumable session, disabled by default
+        size_t            buffer_size;  ///< Size of the read buffer
+
+        /// \brief Construct with optional parameters.
+        /// \param pipe_name Name of the pipe.
+        /// \param buffer_size Buffer size in bytes.
+        ClientConfig(const std::string& pipe_name = "server",
+               size_t buffer_size = 65536)
+            : pipe_name(pipe_name), buffer_size(buffer_size) {}
+    };
+}
+
+#endif // _SIMPLE_NAMED_PIPE_CLIENT_CONFIG_HPP_INCLUDED
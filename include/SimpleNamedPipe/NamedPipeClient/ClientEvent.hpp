@@ -0,0 +1,75 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_CLIENT_EVENT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_CLIENT_EVENT_HPP_INCLUDED
+
+#include <system_error>
+#include <string>
+
+namespace SimpleNamedPipe {
+
+    /// \brief Type of client-side event.
+    enum class ClientEventType {
+        ClientStarted,
+        ClientStopped,
+        Connected,
+        Disconnected,
+        Reconnecting,
+        MessageReceived,
+        ErrorOccurred
+    };
+
+    /// \brief Lightweight event descriptor for callbacks.
+    class ClientEvent {
+    public:
+        ClientEventType type;   ///< Event type
+        std::string message;    ///< Message buffer (for Message events)
+        std::error_code error;  ///< Error info (for Error, Disconnected and Reconnecting events)
+        size_t attempt = 0;     ///< Failed attempts in a row (for Reconnecting events)
+        size_t delay_ms = 0;    ///< Delay before the next attempt (for Reconnecting events)
+
+        // --- Constructors ---
+        ClientEvent(ClientEventType type)
+            : type(type) {}
+
+        ClientEvent(ClientEventType type, std::string&& msg)
+            : type(type), message(std::move(msg)) {}
+
+        ClientEvent(ClientEventType type, const std::error_code& ec)
+            : type(type), error(ec) {}
+
+        // --- Static factory methods ---
+        static inline ClientEvent client_started() {
+            return ClientEvent(ClientEventType::ClientStarted);
+        }
+
+        static inline ClientEvent client_stopped() {
+            return ClientEvent(ClientEventType::ClientStopped);
+        }
+
+        static inline ClientEvent connected() {
+            return ClientEvent(ClientEventType::Connected);
+        }
+
+        static inline ClientEvent disconnected(const std::error_code& ec) {
+            return ClientEvent(ClientEventType::Disconnected, ec);
+        }
+
+        static inline ClientEvent reconnecting(const std::error_code& ec, size_t attempt, size_t delay_ms) {
+            ClientEvent event(ClientEventType::Reconnecting, ec);
+            event.attempt = attempt;
+            event.delay_ms = delay_ms;
+            return event;
+        }
+
+        static inline ClientEvent message_received(std::string&& msg) {
+            return ClientEvent(ClientEventType::MessageReceived, std::move(msg));
+        }
+
+        static inline ClientEvent error_occurred(const std::error_code& ec) {
+            return ClientEvent(ClientEventType::ErrorOccurred, ec);
+        }
+    };
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_CLIENT_EVENT_HPP_INCLUDED
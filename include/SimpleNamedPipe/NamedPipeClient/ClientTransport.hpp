@@ -0,0 +1,45 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
+
+/// \file ClientTransport.hpp
+/// \brief Completion-based transport used by NamedPipeClient.
+///
+/// A client transport owns one connection and reports finished operations
+/// as IoEvent records, like the server transports (see Transport.hpp).
+/// Every backend exposes the same set of members:
+/// - `open()` / `close()` / `is_open()`;
+/// - `connect(pipe_name, ec)` — one non-blocking attempt;
+/// - `disconnect()` / `is_connected()`;
+/// - `read(data, size, ec)` — completes with `Read` or `Disconnected`;
+/// - `write(data, size, ec)` — completes with `Write`, several may be outstanding
+///   and they complete in order;
+/// - `post(key)` — thread-safe wakeup, completes with `Command`;
+/// - `wait(events, max_events, timeout_ms)` — dequeues completions.
+///
+/// The backend follows the server's choice of `SIMPLE_NAMED_PIPE_BACKEND_WIN32`
+/// or `SIMPLE_NAMED_PIPE_BACKEND_UNIX`.
+
+#include "../NamedPipeServer/IoEvent.hpp"
+
+#if !defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32) && !defined(SIMPLE_NAMED_PIPE_BACKEND_UNIX)
+#   if defined(_WIN32)
+#       define SIMPLE_NAMED_PIPE_BACKEND_WIN32
+#   else
+#       define SIMPLE_NAMED_PIPE_BACKEND_UNIX
+#   endif
+#endif
+
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+#include "Win32PipeClientTransport.hpp"
+namespace SimpleNamedPipe { namespace detail {
+    using ClientTransport = Win32PipeClientTransport;
+}}
+#else
+#include "UnixSocketClientTransport.hpp"
+namespace SimpleNamedPipe { namespace detail {
+    using ClientTransport = UnixSocketClientTransport;
+}}
+#endif
+
+#endif // _SIMPLE_NAMED_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
@@ -0,0 +1,691 @@
+#ifdef SIMPLE_NAMED_PIPE_STATIC_LIB
+#include "../NamedPipeClient.hpp"
+#endif
+
+#include <algorithm>
+#include <limits>
+
+namespace SimpleNamedPipe {
+
+    NamedPipeClient::NamedPipeClient()
+        : m_random(std::random_device{}()) {};
+
+    NamedPipeClient::NamedPipeClient(const ClientConfig& config)
+        : m_config(config), m_random(std::random_device{}()) {};
+
+    NamedPipeClient::~NamedPipeClient() {
+        stop();
+    }
+
+    void NamedPipeClient::set_config(const ClientConfig& config) {
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+        m_config = config;
+    }
+
+    const ClientConfig NamedPipeClient::get_config() const {
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+        return m_config;
+    }
+
+    void NamedPipeClient::start(bool run_async) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_client_thread.joinable()) {
+            m_is_stop_client = true;
+            {
+                std::lock_guard<std::mutex> write_lock(m_write_mutex);
+                if (m_is_accepting) m_transport.post(CMD_TYPE_STOP);
+            }
+            m_client_thread.join();
+        }
+        {
+            std::lock_guard<std::mutex> config_lock(m_config_mutex);
+            m_run_config = m_config;
+        }
+        m_transport.open();
+        m_is_stop_client = false;
+        m_is_given_up = false;
+        m_failed_attempts = 0;
+        m_reconnect_delay_ms = m_run_config.reconnect.initial_delay_ms;
+        m_next_attempt = std::chrono::steady_clock::now();
+        m_read_buffer.assign((std::max)(m_run_config.buffer_size, size_t(1)), 0);
+        // A new start opens a new session
+        m_session_state = SessionState::Off;
+        m_session_token.clear();
+        m_last_sequence = 0;
+        {
+            // Accept sends from now on, they wait for the connection
+            std::lock_guard<std::mutex> write_lock(m_write_mutex);
+            m_write_limits = m_run_config.write_limits;
+            m_is_send_posted = false;
+            m_is_accepting = true;
+            m_is_running = true;
+        }
+        if (run_async) {
+            m_client_thread = std::thread(&NamedPipeClient::main_loop, this);
+        } else {
+            // Let stop() from another thread reach the loop
+            lock.unlock();
+            main_loop();
+        }
+    }
+
+    void NamedPipeClient::stop() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stop_client = true;
+        {
+            std::lock_guard<std::mutex> write_lock(m_write_mutex);
+            if (m_is_accepting) m_transport.post(CMD_TYPE_STOP);
+        }
+        if (m_client_thread.joinable()) {
+            m_client_thread.join();
+        }
+    }
+
+    bool NamedPipeClient::is_running() const {
+        return m_is_running.load(std::memory_order_acquire);
+    }
+
+    bool NamedPipeClient::is_connected() const {
+        return m_is_connected.load(std::memory_order_acquire);
+    }
+
+    void NamedPipeClient::send(const std::string& message, DoneCallback on_done) {
+        enqueue_write({message, nullptr, std::move(on_done)});
+    }
+
+    void NamedPipeClient::send(std::string&& message, DoneCallback on_done) {
+        enqueue_write({std::move(message), nullptr, std::move(on_done)});
+    }
+
+    void NamedPipeClient::send(BufferPtr message, DoneCallback on_done) {
+        if (!message) {
+            message = std::make_shared<const Buffer>();
+        }
+        enqueue_write({std::string(), std::move(message), std::move(on_done)});
+    }
+
+    QueueDepth NamedPipeClient::get_queue_depth() const {
+        QueueDepth depth;
+        depth.messages = m_queued_count.load(std::memory_order_acquire);
+        depth.bytes = m_queued_bytes.load(std::memory_order_acquire);
+        return depth;
+    }
+
+    bool NamedPipeClient::is_shared_memory() const {
+        return m_is_shm_active.load(std::memory_order_acquire);
+    }
+
+    void NamedPipeClient::enqueue_write(WriteCommand&& cmd) {
+        std::unique_lock<std::mutex> lock(m_write_mutex);
+        std::error_code ec;
+        if (!m_is_accepting) {
+            ec = make_error_code(NamedPipeErrc::ClientStopped);
+        } else
+        if (!m_write_limits.queue_while_disconnected && !m_is_connected.load(std::memory_order_acquire)) {
+            ec = make_error_code(NamedPipeErrc::NotConnected);
+        } else
+        if (cmd.size() > m_write_limits.max_message_size) {
+            ec = make_error_code(NamedPipeErrc::MessageTooLarge);
+        } else
+        if (m_queued_count.load(std::memory_order_relaxed) >= m_write_limits.max_pending_writes) {
+            ec = make_error_code(NamedPipeErrc::QueueFull);
+        }
+        if (ec) {
+            lock.unlock();
+            complete_write(cmd, ec);
+            return;
+        }
+
+        m_queued_count.fetch_add(1, std::memory_order_relaxed);
+        m_queued_bytes.fetch_add(cmd.size(), std::memory_order_relaxed);
+        m_pending_writes.push_back(std::move(cmd));
+
+        // One packet per burst: the I/O thread clears the flag when it takes the queue.
+        // Posting under the lock keeps the wakeup from racing with the transport shutdown.
+        if (!m_is_send_posted) {
+            m_is_send_posted = true;
+            // A polling I/O thread finds the message on its own
+            if (!m_is_polling) m_transport.post(CMD_TYPE_SEND);
+        }
+    }
+
+    void NamedPipeClient::complete_write(WriteCommand& cmd, const std::error_code& ec) {
+        if (cmd.on_done) cmd.on_done(ec);
+    }
+
+    void NamedPipeClient::release_write(const WriteCommand& cmd) {
+        m_queued_bytes.fetch_sub(cmd.size(), std::memory_order_relaxed);
+        m_queued_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    void NamedPipeClient::main_loop() {
+        const ClientConfig config = m_run_config;
+        std::error_code reason = make_error_code(NamedPipeErrc::ClientStopped);
+        try {
+            run_client_loop();
+            if (m_is_given_up) {
+                reason = make_error_code(config.reconnect.enabled
+                    ? NamedPipeErrc::ReconnectFailed
+                    : NamedPipeErrc::NotConnected);
+            }
+        } catch (const std::system_error& ex) {
+            notify_error(ex.code());
+        } catch (const std::exception&) {
+            notify_error(make_error_code(NamedPipeErrc::UnhandledException));
+        } catch (...) {
+            notify_error(make_error_code(NamedPipeErrc::UnknownSystemError));
+        }
+
+        if (m_is_connected.load(std::memory_order_acquire)) {
+            m_transport.disconnect();
+            m_is_connected = false;
+            try {
+                notify_disconnected(reason);
+            } catch (...) {}
+        }
+        reset_shared_memory();
+
+        std::deque<WriteCommand> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_is_accepting = false;
+            m_is_send_posted = false;
+            pending.swap(m_pending_writes);
+        }
+        fail_writes(m_active_writes, m_active_writes.size(), reason);
+        fail_writes(pending, pending.size(), reason);
+        m_inflight_writes = 0;
+        m_message_buffer.clear();
+        m_transport.close();
+        try {
+            notify_stop(config);
+        } catch (...) {}
+        m_is_running = false;
+    }
+
+    void NamedPipeClient::run_client_loop() {
+        notify_start(m_run_config);
+
+        IoEvent events[MAX_IO_EVENTS];
+        while (!m_is_stop_client.load(std::memory_order_acquire)) {
+            // A lost connection gives up in handle_disconnect() without a further attempt
+            if (m_is_given_up) return;
+            if (!m_is_connected.load(std::memory_order_relaxed) &&
+                std::chrono::steady_clock::now() >= m_next_attempt) {
+                try_connect();
+            }
+            if (m_is_given_up) return;
+
+            size_t count = m_transport.wait(events, MAX_IO_EVENTS, m_is_polling ? 0 : next_wait_timeout());
+            for (size_t i = 0; i < count; ++i) {
+                if (!handle_io_event(events[i])) return;
+            }
+            if (m_is_polling && m_is_connected.load(std::memory_order_relaxed)) poll_shared_memory();
+        }
+    }
+
+    bool NamedPipeClient::handle_io_event(const IoEvent& event) {
+        switch (event.type) {
+        case detail::IoEventType::Command:
+            if (event.key == CMD_TYPE_STOP) return false;
+            if (event.key == CMD_TYPE_SEND) {
+                take_pending_writes();
+                post_next_writes();
+            }
+            return true;
+        case detail::IoEventType::Error:
+            notify_error(event.error);
+            return true;
+        default:
+            break;
+        }
+
+        // The rest of a batch may still belong to a connection dropped meanwhile
+        if (!m_is_connected.load(std::memory_order_relaxed)) return true;
+
+        switch (event.type) {
+        case detail::IoEventType::Read:
+            handle_read_completion(event.bytes, event.more_data, event.error);
+            break;
+        case detail::IoEventType::Write:
+            handle_write_completion(event.bytes, event.error);
+            break;
+        case detail::IoEventType::Disconnected:
+            handle_disconnect(event.error);
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    void NamedPipeClient::try_connect() {
+        std::error_code ec;
+        if (!m_transport.connect(m_run_config.pipe_name, ec)) {
+            ++m_failed_attempts;
+            schedule_reconnect(ec);
+            return;
+        }
+
+        m_failed_attempts = 0;
+        m_reconnect_delay_ms = m_run_config.reconnect.initial_delay_ms;
+        m_message_buffer.clear();
+        m_is_connected = true;
+        notify_connected();
+        start_read();
+        // The hello goes first, the server answers a ring request after it
+        if (m_run_config.session.enabled && m_is_connected.load(std::memory_order_relaxed)) {
+            request_session();
+        }
+        if (m_run_config.shared_memory.enabled && m_is_connected.load(std::memory_order_relaxed)) {
+            request_shared_memory();
+        }
+        take_pending_writes();
+        post_next_writes();
+    }
+
+    void NamedPipeClient::schedule_reconnect(const std::error_code& ec) {
+        const ReconnectPolicy& policy = m_run_config.reconnect;
+        if (!policy.enabled || (policy.max_attempts && m_failed_attempts >= policy.max_attempts)) {
+            m_is_given_up = true;
+            notify_error(policy.enabled ? make_error_code(NamedPipeErrc::ReconnectFailed) : ec);
+            return;
+        }
+
+        size_t delay_ms = m_reconnect_delay_ms;
+        if (policy.jitter > 0.0 && delay_ms) {
+            const double spread = (std::min)(policy.jitter, 1.0) * static_cast<double>(delay_ms);
+            std::uniform_real_distribution<double> distribution(-spread, spread);
+            delay_ms = static_cast<size_t>((std::max)(0.0, static_cast<double>(delay_ms) + distribution(m_random)));
+        }
+        m_next_attempt = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+
+        const double next_delay = static_cast<double>(m_reconnect_delay_ms) * (std::max)(policy.multiplier, 1.0);
+        m_reconnect_delay_ms = static_cast<size_t>((std::min)(next_delay, static_cast<double>(policy.max_delay_ms)));
+        if (m_reconnect_delay_ms == 0 && policy.max_delay_ms) m_reconnect_delay_ms = 1;
+
+        notify_reconnecting(m_failed_attempts + 1, ec, delay_ms);
+    }
+
+    int NamedPipeClient::next_wait_timeout() const {
+        if (m_is_connected.load(std::memory_order_relaxed)) return -1;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_next_attempt - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) return 0;
+        // Round up so the loop does not wake just before the deadline
+        return static_cast<int>((std::min)(remaining + 1, static_cast<decltype(remaining)>((std::numeric_limits<int>::max)())));
+    }
+
+    void NamedPipeClient::start_read() {
+        std::error_code ec;
+        if (!m_transport.read(m_read_buffer.data(), m_read_buffer.size(), ec)) {
+            handle_disconnect(ec);
+        }
+    }
+
+    void NamedPipeClient::handle_read_completion(size_t bytes_transferred, bool more_data, const std::error_code& ec) {
+        if (ec) {
+            handle_disconnect(ec);
+            return;
+        }
+        bool is_accepted = false;
+        if (m_shm_state == SharedMemoryState::Active) {
+            // Messages come through the ring, the pipe only wakes us up
+            handle_shm_wakeup();
+            if (m_is_connected.load(std::memory_order_relaxed)) start_read();
+            return;
+        }
+        if (m_shm_state == SharedMemoryState::Requested && !more_data && m_message_buffer.empty() &&
+            detail::parse_shared_memory_reply(m_read_buffer.data(), bytes_transferred, is_accepted)) {
+            complete_shm_handshake(is_accepted);
+            if (m_is_connected.load(std::memory_order_relaxed)) start_read();
+            return;
+        }
+        if (more_data) {
+            m_message_buffer.append(m_read_buffer.data(), bytes_transferred);
+            start_read();
+            return;
+        }
+
+        if (m_message_buffer.empty()) {
+            deliver_message(MessageView(m_read_buffer.data(), bytes_transferred));
+        } else {
+            m_message_buffer.append(m_read_buffer.data(), bytes_transferred);
+            deliver_message(MessageView(m_message_buffer.data(), m_message_buffer.size()));
+            m_message_buffer.clear();
+        }
+        if (m_is_connected.load(std::memory_order_relaxed)) start_read();
+    }
+
+    void NamedPipeClient::handle_disconnect(const std::error_code& ec) {
+        if (!m_is_connected.load(std::memory_order_relaxed)) return;
+        m_transport.disconnect();
+        m_is_connected = false;
+        m_message_buffer.clear();
+        reset_shared_memory();
+        // Token and last sequence stay for the resume
+        m_session_state = SessionState::Off;
+        m_session_hello.clear();
+
+        const std::error_code reason = ec ? ec : make_error_code(NamedPipeErrc::NotConnected);
+        // Whether the server got the writes in flight is unknown
+        fail_writes(m_active_writes, m_inflight_writes, reason);
+        m_inflight_writes = 0;
+        if (!m_run_config.write_limits.queue_while_disconnected) {
+            fail_writes(m_active_writes, m_active_writes.size(), make_error_code(NamedPipeErrc::NotConnected));
+        }
+
+        notify_disconnected(reason);
+        schedule_reconnect(reason);
+    }
+
+    void NamedPipeClient::take_pending_writes() {
+        std::deque<WriteCommand> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_is_send_posted = false;
+            pending.swap(m_pending_writes);
+        }
+        if (!m_is_connected.load(std::memory_order_relaxed) &&
+            !m_run_config.write_limits.queue_while_disconnected) {
+            fail_writes(pending, pending.size(), make_error_code(NamedPipeErrc::NotConnected));
+            return;
+        }
+        for (auto& cmd : pending) {
+            m_active_writes.push_back(std::move(cmd));
+        }
+    }
+
+    void NamedPipeClient::post_next_writes() {
+        if (m_shm_state == SharedMemoryState::Requested) return; // Held until the server answers
+        if (m_shm_state == SharedMemoryState::Active) {
+            post_shm_writes();
+            return;
+        }
+        const size_t max_inflight = (std::max)(m_run_config.write_limits.max_inflight_writes, size_t(1));
+        while (m_is_connected.load(std::memory_order_relaxed) &&
+               m_inflight_writes < max_inflight &&
+               m_inflight_writes < m_active_writes.size()) {
+            const WriteCommand& cmd = m_active_writes[m_inflight_writes];
+            std::error_code ec;
+            if (!m_transport.write(cmd.data(), cmd.size(), ec)) {
+                handle_disconnect(ec);
+                return;
+            }
+            ++m_inflight_writes;
+        }
+    }
+
+    void NamedPipeClient::handle_write_completion(size_t bytes_transferred, const std::error_code& ec) {
+        (void)bytes_transferred;
+        if (m_control_writes > 0) {
+            --m_control_writes;
+            if (ec) handle_disconnect(ec);
+            return;
+        }
+        if (m_inflight_writes == 0 || m_active_writes.empty()) return;
+
+        WriteCommand cmd = std::move(m_active_writes.front());
+        m_active_writes.pop_front();
+        --m_inflight_writes;
+        release_write(cmd);
+        complete_write(cmd, ec);
+
+        if (ec) {
+            handle_disconnect(ec);
+            return;
+        }
+        post_next_writes();
+    }
+
+    void NamedPipeClient::fail_writes(std::deque<WriteCommand>& writes, size_t count, const std::error_code& reason) {
+        count = (std::min)(count, writes.size());
+        for (size_t i = 0; i < count; ++i) {
+            WriteCommand cmd = std::move(writes.front());
+            writes.pop_front();
+            release_write(cmd);
+            complete_write(cmd, reason);
+        }
+    }
+
+    void NamedPipeClient::request_session() {
+        m_session_hello = detail::make_session_hello(m_session_token, m_last_sequence);
+        std::error_code ec;
+        if (!m_transport.write(m_session_hello.data(), m_session_hello.size(), ec)) {
+            handle_disconnect(ec);
+            return;
+        }
+        ++m_control_writes;
+        m_session_state = SessionState::Requested;
+    }
+
+    void NamedPipeClient::complete_session_handshake(const std::string& token, detail::SessionStatus status) {
+        const bool is_resuming = !m_session_token.empty();
+        switch (status) {
+        case detail::SessionStatus::Resumed:
+            m_session_state = SessionState::Active;
+            return;
+        case detail::SessionStatus::New:
+            m_session_state = SessionState::Active;
+            m_session_token = token;
+            m_last_sequence = 0;
+            // The server no longer has what was sent while we were away
+            if (is_resuming) notify_error(make_error_code(NamedPipeErrc::SessionFailed));
+            return;
+        default:
+            m_session_state = SessionState::Off;
+            m_session_token.clear();
+            m_last_sequence = 0;
+            notify_error(make_error_code(NamedPipeErrc::SessionFailed));
+            return;
+        }
+    }
+
+    void NamedPipeClient::deliver_message(MessageView message) {
+        if (m_session_state == SessionState::Off) {
+            notify_message(message);
+            return;
+        }
+        if (m_session_state == SessionState::Requested) {
+            std::string token;
+            detail::SessionStatus status = detail::SessionStatus::Refused;
+            if (detail::parse_session_welcome(message.data(), message.size(), token, status)) {
+                complete_session_handshake(token, status);
+            } else {
+                // Written before the server read the hello
+                notify_message(message);
+            }
+            return;
+        }
+        if (message.size() < detail::SEQUENCE_SIZE) {
+            notify_message(message);
+            return;
+        }
+        const uint64_t sequence = detail::read_sequence(message.data());
+        // Already delivered before the reconnect
+        if (sequence <= m_last_sequence) return;
+        m_last_sequence = sequence;
+        notify_message(MessageView(message.data() + detail::SEQUENCE_SIZE, message.size() - detail::SEQUENCE_SIZE));
+    }
+
+    void NamedPipeClient::request_shared_memory() {
+        const size_t ring_size = detail::SharedChannel::ring_size_for(m_run_config.shared_memory.ring_size);
+        const std::string name = detail::SharedChannel::unique_name();
+        std::unique_ptr<detail::SharedChannel> channel(new detail::SharedChannel());
+        std::error_code ec;
+        if (!channel->create(name, ring_size, ec)) {
+            // Stay on the pipe
+            notify_error(ec);
+            return;
+        }
+
+        m_shm_request = detail::make_shared_memory_request(ring_size, name);
+        if (!m_transport.write(m_shm_request.data(), m_shm_request.size(), ec)) {
+            detail::SharedMemory::remove(name);
+            handle_disconnect(ec);
+            return;
+        }
+        ++m_control_writes;
+        m_shm = std::move(channel);
+        m_shm_name = name;
+        m_shm_state = SharedMemoryState::Requested;
+    }
+
+    void NamedPipeClient::complete_shm_handshake(bool is_accepted) {
+        // Both sides have it mapped or never will
+        detail::SharedMemory::remove(m_shm_name);
+        m_shm_name.clear();
+        if (is_accepted) {
+            m_shm_state = SharedMemoryState::Active;
+            m_is_shm_active = true;
+        } else {
+            m_shm.reset();
+            m_shm_state = SharedMemoryState::Off;
+            notify_error(make_error_code(NamedPipeErrc::SharedMemoryFailed));
+        }
+        post_next_writes();
+    }
+
+    void NamedPipeClient::handle_shm_wakeup() {
+        for (;;) {
+            size_t delivered = 0;
+            if (!drain_shared_memory(delivered)) return;
+            // The wakeup may also mean room in the outgoing ring
+            post_shm_writes();
+            if (m_run_config.shared_memory.spin_us) {
+                m_spin_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(m_run_config.shared_memory.spin_us);
+                set_polling(true);
+                return;
+            }
+            if (m_shm->inbound().prepare_consumer_wait()) return;
+        }
+    }
+
+    // Delivers everything in the incoming ring; false if the ring is broken
+    bool NamedPipeClient::drain_shared_memory(size_t& delivered) {
+        detail::SharedRing& ring = m_shm->inbound();
+        MessageView message;
+        std::error_code ec;
+        while (ring.peek(message, ec)) {
+            deliver_message(message);
+            ring.pop();
+            ++delivered;
+        }
+        if (ec) {
+            handle_disconnect(ec);
+            return false;
+        }
+        if (ring.take_producer_wakeup()) send_shm_wakeup();
+        return true;
+    }
+
+    void NamedPipeClient::post_shm_writes() {
+        if (m_active_writes.empty()) return;
+        detail::SharedRing& ring = m_shm->outbound();
+        while (!m_active_writes.empty()) {
+            const WriteCommand& next = m_active_writes.front();
+            std::error_code ec;
+            if (next.size() > ring.max_message_size()) {
+                ec = make_error_code(NamedPipeErrc::MessageTooLarge);
+            } else if (!ring.try_write(next.data(), next.size())) {
+                // Full: the server wakes us when it has made room
+                if (ring.prepare_producer_wait(next.size())) break;
+                continue;
+            }
+            WriteCommand cmd = std::move(m_active_writes.front());
+            m_active_writes.pop_front();
+            release_write(cmd);
+            complete_write(cmd, ec);
+        }
+        if (ring.take_consumer_wakeup()) send_shm_wakeup();
+    }
+
+    void NamedPipeClient::send_shm_wakeup() {
+        // A failed write shows up as a disconnect on the read side
+        std::error_code ec;
+        if (m_transport.write(&detail::SHARED_MEMORY_WAKEUP, 1, ec)) ++m_control_writes;
+    }
+
+    void NamedPipeClient::poll_shared_memory() {
+        const auto spin = std::chrono::microseconds(m_run_config.shared_memory.spin_us);
+        for (size_t round = 0; round < SPIN_ROUNDS; ++round) {
+            size_t delivered = 0;
+            if (!drain_shared_memory(delivered)) return;
+            // send() posts nothing while polling, the count tells that messages wait
+            if (m_queued_count.load(std::memory_order_acquire) > m_active_writes.size()) {
+                take_pending_writes();
+                ++delivered;
+            }
+            post_shm_writes();
+
+            const auto now = std::chrono::steady_clock::now();
+            if (delivered) {
+                m_spin_deadline = now + spin;
+            } else if (now >= m_spin_deadline) {
+                // Idle long enough: take what was queued without a SEND and sleep on the pipe
+                set_polling(false);
+                take_pending_writes();
+                post_shm_writes();
+                if (!m_shm->inbound().prepare_consumer_wait()) {
+                    m_spin_deadline = now + spin;
+                    set_polling(true);
+                }
+                return;
+            }
+        }
+    }
+
+    void NamedPipeClient::set_polling(bool is_polling) {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        m_is_polling = is_polling;
+    }
+
+    void NamedPipeClient::reset_shared_memory() {
+        if (!m_shm_name.empty()) detail::SharedMemory::remove(m_shm_name);
+        m_shm_name.clear();
+        m_shm_request.clear();
+        m_shm.reset();
+        m_shm_state = SharedMemoryState::Off;
+        m_is_shm_active = false;
+        m_control_writes = 0;
+        if (m_is_polling) set_polling(false);
+    }
+
+    void NamedPipeClient::notify_connected() {
+        if (on_connected) on_connected();
+        if (on_event) on_event(ClientEvent::connected());
+    }
+
+    void NamedPipeClient::notify_disconnected(const std::error_code& ec) {
+        if (on_disconnected) on_disconnected(ec);
+        if (on_event) on_event(ClientEvent::disconnected(ec));
+    }
+
+    void NamedPipeClient::notify_reconnecting(size_t attempt, const std::error_code& ec, size_t delay_ms) {
+        if (on_reconnecting) on_reconnecting(attempt, ec);
+        if (on_event) on_event(ClientEvent::reconnecting(ec, attempt, delay_ms));
+    }
+
+    void NamedPipeClient::notify_message(MessageView message) {
+        if (on_message_view) on_message_view(message);
+        if (!on_message && !on_event) return;
+        std::string copy = message.to_string();
+        if (on_message) on_message(copy);
+        if (on_event) on_event(ClientEvent::message_received(std::move(copy)));
+    }
+
+    void NamedPipeClient::notify_start(const ClientConfig& config) {
+        if (on_start) on_start(config);
+        if (on_event) on_event(ClientEvent::client_started());
+    }
+
+    void NamedPipeClient::notify_stop(const ClientConfig& config) {
+        if (on_stop) on_stop(config);
+        if (on_event) on_event(ClientEvent::client_stopped());
+    }
+
+    void NamedPipeClient::notify_error(const std::error_code& ec) {
+        if (on_error) on_error(ec);
+        if (on_event) on_event(ClientEvent::error_occurred(ec));
+    }
+};
@@ -0,0 +1,338 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_UNIX_SOCKET_CLIENT_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_UNIX_SOCKET_CLIENT_TRANSPORT_HPP_INCLUDED
+
+/// \file UnixSocketClientTransport.hpp
+/// \brief Client transport built on an AF_UNIX/SOCK_SEQPACKET socket and poll().
+///
+/// Readiness reported by poll() is turned into the same IoEvent completions
+/// the Win32 backend produces, so NamedPipeClient has a single code path.
+
+#include "../NamedPipeServer/UnixSocketTransport.hpp"
+
+#include <poll.h>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class UnixSocketClientTransport
+    /// \brief One non-blocking SEQPACKET connection driven by a single thread.
+    ///
+    /// Everything except post() must be called from the thread that calls wait().
+    /// Writes are kept in a FIFO and sent back to back while the socket accepts
+    /// them, so several messages can be in flight at once.
+    class UnixSocketClientTransport {
+    public:
+        UnixSocketClientTransport() = default;
+        UnixSocketClientTransport(const UnixSocketClientTransport&) = delete;
+        UnixSocketClientTransport& operator=(const UnixSocketClientTransport&) = delete;
+
+        ~UnixSocketClientTransport() {
+            close();
+        }
+
+        /// \brief Creates the wakeup descriptor.
+        /// \throws std::system_error on failure.
+        void open() {
+            close();
+            int wakeup_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (wakeup_fd < 0) {
+                throw std::system_error(last_error(), "Failed to create eventfd");
+            }
+            m_wakeup_fd.store(wakeup_fd, std::memory_order_release);
+        }
+
+        /// \brief Drops the connection and closes the wakeup descriptor.
+        void close() {
+            disconnect();
+            int wakeup_fd = m_wakeup_fd.exchange(-1, std::memory_order_acq_rel);
+            if (wakeup_fd >= 0) ::close(wakeup_fd);
+            m_ready.clear();
+            std::lock_guard<std::mutex> lock(m_command_mutex);
+            m_commands.clear();
+        }
+
+        /// \brief Checks whether the transport is open.
+        bool is_open() const {
+            return m_wakeup_fd.load(std::memory_order_acquire) >= 0;
+        }
+
+        /// \brief Connects to the server socket without blocking.
+        /// \return false if the server is not there or refused the connection.
+        bool connect(const std::string& pipe_name, std::error_code& ec) {
+            disconnect();
+            const std::string path = make_unix_socket_path(pipe_name);
+            sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path)) {
+                ec = std::make_error_code(std::errc::filename_too_long);
+                return false;
+            }
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+            int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                ec = last_error();
+                return false;
+            }
+            int rc;
+            do {
+                rc = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            } while (rc < 0 && errno == EINTR);
+            if (rc < 0) {
+                ec = last_error();
+                ::close(fd);
+                return false;
+            }
+            ec.clear();
+            m_fd = fd;
+            m_is_broken = false;
+            return true;
+        }
+
+        /// \brief Closes the socket. Pending operations and their completions are discarded.
+        void disconnect() {
+            if (m_fd >= 0) {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+            m_is_broken = false;
+            m_read_data = nullptr;
+            m_read_size = 0;
+            m_read_pending = false;
+            std::vector<char>().swap(m_spill);
+            m_spill_offset = 0;
+            m_writes.clear();
+            // Keep posted commands, drop completions of the old connection
+            std::deque<IoEvent> commands;
+            for (const IoEvent& event : m_ready) {
+                if (event.type == IoEventType::Command) commands.push_back(event);
+            }
+            m_ready.swap(commands);
+        }
+
+        /// \brief Checks whether a connection is established.
+        bool is_connected() const {
+            return m_fd >= 0;
+        }
+
+        /// \brief Starts reading the next message into the buffer.
+        bool read(char* data, size_t size, std::error_code& ec) {
+            if (m_fd < 0) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            ec.clear();
+            m_read_data = data;
+            m_read_size = size;
+            m_read_pending = true;
+            if (m_spill_offset < m_spill.size()) read_spill();
+            return true;
+        }
+
+        /// \brief Queues one message; it is sent at once if the socket has room.
+        bool write(const char* data, size_t size, std::error_code& ec) {
+            if (m_fd < 0) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            ec.clear();
+            m_writes.push_back(PendingWrite{data, size});
+            if (m_writes.size() == 1) flush_writes();
+            return true;
+        }
+
+        /// \brief Posts a command key to the waiting thread. Thread-safe.
+        bool post(uintptr_t key) {
+            int wakeup_fd = m_wakeup_fd.load(std::memory_order_acquire);
+            if (wakeup_fd < 0) return false;
+            {
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+                m_commands.push_back(key);
+            }
+            uint64_t one = 1;
+            return ::write(wakeup_fd, &one, sizeof(one)) == sizeof(one);
+        }
+
+        /// \brief Waits for completions.
+        /// \param events Output array.
+        /// \param max_events Capacity of the output array.
+        /// \param timeout_ms Timeout in milliseconds, -1 waits infinitely.
+        /// \return Number of events written; 0 on timeout.
+        size_t wait(IoEvent* events, size_t max_events, int timeout_ms) {
+            if (!m_ready.empty()) return drain_ready(events, max_events);
+
+            pollfd fds[2];
+            nfds_t count = 1;
+            fds[0].fd = m_wakeup_fd.load(std::memory_order_acquire);
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            if (m_fd >= 0 && !m_is_broken) {
+                fds[1].fd = m_fd;
+                fds[1].events = static_cast<short>((m_read_pending ? POLLIN : 0) | (m_writes.empty() ? 0 : POLLOUT));
+                fds[1].revents = 0;
+                count = 2;
+            }
+
+            int n = ::poll(fds, count, timeout_ms);
+            if (n < 0) {
+                if (errno != EINTR) m_ready.push_back(IoEvent(IoEventType::Error, 0, 0, last_error()));
+                return drain_ready(events, max_events);
+            }
+
+            if (fds[0].revents) read_commands();
+            if (count == 2 && fds[1].revents) {
+                const short flags = fds[1].revents;
+                if (m_read_pending && (flags & (POLLIN | POLLHUP | POLLERR))) do_read();
+                if (!m_writes.empty() && (flags & (POLLOUT | POLLHUP | POLLERR))) flush_writes();
+                if (!m_read_pending && m_writes.empty() && (flags & (POLLHUP | POLLERR))) {
+                    // Nothing is waiting for the socket, report the hangup once
+                    m_is_broken = true;
+                    m_ready.push_back(IoEvent(IoEventType::Disconnected, 0, 0, std::make_error_code(std::errc::broken_pipe)));
+                }
+            }
+            return drain_ready(events, max_events);
+        }
+
+    private:
+        struct PendingWrite {
+            const char* data;
+            size_t      size;
+        };
+
+        std::atomic<int>         m_wakeup_fd{-1};
+        int                      m_fd = -1;
+        bool                     m_is_broken = false; ///< Disconnect reported, socket no longer polled
+        char*                    m_read_data = nullptr;
+        size_t                   m_read_size = 0;
+        bool                     m_read_pending = false;
+        std::vector<char>        m_spill;             ///< Remainder of a message larger than the read buffer
+        size_t                   m_spill_offset = 0;
+        std::deque<PendingWrite> m_writes;            ///< Accepted by write(), not yet sent
+        std::deque<IoEvent>      m_ready;
+        std::mutex               m_command_mutex;
+        std::vector<uintptr_t>   m_commands;
+
+        static std::error_code last_error() {
+            return std::error_code(errno, std::system_category());
+        }
+
+        size_t drain_ready(IoEvent* events, size_t max_events) {
+            size_t count = 0;
+            while (count < max_events && !m_ready.empty()) {
+                events[count++] = m_ready.front();
+                m_ready.pop_front();
+            }
+            return count;
+        }
+
+        void read_commands() {
+            int wakeup_fd = m_wakeup_fd.load(std::memory_order_acquire);
+            uint64_t value = 0;
+            while (::read(wakeup_fd, &value, sizeof(value)) > 0) {}
+            std::vector<uintptr_t> commands;
+            {
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+                commands.swap(m_commands);
+            }
+            for (uintptr_t key : commands) {
+                m_ready.push_back(IoEvent(IoEventType::Command, key));
+            }
+        }
+
+        void report_disconnect(const std::error_code& ec) {
+            m_is_broken = true;
+            m_read_pending = false;
+            m_ready.push_back(IoEvent(IoEventType::Disconnected, 0, 0, ec));
+        }
+
+        void do_read() {
+            // Probe the size of the next packet so that messages larger than
+            // the read buffer are not truncated by the kernel.
+            ssize_t length;
+            do {
+                length = ::recv(m_fd, nullptr, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+            } while (length < 0 && errno == EINTR);
+
+            if (length < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) report_disconnect(last_error());
+                return;
+            }
+            if (length == 0) {
+                report_disconnect(std::make_error_code(std::errc::broken_pipe));
+                return;
+            }
+
+            size_t size = static_cast<size_t>(length);
+            char* target = m_read_data;
+            if (size > m_read_size) {
+                m_spill.resize(size);
+                target = m_spill.data();
+            }
+
+            ssize_t received;
+            do {
+                received = ::recv(m_fd, target, size, MSG_DONTWAIT);
+            } while (received < 0 && errno == EINTR);
+
+            if (received < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) report_disconnect(last_error());
+                return;
+            }
+
+            if (target == m_read_data) {
+                m_read_pending = false;
+                m_ready.push_back(IoEvent(IoEventType::Read, 0, static_cast<size_t>(received)));
+                return;
+            }
+
+            m_spill.resize(static_cast<size_t>(received));
+            m_spill_offset = 0;
+            read_spill();
+        }
+
+        void read_spill() {
+            size_t remaining = m_spill.size() - m_spill_offset;
+            size_t chunk = (std::min)(remaining, m_read_size);
+            std::memcpy(m_read_data, m_spill.data() + m_spill_offset, chunk);
+            m_spill_offset += chunk;
+
+            IoEvent event(IoEventType::Read, 0, chunk);
+            event.more_data = m_spill_offset < m_spill.size();
+            if (!event.more_data) {
+                std::vector<char>().swap(m_spill);
+                m_spill_offset = 0;
+            }
+            m_read_pending = false;
+            m_ready.push_back(event);
+        }
+
+        void flush_writes() {
+            while (!m_writes.empty()) {
+                const PendingWrite& front = m_writes.front();
+                ssize_t sent;
+                do {
+                    sent = ::send(m_fd, front.data, front.size, MSG_NOSIGNAL | MSG_DONTWAIT);
+                } while (sent < 0 && errno == EINTR);
+
+                if (sent < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                    // The connection is gone: fail everything still queued
+                    std::error_code ec = last_error();
+                    for (size_t i = 0; i < m_writes.size(); ++i) {
+                        m_ready.push_back(IoEvent(IoEventType::Write, 0, 0, ec));
+                    }
+                    m_writes.clear();
+                    return;
+                }
+                m_ready.push_back(IoEvent(IoEventType::Write, 0, static_cast<size_t>(sent)));
+                m_writes.pop_front();
+            }
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_UNIX_SOCKET_CLIENT_TRANSPORT_HPP_INCLUDED
@@ -0,0 +1,261 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_WIN32_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_WIN32_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
+
+/// \file Win32PipeClientTransport.hpp
+/// \brief Client transport built on an overlapped named pipe handle and IO Completion Port.
+
+#include "../NamedPipeServer/errors.hpp"
+#include "../NamedPipeServer/IoEvent.hpp"
+
+#include <windows.h>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <codecvt>
+#include <locale>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class Win32PipeClientTransport
+    /// \brief One message-mode pipe handle bound to a private completion port.
+    ///
+    /// Everything except post() must be called from the thread that calls wait().
+    /// Every read and write gets its own OVERLAPPED, so several writes can be
+    /// outstanding at once. Requests are recycled only after their completion
+    /// has been dequeued; completions of a previous connection are dropped.
+    class Win32PipeClientTransport {
+    public:
+        Win32PipeClientTransport() = default;
+        Win32PipeClientTransport(const Win32PipeClientTransport&) = delete;
+        Win32PipeClientTransport& operator=(const Win32PipeClientTransport&) = delete;
+
+        ~Win32PipeClientTransport() {
+            close();
+        }
+
+        /// \brief Creates the completion port.
+        /// \throws std::system_error on failure.
+        void open() {
+            close();
+            HANDLE completion_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+            if (!completion_port) {
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to create IO completion port");
+            }
+            m_completion_port.store(completion_port, std::memory_order_release);
+        }
+
+        /// \brief Drops the connection and closes the completion port.
+        void close() {
+            disconnect();
+            HANDLE completion_port = m_completion_port.exchange(nullptr, std::memory_order_acq_rel);
+            if (completion_port) {
+                CloseHandle(completion_port);
+            }
+            // All I/O has finished in disconnect(), nothing references the requests
+            m_active.clear();
+            m_free.clear();
+            m_requests.clear();
+        }
+
+        /// \brief Checks whether the transport is open.
+        bool is_open() const {
+            return m_completion_port.load(std::memory_order_acquire) != nullptr;
+        }
+
+        /// \brief Opens the pipe in message read mode without waiting for a free instance.
+        /// \return false if the server is not there or all instances are busy.
+        bool connect(const std::string& pipe_name, std::error_code& ec) {
+            disconnect();
+            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> conv;
+            const std::wstring path = L"\\\\.\\pipe\\" + conv.from_bytes(pipe_name);
+
+            HANDLE pipe = CreateFileW(
+                path.c_str(),
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_OVERLAPPED,
+                nullptr);
+            if (pipe == INVALID_HANDLE_VALUE) {
+                ec = system_error_code(GetLastError());
+                return false;
+            }
+
+            DWORD mode = PIPE_READMODE_MESSAGE;
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            if (!SetNamedPipeHandleState(pipe, &mode, nullptr, nullptr) ||
+                !CreateIoCompletionPort(pipe, completion_port, 0, 0)) {
+                ec = system_error_code(GetLastError());
+                CloseHandle(pipe);
+                return false;
+            }
+            ec.clear();
+            m_pipe = pipe;
+            return true;
+        }
+
+        /// \brief Cancels pending I/O and closes the pipe handle.
+        void disconnect() {
+            if (m_pipe == INVALID_HANDLE_VALUE) return;
+            CancelIoEx(m_pipe, nullptr);
+            for (IoRequest* req : m_active) {
+                // Wait for the aborted operation to release its buffer
+                DWORD bytes = 0;
+                GetOverlappedResult(m_pipe, &req->ov, &bytes, TRUE);
+            }
+            // Their completions stay queued and are recycled as stale in wait()
+            m_active.clear();
+            CloseHandle(m_pipe);
+            m_pipe = INVALID_HANDLE_VALUE;
+            ++m_epoch;
+        }
+
+        /// \brief Checks whether a connection is established.
+        bool is_connected() const {
+            return m_pipe != INVALID_HANDLE_VALUE;
+        }
+
+        /// \brief Starts an overlapped read.
+        bool read(char* data, size_t size, std::error_code& ec) {
+            if (m_pipe == INVALID_HANDLE_VALUE) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            IoRequest* req = acquire(true);
+            BOOL success = ReadFile(m_pipe, data, static_cast<DWORD>(size), nullptr, &req->ov);
+            DWORD err = GetLastError();
+            if (!success && err != ERROR_IO_PENDING && err != ERROR_MORE_DATA) {
+                recycle(req);
+                ec = system_error_code(err);
+                return false;
+            }
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Starts an overlapped write of one message.
+        bool write(const char* data, size_t size, std::error_code& ec) {
+            if (m_pipe == INVALID_HANDLE_VALUE) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            IoRequest* req = acquire(false);
+            BOOL success = WriteFile(m_pipe, data, static_cast<DWORD>(size), nullptr, &req->ov);
+            DWORD err = GetLastError();
+            if (!success && err != ERROR_IO_PENDING) {
+                recycle(req);
+                ec = system_error_code(err);
+                return false;
+            }
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Posts a command key to the completion port. Thread-safe.
+        bool post(uintptr_t key) {
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            if (!completion_port) return false;
+            return PostQueuedCompletionStatus(completion_port, 0, static_cast<ULONG_PTR>(key), nullptr) != FALSE;
+        }
+
+        /// \brief Dequeues a completion.
+        /// \param events Output array.
+        /// \param max_events Capacity of the output array.
+        /// \param timeout_ms Timeout in milliseconds, -1 waits infinitely.
+        /// \return Number of events written; 0 on timeout or for stale completions.
+        size_t wait(IoEvent* events, size_t max_events, int timeout_ms) {
+            if (max_events == 0) return 0;
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+
+            DWORD bytes_transferred = 0;
+            ULONG_PTR key = 0;
+            OVERLAPPED* ov = nullptr;
+            BOOL ok = GetQueuedCompletionStatus(
+                completion_port,
+                &bytes_transferred,
+                &key,
+                &ov,
+                timeout_ms < 0 ? INFINITE : static_cast<DWORD>(timeout_ms));
+            DWORD err = ok ? ERROR_SUCCESS : GetLastError();
+
+            if (ov == nullptr) {
+                if (ok) {
+                    events[0] = IoEvent(IoEventType::Command, static_cast<uintptr_t>(key));
+                    return 1;
+                }
+                if (err == WAIT_TIMEOUT) return 0;
+                events[0] = IoEvent(IoEventType::Error, 0, 0, system_error_code(err));
+                return 1;
+            }
+
+            IoRequest* req = reinterpret_cast<IoRequest*>(ov);
+            const bool is_read = req->is_read;
+            const bool is_stale = req->epoch != m_epoch;
+            recycle(req);
+            if (is_stale) return 0;
+
+            if (is_read) {
+                if (ok || err == ERROR_MORE_DATA) {
+                    events[0] = IoEvent(IoEventType::Read, 0, bytes_transferred);
+                    events[0].more_data = !ok;
+                } else {
+                    events[0] = IoEvent(IoEventType::Disconnected, 0, 0, system_error_code(err));
+                }
+                return 1;
+            }
+            events[0] = IoEvent(IoEventType::Write, 0, bytes_transferred, ok ? std::error_code() : system_error_code(err));
+            return 1;
+        }
+
+    private:
+        /// \brief Overlapped request of one read or write.
+        struct IoRequest {
+            OVERLAPPED ov;       ///< Must be the first member
+            uint64_t   epoch;    ///< Connection the request was issued on
+            bool       is_read;
+        };
+
+        std::atomic<HANDLE> m_completion_port{nullptr};
+        HANDLE              m_pipe = INVALID_HANDLE_VALUE;
+        uint64_t            m_epoch = 0;                   ///< Incremented on disconnect
+        std::vector<std::unique_ptr<IoRequest>> m_requests; ///< Owns every request ever allocated
+        std::vector<IoRequest*> m_free;                     ///< Completed requests ready for reuse
+        std::vector<IoRequest*> m_active;                   ///< Issued and not yet dequeued
+
+        static std::error_code system_error_code(DWORD err) {
+            return std::error_code(static_cast<int>(err), std::system_category());
+        }
+
+        IoRequest* acquire(bool is_read) {
+            IoRequest* req;
+            if (m_free.empty()) {
+                m_requests.emplace_back(new IoRequest());
+                req = m_requests.back().get();
+            } else {
+                req = m_free.back();
+                m_free.pop_back();
+            }
+            memset(&req->ov, 0, sizeof(OVERLAPPED));
+            req->epoch = m_epoch;
+            req->is_read = is_read;
+            m_active.push_back(req);
+            return req;
+        }
+
+        void recycle(IoRequest* req) {
+            auto it = std::find(m_active.begin(), m_active.end(), req);
+            if (it != m_active.end()) m_active.erase(it);
+            m_free.push_back(req);
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_WIN32_PIPE_CLIENT_TRANSPORT_HPP_INCLUDED
@@ -7,59 +7,96 @@
 
 #include "NamedPipeServer/ServerConfig.hpp"
 #include "NamedPipeServer/errors.hpp"
+#include "NamedPipeServer/Buffer.hpp"
+#include "NamedPipeServer/MulticastResult.hpp"
+#include "NamedPipeServer/MessageView.hpp"
 #include "NamedPipeServer/IConnection.hpp"
 #include "NamedPipeServer/Connection.hpp"
+#include "NamedPipeServer/ServerMetrics.hpp"
 #include "NamedPipeServer/ServerEvent.hpp"
 #include "NamedPipeServer/ServerEventHandler.hpp"
+#include "NamedPipeServer/ServerHooks.hpp"
+#include "NamedPipeServer/ServerCallbacks.hpp"
+#include "NamedPipeServer/Transport.hpp"
+#include "NamedPipeServer/ClientTable.hpp"
+#include "NamedPipeServer/MpscQueue.hpp"
+#include "NamedPipeServer/BufferPool.hpp"
+#include "NamedPipeServer/CallbackPool.hpp"
+#include "NamedPipeServer/SharedRing.hpp"
+#include "NamedPipeServer/TimerWheel.hpp"
+#include "NamedPipeServer/Journal.hpp"
+#include "NamedPipeServer/Session.hpp"
 
-#include <windows.h>
 #include <array>
 #include <vector>
+#include <deque>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <chrono>
 
 namespace SimpleNamedPipe {
 
-    /// \class NamedPipeServer
+    /// \class BasicNamedPipeServer
     /// \brief Asynchronous named pipe server implementation.
-    class NamedPipeServer final : public IConnection {
+    ///
+    /// The OS-specific part lives in the transport selected at compile time:
+    /// named pipes with IO Completion Port on Windows, AF_UNIX SOCK_SEQPACKET
+    /// sockets with epoll elsewhere (see Transport.hpp).
+    ///
+    /// With ServerConfig::io_threads > 1 several threads dequeue completions.
+    /// Events of one client are serialized by its strand, so callbacks for the
+    /// same client id never overlap and keep their order, while callbacks for
+    /// different clients may run concurrently.
+    ///
+    /// Messages are read into pooled per-client buffers. `on_message_view`
+    /// gets a view straight into them, so a message that fits into
+    /// ServerConfig::buffer_size is neither copied nor allocated. The string
+    /// based `on_message`, `on_event` and the event handler's `on_message`
+    /// need an owned string and copy the message first.
+    ///
+    /// Events go to `Handler` through ServerHooks<Handler>, resolved at
+    /// compile time (see ServerHooks.hpp for the handler interface).
+    /// NamedPipeServer is the instance with ServerCallbacks, whose callbacks
+    /// are assigned at run time. A server with another handler needs the
+    /// implementation: include BasicNamedPipeServer.hpp.
+    ///
+    /// \tparam Handler Class implementing any subset of the server events.
+    template <class Handler>
+    class BasicNamedPipeServer final : public IConnection, public detail::HandlerHolder<Handler> {
     public:
 
         /// \brief Constructor.
-        NamedPipeServer();
+        BasicNamedPipeServer();
 
         /// \brief Constructor with config.
-        explicit NamedPipeServer(const ServerConfig& config);
+        explicit BasicNamedPipeServer(const ServerConfig& config);
 
-        /// \brief Destructor.
-        virtual ~NamedPipeServer();
+        /// \brief Constructor with config and a handler.
+        BasicNamedPipeServer(const ServerConfig& config, Handler handler);
 
-        // Callbacks
-        std::function<void(const ServerEvent&)>          on_event;
-        std::function<void(int)>                         on_connected;
-        std::function<void(int, const std::error_code&)> on_disconnected;
-        std::function<void(int, const std::string&)>     on_message;
-        std::function<void(const ServerConfig&)>         on_start;
-        std::function<void(const ServerConfig&)>         on_stop;
-        std::function<void(const std::error_code&)>      on_error;
+        /// \brief Destructor.
+        virtual ~BasicNamedPipeServer();
 
         // API
 
-        /// \brief Sets a custom event handler instance.
-        /// \param handler Shared pointer to the handler.
-        void set_event_handler(std::shared_ptr<ServerEventHandler> handler);
-
-        /// \brief Returns the currently assigned event handler.
-        /// \return Shared pointer to the handler or nullptr.
-        std::shared_ptr<ServerEventHandler> get_event_handler() const;
-
         /// \brief Applies a new server configuration.
+        ///
+        /// While the server runs, write and read limits and the pipe timeout
+        /// take effect at once and buffer_size for every client that connects
+        /// afterwards, without dropping anyone; so do listen_instances and
+        /// max_clients with the next connect or disconnect, keep_alive
+        /// with each client's next check, and sessions with the next
+        /// session opened or detached. A change of pipe_name,
+        /// io_threads, write_batching, metrics, callback_dispatch or journal restarts
+        /// the server, which disconnects all clients.
         /// \param config Configuration to use.
         void set_config(const ServerConfig& config);
 
@@ -83,6 +120,82 @@ namespace SimpleNamedPipe {
         /// \param on_done Optional callback invoked when send completes.
         void send_to(int client_id, const std::string& message, DoneCallback on_done = nullptr) override;
 
+        /// \brief Sends a message without copying it.
+        /// \param client_id ID of the client.
+        /// \param message Message moved into the send queue; written straight from its storage.
+        /// \param on_done Optional callback invoked when send completes.
+        void send_to(int client_id, std::string&& message, DoneCallback on_done = nullptr) override;
+
+        /// \brief Sends a shared payload without copying it.
+        /// \param client_id ID of the client.
+        /// \param message Payload kept alive until the write completes.
+        /// \param on_done Optional callback invoked when send completes.
+        void send_to(int client_id, BufferPtr message, DoneCallback on_done = nullptr) override;
+
+        /// \brief Sends a message in a priority lane.
+        ///
+        /// The message is written ahead of the client's queued lower-priority
+        /// messages, so an urgent reply does not wait for a bulk transfer;
+        /// messages of one priority keep their order. A queued message goes
+        /// next once WriteQueueLimits::max_overtakes messages got ahead of it.
+        /// \param client_id ID of the client.
+        /// \param message Message to send.
+        /// \param priority Lane of the message.
+        /// \param on_done Optional callback invoked when send completes.
+        void send_to(int client_id, const std::string& message, SendPriority priority, DoneCallback on_done = nullptr);
+
+        /// \brief Sends a message in a priority lane without copying it.
+        void send_to(int client_id, std::string&& message, SendPriority priority, DoneCallback on_done = nullptr);
+
+        /// \brief Sends a shared payload in a priority lane.
+        void send_to(int client_id, BufferPtr message, SendPriority priority, DoneCallback on_done = nullptr);
+
+        /// \brief Sends the latest value for a key, replacing a queued one.
+        ///
+        /// A message with the same key that is still waiting in the queue is
+        /// replaced in place and its `on_done` gets NamedPipeErrc::Superseded.
+        /// Keys keep their first-enqueue order, so at most one message per
+        /// key is queued. Conflated messages are written once the client's
+        /// regular send_to() queue is empty.
+        /// \param client_id ID of the client.
+        /// \param key Conflation key, e.g. a symbol.
+        /// \param message Message to send.
+        /// \param on_done Optional callback invoked when send completes.
+        void send_conflated(int client_id, const std::string& key, const std::string& message, DoneCallback on_done = nullptr);
+
+        /// \brief Sends the latest value for a key without copying it.
+        void send_conflated(int client_id, const std::string& key, std::string&& message, DoneCallback on_done = nullptr);
+
+        /// \brief Sends the latest shared payload for a key.
+        void send_conflated(int client_id, const std::string& key, BufferPtr message, DoneCallback on_done = nullptr);
+
+        /// \brief Queues one shared payload to every connected client with a single wakeup.
+        /// \param message Payload shared by all recipients.
+        /// \param on_done Optional callback invoked once every write has finished.
+        void broadcast(BufferPtr message, MulticastCallback on_done = nullptr);
+
+        /// \brief Copies the message once and queues it to every connected client.
+        void broadcast(const std::string& message, MulticastCallback on_done = nullptr);
+
+        /// \brief Adds a client to a named group. The client leaves all groups on disconnect.
+        /// \param group Group name; the group is created on first join.
+        /// \param client_id ID of the client.
+        /// \return false if the client is not connected.
+        bool join_group(const std::string& group, int client_id);
+
+        /// \brief Removes a client from a named group.
+        /// \return true if the client was a member.
+        bool leave_group(const std::string& group, int client_id);
+
+        /// \brief Queues one shared payload to every member of a group with a single wakeup.
+        /// \param group Group name.
+        /// \param message Payload shared by all recipients.
+        /// \param on_done Optional callback invoked once every write has finished.
+        void send_to_group(const std::string& group, BufferPtr message, MulticastCallback on_done = nullptr);
+
+        /// \brief Copies the message once and queues it to every member of a group.
+        void send_to_group(const std::string& group, const std::string& message, MulticastCallback on_done = nullptr);
+
         /// \brief Closes the connection with a client.
         /// \param client_id ID of the client.
         /// \param on_done Optional callback invoked when the client is closed.
@@ -93,87 +206,437 @@ namespace SimpleNamedPipe {
         /// \return true if connected; false otherwise.
         bool is_connected(int client_id) const override;
 
+        /// \brief Returns what is queued for a client and not yet written.
+        /// \param client_id ID of the client.
+        /// \return Zero depth if the client is not connected.
+        QueueDepth get_queue_depth(int client_id) const;
+
+        /// \brief Checks whether a client exchanges messages through shared memory.
+        /// \param client_id ID of the client.
+        /// \return true once the handshake reply is written, see SharedMemoryConfig.
+        bool is_shared_memory(int client_id) const;
+
+        /// \brief Runs a function on an I/O thread after a delay.
+        ///
+        /// Timers live in a hashed wheel that the I/O loop checks between
+        /// completions, with millisecond resolution and no thread of their own.
+        /// The function runs like a callback without callback_dispatch, so it
+        /// should be short. Timers still pending when the server stops are dropped.
+        /// \param delay Minimum time before the function runs.
+        /// \param fn Function to run.
+        /// \return Id for cancel_timer(), 0 if the server is not running.
+        TimerId schedule(std::chrono::milliseconds delay, std::function<void()> fn);
+
+        /// \brief Cancels a timer that has not fired yet.
+        /// \param id Id returned by schedule() or send_after().
+        /// \return false if the timer already fired or is unknown.
+        bool cancel_timer(TimerId id);
+
+        /// \brief Sends a message to a client after a delay.
+        ///
+        /// The message goes through send_to() when the timer fires, so the
+        /// connection and the queue limits are checked then. If the timer is
+        /// cancelled or the server stops first, `on_done` gets
+        /// NamedPipeErrc::TimerCancelled.
+        /// \param client_id ID of the client.
+        /// \param delay Minimum time before the message is queued.
+        /// \param message Message to send.
+        /// \param on_done Optional callback invoked when send completes.
+        /// \return Id for cancel_timer(), 0 if the server is not running.
+        TimerId send_after(int client_id, std::chrono::milliseconds delay, std::string message, DoneCallback on_done = nullptr);
+
+        /// \brief Sends a shared payload to a client after a delay.
+        TimerId send_after(int client_id, std::chrono::milliseconds delay, BufferPtr message, DoneCallback on_done = nullptr);
+
+        /// \brief Takes a snapshot of the server and per-client counters.
+        /// \return Empty counters if MetricsConfig::enabled is off.
+        ServerMetrics get_metrics() const;
+
     private:
         // --- Internal types ---
-        enum CommandType : ULONG_PTR {
-            CMD_TYPE_SEND  = 0x10000000,
-            CMD_TYPE_CLOSE = 0x20000000,
-            CMD_TYPE_STOP  = 0x40000000,
+        using Transport = detail::Transport;
+        using IoEvent   = detail::IoEvent;
+        using Hooks     = ServerHooks<Handler>;
+
+        enum CommandType : uintptr_t {
+            CMD_TYPE_MULTICAST = 0x0,
+            CMD_TYPE_SEND  = 0x1,
+            CMD_TYPE_CLOSE = 0x2,
+            CMD_TYPE_STOP  = 0x3,
         };
 
-        static constexpr ULONG_PTR CMD_INDEX_MASK = 0x000000FF;
-        static constexpr size_t MAX_CLIENTS = 256;
+        static constexpr uintptr_t CMD_TYPE_BITS = 2;
+        static constexpr uintptr_t CMD_TYPE_MASK = 0x3;
+        /// Server-wide commands share CMD_TYPE_MULTICAST and differ in the index bits
+        static constexpr uintptr_t CMD_TIMERS = (uintptr_t(1) << CMD_TYPE_BITS) | CMD_TYPE_MULTICAST;
+        static constexpr size_t MAX_IO_EVENTS = 64;
+        static constexpr size_t RECEIVE_POOL_SIZE = 64; ///< Receive buffers kept for reuse
+
+        // Client id layout: [generation:13][slot index:18]
+        static constexpr size_t   CLIENT_INDEX_BITS = 18;
+        static constexpr size_t   CLIENT_INDEX_MASK = (size_t(1) << CLIENT_INDEX_BITS) - 1;
+        static constexpr uint32_t GENERATION_MASK   = 0x1FFF;
+
+        /// \brief Shared completion state of one broadcast or group send.
+        struct MulticastState {
+            std::mutex          mutex;
+            std::atomic<size_t> remaining{1};   ///< Queued writes plus the guard held while queuing
+            MulticastResult     result;         ///< Guarded by mutex
+            MulticastCallback   on_done;
+
+            void record(int client_id, const std::error_code& ec) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++result.recipients;
+                if (ec) result.failures.emplace_back(client_id, ec);
+                else ++result.delivered;
+            }
+
+            void release() {
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && on_done) {
+                    on_done(result);
+                }
+            }
+        };
 
+        /// \brief Queued message; written straight from `message` or `shared`.
+        ///
+        /// Built from the payload; the other fields are set by name.
         struct WriteCommand {
-            size_t client_index;
-            size_t offset;
+            int client_id = -1;
+            size_t offset = 0;
+            std::string message;    ///< Owned payload, unused when `shared` is set
+            BufferPtr shared;       ///< Shared payload
+            DoneCallback on_done;
+            std::shared_ptr<MulticastState> multicast; ///< Set for broadcast and group sends
+            std::chrono::steady_clock::time_point enqueued; ///< For the write latency histogram
+            bool is_control = false;   ///< Handshake reply or retransmission: written raw, never counted or completed
+            bool is_sequenced = false; ///< Written behind `header`, the session sequence number
+            bool is_transient = false; ///< Heartbeat: sequenced, but never kept for retransmission
+            char header[detail::SEQUENCE_SIZE] = {};
+            SendPriority priority = SendPriority::Normal; ///< Lane
+            size_t overtaken = 0;      ///< Higher-priority messages written ahead of it
+
+            WriteCommand() = default;
+
+            WriteCommand(int client_id, std::string message, DoneCallback on_done)
+                : client_id(client_id), message(std::move(message)), on_done(std::move(on_done)) {}
+
+            WriteCommand(int client_id, BufferPtr shared, DoneCallback on_done)
+                : client_id(client_id), shared(std::move(shared)), on_done(std::move(on_done)) {}
+
+            /// \brief Handshake reply or retransmission to one client.
+            template <class Payload>
+            static WriteCommand control(int client_id, Payload&& payload) {
+                WriteCommand cmd(client_id, std::forward<Payload>(payload), nullptr);
+                cmd.is_control = true;
+                return cmd;
+            }
+
+            /// \brief Sends the payload behind `sequence`; the payload itself is not copied.
+            void set_sequence(uint64_t sequence) {
+                detail::write_sequence(header, sequence);
+                is_sequenced = true;
+            }
+
+            const char* data() const { return shared ? shared->data() : message.data(); }
+            size_t size() const { return shared ? shared->size() : message.size(); }
+            size_t header_size() const { return is_sequenced ? detail::SEQUENCE_SIZE : 0; }
+            /// \brief Bytes on the wire: the sequence number, if any, and the payload.
+            size_t wire_size() const { return header_size() + size(); }
+            MessageView payload() const { return MessageView(data(), size()); }
+        };
+
+        /// \brief Resumable session, see SessionConfig.
+        ///
+        /// Used by the strand of the attached client only; detaching and
+        /// resuming hand it over under m_sessions_mutex.
+        struct Session {
+            std::string token;
+            uint64_t    next_sequence = 1;
+            detail::RetransmitRing retransmit;
+            int         client_id = -1;     ///< Attached client, or the last one while detached
+            bool        is_attached = false; ///< Guarded by m_sessions_mutex
+            uint64_t    expires_tick = 0;   ///< Timer tick at which a detached session is dropped
+            TimerId     expiry_timer = 0;
+        };
+
+        /// \brief Latest message per key in first-enqueue order.
+        struct ConflationQueue {
+            std::deque<std::string> order;
+            std::unordered_map<std::string, WriteCommand> latest;
+        };
+
+        /// \brief Message of send_after(); reports TimerCancelled if dropped unsent.
+        struct DelayedSend {
+            int client_id;
             std::string message;
+            BufferPtr shared;
             DoneCallback on_done;
+            bool is_sent;
+
+            ~DelayedSend() {
+                if (is_sent || !on_done) return;
+                // Runs while timers are dropped; a throwing callback must not end the process
+                try {
+                    on_done(make_error_code(NamedPipeErrc::TimerCancelled));
+                } catch (...) {}
+            }
+        };
+
+        struct CloseCommand {
+            int client_id;
+            DoneCallback on_done;
+        };
+
+        /// \brief All state of one client slot, kept together for locality.
+        ///
+        /// Fields without a note are touched only by the thread that currently
+        /// owns the client's strand.
+        struct ClientRecord {
+            Transport::Endpoint         endpoint;           ///< Pipe handle and OVERLAPPEDs / socket
+            std::atomic<uint32_t>       generation{0};      ///< Bumped on every disconnect
+            std::atomic<bool>           is_connected{false};
+            bool                        is_listening = false; ///< Guarded by m_clients_mutex
+            bool                        is_writing = false;
+            std::vector<char>           read_buffer;        ///< From m_receive_pool while connected
+            std::string                 message_buffer;     ///< Multi-chunk messages and string callbacks
+            size_t                      received_size = 0;  ///< Bytes of the current message read so far
+            bool                        is_streaming = false;  ///< Inside a message delivered chunk by chunk
+            bool                        is_discarding = false; ///< Skipping the rest of an oversized message
+            std::shared_ptr<Connection> connection;
+            detail::TrafficCounters     traffic;            ///< Moved to m_retired_traffic on disconnect
+            std::vector<std::string>    groups;             ///< Guarded by m_groups_mutex
+            detail::MpscQueue<WriteCommand> pending_writes; ///< Pushed by any thread, drained by the strand
+            std::atomic<size_t>         pending_write_count{0}; ///< Messages queued and not yet completed
+            std::atomic<size_t>         queued_bytes{0};        ///< Their payload bytes
+            std::atomic<bool>           is_write_blocked{false}; ///< Reached the high watermark, on_writable is due
+            bool                        is_slow = false;        ///< Above the high watermark since slow_since
+            std::chrono::steady_clock::time_point slow_since;
+            std::atomic<bool>           is_send_posted{false};  ///< A SEND packet is already on its way
+            std::deque<WriteCommand>    active_writes;
+            std::mutex                  conflation_mutex;
+            std::unique_ptr<ConflationQueue> conflation;   ///< Created on first use, guarded by conflation_mutex
+            std::atomic<size_t>         conflated_count{0}; ///< Keys waiting in `conflation`
+            size_t                      inflight_writes = 0;    ///< Commands covered by the write in flight
+            std::vector<char>           batch_buffer;           ///< Coalesced write (batching mode only)
+            bool                        is_flush_scheduled = false;
+            std::chrono::steady_clock::time_point flush_deadline;
+            detail::MpscQueue<CloseCommand> pending_closes; ///< Pushed by any thread, drained by the strand
+            std::atomic<bool>           is_close_posted{false}; ///< A CLOSE packet is already on its way
+            bool                        is_handshake_window = false; ///< No message read yet, a ring request may come
+            std::unique_ptr<detail::SharedChannel> shm;     ///< Set once accepted; pipe reads are wakeups from then on
+            std::atomic<bool>           is_shm_active{false}; ///< The reply is out, writes go to the ring
+            bool                        is_wakeup_pending = false; ///< A wakeup write is in flight
+            bool                        is_wakeup_due = false;     ///< Another one is needed after it
+            TimerId                     keep_alive_timer = 0;      ///< Idle and heartbeat check, see KeepAliveConfig
+            uint64_t                    last_read_tick = 0;        ///< Timer tick of the last read
+            uint64_t                    last_send_tick = 0;        ///< Timer tick of the last queued message
+            std::shared_ptr<Session>    session;                   ///< Opened by the client's hello, see SessionConfig
+            std::mutex                  strand_mutex;
+            std::deque<IoEvent>         strand_queue;       ///< Guarded by strand_mutex
+            bool                        strand_active = false; ///< A thread is draining strand_queue
         };
 
+        using ClientTable = detail::ClientTable<ClientRecord, 64, (size_t(1) << CLIENT_INDEX_BITS) / 64>;
+
         // --- Config ---
         ServerConfig            m_config;
         std::condition_variable m_config_cv;
         mutable std::mutex      m_config_mutex;
         bool                    m_is_config_updated = false;
 
-        // --- OS Handles ---
-        //HANDLE m_completion_port = nullptr;
-        std::atomic<HANDLE>                 m_completion_port{nullptr};
-        std::array<HANDLE, MAX_CLIENTS>     m_pipes{};
-        std::array<OVERLAPPED, MAX_CLIENTS> m_read_overlapped{};
-        std::array<OVERLAPPED, MAX_CLIENTS> m_write_overlapped{};
-
-        // --- Buffers ---
-        std::array<std::vector<char>, MAX_CLIENTS> m_read_buffers;
-        std::array<std::vector<char>, MAX_CLIENTS> m_write_buffers;
-        std::array<std::string, MAX_CLIENTS>       m_message_buffers;
-        std::array<std::shared_ptr<Connection>, MAX_CLIENTS> m_connections;
-
-        // --- Write pipeline ---
-        std::array<std::queue<WriteCommand>, MAX_CLIENTS> m_pending_writes;
-        std::array<std::queue<WriteCommand>, MAX_CLIENTS> m_active_writes;
-        std::array<std::queue<DoneCallback>, MAX_CLIENTS> m_pending_closes;
-        WriteQueueLimits                                  m_write_limits;
-
-        // --- State flags ---
-        std::array<bool, MAX_CLIENTS>              m_is_writing{};
-        std::array<std::atomic<bool>, MAX_CLIENTS> m_is_connected{};
+        // --- Transport and clients ---
+        Transport        m_transport;
+        ClientTable      m_clients;
+        std::mutex       m_clients_mutex;         ///< Guards slot allocation and listening state
+        size_t           m_listening_count = 0;   ///< Guarded by m_clients_mutex
+        size_t           m_slot_count = 0;        ///< Slots in use, listening or connected; guarded by m_clients_mutex
+        detail::BufferPool m_receive_pool{RECEIVE_POOL_SIZE};
+        size_t           m_io_threads = 1;
+        bool             m_is_batching = false;
+        bool             m_is_length_prefix = false;
+        size_t           m_batch_max_bytes = 0;
+        std::chrono::microseconds m_flush_delay{0};
+
+        // --- Live settings: set_config() changes them while the server runs ---
+        std::atomic<size_t> m_max_pending_writes{0};
+        std::atomic<size_t> m_max_message_size{0};
+        std::atomic<size_t> m_high_watermark{0};
+        std::atomic<size_t> m_low_watermark{0};
+        std::atomic<SlowConsumerPolicy> m_slow_consumer{SlowConsumerPolicy::Reject};
+        std::atomic<size_t> m_slow_consumer_timeout_ms{0};
+        std::atomic<size_t> m_max_overtakes{0};
+        std::atomic<size_t> m_buffer_size{0};      ///< Applies to clients connecting afterwards
+        std::atomic<size_t> m_max_receive_size{0};
+        std::atomic<OversizedMessagePolicy> m_oversized_policy{OversizedMessagePolicy::Disconnect};
+        std::atomic<bool>   m_is_streaming{false};
+        std::atomic<bool>   m_has_send_timers{false}; ///< Batch flushes or slow-consumer deadlines are in use
+        std::atomic<size_t> m_listen_instances{1};
+        std::atomic<size_t> m_max_clients{0};
+        std::atomic<bool>   m_is_shm_enabled{false};
+        std::atomic<size_t> m_shm_spin_us{0};
+        std::atomic<size_t> m_io_spin_us{0};
+        std::atomic<size_t> m_idle_timeout_ms{0};
+        std::atomic<size_t> m_heartbeat_interval_ms{0};
+        BufferPtr           m_heartbeat;           ///< Accessed with std::atomic_load / std::atomic_store
+        std::atomic<bool>   m_is_sessions{false};
+        std::atomic<size_t> m_retransmit_bytes{0};
+        std::atomic<size_t> m_resume_timeout_ms{0};
 
         // --- Threading ---
         std::atomic<bool>  m_is_running{false};
         std::atomic<bool>  m_is_stop_server{false};
+        std::atomic<bool>  m_is_loop_stopped{false};
         std::thread        m_server_thread;
         mutable std::mutex m_mutex;
-        std::mutex         m_write_mutex;
 
-        // --- Event handler ---
-        std::shared_ptr<ServerEventHandler> m_event_handler;
+        // --- Multicast ---
+        std::unordered_map<std::string, std::unordered_set<int>> m_groups; ///< Guarded by m_groups_mutex
+        std::mutex          m_groups_mutex;
+        std::mutex          m_multicast_mutex;
+        std::vector<size_t> m_multicast_indices;        ///< Guarded by m_multicast_mutex
+        bool                m_is_multicast_posted = false; ///< Guarded by m_multicast_mutex
+
+        // --- Deferred SEND wakeups: batch flushes and slow-consumer deadlines ---
+        struct FlushTimer {
+            std::chrono::steady_clock::time_point deadline;
+            size_t index;
+            bool operator>(const FlushTimer& other) const { return deadline > other.deadline; }
+        };
+        std::mutex m_flush_mutex;
+        std::priority_queue<FlushTimer, std::vector<FlushTimer>, std::greater<FlushTimer>> m_flush_timers; ///< Guarded by m_flush_mutex
+
+        // --- Timer wheel: schedule(), send_after() and keep-alive checks, one tick per ms ---
+        const std::chrono::steady_clock::time_point m_timer_epoch = std::chrono::steady_clock::now(); ///< Tick 0
+        std::mutex            m_timer_mutex;
+        detail::TimerWheel    m_timers;                ///< Guarded by m_timer_mutex
+        std::atomic<uint64_t> m_timer_tick{0};         ///< Refreshed after every wait while timers are pending
+        std::atomic<uint64_t> m_next_timer_tick{detail::TimerWheel::NO_TICK}; ///< Earliest tick a timer may be due
+
+        // --- Metrics ---
+        bool                  m_is_metrics = false;
+        std::chrono::milliseconds m_metrics_interval{0};
+        std::atomic<std::chrono::steady_clock::rep> m_next_metrics_report{0};
+        std::atomic<uint64_t> m_connects{0};
+        std::atomic<uint64_t> m_disconnects{0};
+        std::atomic<uint64_t> m_io_waits{0};
+        std::atomic<uint64_t> m_io_events{0};
+        mutable std::mutex    m_metrics_mutex;
+        ConnectionMetrics     m_retired_traffic;         ///< Counters of disconnected clients, guarded by m_metrics_mutex
+
+        // --- Sessions ---
+        std::mutex          m_sessions_mutex;
+        std::unordered_map<std::string, std::shared_ptr<Session>> m_sessions; ///< Guarded by m_sessions_mutex
+
+        // --- Journal ---
+        detail::JournalWriter m_journal;
+        bool                  m_is_journaling = false;
+
+        // --- Callback dispatch ---
+        static constexpr uintptr_t SERVER_LANE = ~uintptr_t(0); ///< Pool lane of events not tied to a client
+        detail::CallbackPool   m_callback_pool;
+        bool                   m_is_dispatching = false;
+        CallbackOverflowPolicy m_callback_overflow = CallbackOverflowPolicy::Block;
+        std::atomic<uint64_t>  m_dropped_callbacks{0};
 
         // --- Internal logic ---
+        static int make_client_id(size_t index, uint32_t generation);
         size_t check_client_id(int client_id) const;
-        bool check_write_limits(int client_id, const std::string& message, std::error_code& ec);
+        ClientRecord* find_client(int client_id) const;
+        int client_id_of(size_t index);
+        bool reserve_write(ClientRecord& client, size_t message_size, std::error_code& ec);
+        bool reserve_bytes(ClientRecord& client, size_t bytes, size_t message_size, std::error_code& ec);
+        static void release_write(ClientRecord& client, size_t message_size);
+        void pop_active_write(size_t index, const std::error_code& ec);
+        bool apply_slow_consumer_policy(size_t index);
+        void drop_oldest_writes(size_t index);
+        void check_writable(size_t index);
+        void schedule_send(size_t index, std::chrono::steady_clock::time_point deadline);
+        void enqueue_write(WriteCommand&& cmd);
+        void enqueue_conflated(const std::string& key, WriteCommand&& cmd);
+        bool take_conflated(size_t index);
+        static void complete_write(WriteCommand& cmd, const std::error_code& ec);
+        void multicast(const std::vector<int>& client_ids, BufferPtr message, MulticastCallback on_done);
+        void handle_multicast();
+        void leave_all_groups(size_t index, int client_id);
+        static bool requires_restart(const ServerConfig& current, const ServerConfig& next);
+        void apply_live_config(const ServerConfig& config);
         void init(const ServerConfig& config);
         void main_loop();
         void run_server_loop(const ServerConfig& config);
-        void create_pipe(size_t index, HANDLE completion_port, const ServerConfig& config);
-        bool reconnect_client(size_t index, HANDLE completion_port, OVERLAPPED* ov);
+        void run_io_worker();
+        size_t wait_io_events(IoEvent* events, size_t max_events);
+        bool handle_io_event(const IoEvent& event);
+        void dispatch_client_event(size_t index, const IoEvent& event);
+        void handle_client_event(size_t index, const IoEvent& event);
+        bool listen_new_client(std::error_code& ec);
+        bool needs_listener() const;
+        void start_read(size_t index);
+        void handle_connected(size_t index);
+        void handle_read_completion(size_t index, size_t bytes_transferred, bool more_data, const std::error_code& ec);
+        bool reject_message(size_t index, const std::error_code& ec);
+        void handle_disconnect(size_t index, const std::error_code& ec);
+        void recycle_client(size_t index);
 
-        void process_write_commands();
         void process_write_commands(size_t index);
+        void queue_write(size_t index, WriteCommand&& cmd);
+        void insert_write(size_t index, size_t position, WriteCommand&& cmd);
+        bool can_overtake(const WriteCommand& cmd, const WriteCommand& queued) const;
+        bool yield_partial_write(size_t index);
         void post_next_write(size_t index);
-        void handle_write_completion(size_t index, size_t bytes_transferred);
-        void handle_close(size_t index, HANDLE completion_port);
+        bool post_batch_write(size_t index, std::error_code& ec);
+        bool defer_batch(size_t index);
+        size_t framed_size(const WriteCommand& cmd) const;
+        int next_wait_timeout();
+        void run_due_timers();
+        uint64_t timer_tick() const;
+        TimerId add_timer(uint64_t tick, std::function<void()>&& fn);
+        void drop_timers();
+        void arm_keep_alive(size_t index, uint64_t tick);
+        void cancel_keep_alive(size_t index);
+        void handle_keep_alive(size_t index);
+        void retire_traffic(size_t index);
+        void handle_write_completion(size_t index, size_t bytes_transferred, const std::error_code& ec);
+        void fail_active_writes(size_t index, const std::error_code& reason, bool is_held = false);
+        void fail_pending_commands(size_t index, const std::error_code& reason);
+        void handle_close(size_t index);
+        void accept_shared_memory(size_t index, MessageView request);
+        void handle_shm_wakeup(size_t index);
+        bool drain_shared_memory(size_t index);
+        void post_shm_writes(size_t index);
+        void send_shm_wakeup(size_t index);
+        void reset_shared_memory(size_t index);
+        void open_session(size_t index, MessageView hello);
+        void sequence_write(size_t index, WriteCommand& cmd);
+        bool detach_session(size_t index);
+        void end_session(size_t index);
+        void expire_session(const std::string& token);
+        void insert_control(size_t index, WriteCommand&& cmd);
         void cleanup_pending_operations(const std::error_code& reason);
 
         void notify_connected(size_t index);
         void notify_disconnected(size_t index, const std::error_code& ec);
-        void notify_message(size_t index);
+        void journal_message(JournalDirection direction, int client_id, MessageView message, bool is_partial = false);
+        void notify_message(size_t index, MessageView message);
+        void notify_message_chunk(size_t index, const MessageChunk& chunk);
+        void notify_writable(size_t index);
+        void notify_session_resumed(size_t index, int previous_client_id);
+        void notify_metrics(std::shared_ptr<const ServerMetrics> metrics);
         void notify_start(const ServerConfig& config);
         void notify_stop(const ServerConfig& config);
         void notify_error(const std::error_code& ec);
+
+        bool dispatch_callback(uintptr_t lane, std::function<void()>&& task, bool is_droppable);
     };
 
+    /// \brief Server with callbacks assigned at run time.
+    using NamedPipeServer = BasicNamedPipeServer<ServerCallbacks>;
+
+#ifdef SIMPLE_NAMED_PIPE_STATIC_LIB
+    // Compiled into the static library
+    extern template class BasicNamedPipeServer<ServerCallbacks>;
+#endif
+
 }; // namespace SimpleNamedPipe
 
 /// \note Implementation is included only in header-only mode.
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_BUFFER_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_BUFFER_HPP_INCLUDED
+
+/// \file Buffer.hpp
+/// \brief Immutable message payload that can be shared between sends.
+
+#include <string>
+#include <memory>
+
+namespace SimpleNamedPipe {
+
+    /// \brief Message payload bytes.
+    using Buffer = std::string;
+
+    /// \brief Reference-counted immutable payload. The server writes straight
+    ///        from it and keeps it alive until the write completes.
+    using BufferPtr = std::shared_ptr<const Buffer>;
+
+    /// \brief Wraps a message into a shared payload without copying its bytes.
+    /// \param data Message to take over.
+    /// \return Shared payload.
+    inline BufferPtr make_buffer(Buffer&& data) {
+        return std::make_shared<const Buffer>(std::move(data));
+    }
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_BUFFER_HPP_INCLUDED
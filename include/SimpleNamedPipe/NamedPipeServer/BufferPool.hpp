@@ -0,0 +1,70 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_BUFFER_POOL_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_BUFFER_POOL_HPP_INCLUDED
+
+/// \file BufferPool.hpp
+/// \brief Free list of receive buffers shared by all client slots.
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class BufferPool
+    /// \brief Keeps receive buffers of disconnected clients for the next ones.
+    ///
+    /// Buffers keep their size while pooled, so handing one out again neither
+    /// allocates nor zero-fills it. Thread-safe.
+    class BufferPool {
+    public:
+        /// \param max_buffers Buffers kept at most; extra ones are freed.
+        explicit BufferPool(size_t max_buffers)
+            : m_max_buffers(max_buffers) {
+            m_free.reserve(max_buffers);
+        }
+
+        /// \brief Returns a buffer of exactly `size` bytes.
+        std::vector<char> acquire(size_t size) {
+            std::vector<char> buffer;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_free.empty()) {
+                    buffer.swap(m_free.back());
+                    m_free.pop_back();
+                }
+            }
+            // Drop pooled storage left over from a different buffer size
+            if (buffer.capacity() < size || buffer.capacity() > 2 * size) {
+                std::vector<char>().swap(buffer);
+            }
+            buffer.resize(size);
+            return buffer;
+        }
+
+        /// \brief Takes a buffer back.
+        void release(std::vector<char> buffer) {
+            if (buffer.empty()) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free.size() < m_max_buffers) {
+                m_free.push_back(std::move(buffer));
+            }
+        }
+
+        /// \brief Frees all pooled buffers.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.clear();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<std::vector<char>> m_free;
+        size_t m_max_buffers;
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_BUFFER_POOL_HPP_INCLUDED
@@ -0,0 +1,184 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_CALLBACK_POOL_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_CALLBACK_POOL_HPP_INCLUDED
+
+/// \file CallbackPool.hpp
+/// \brief Bounded thread pool that runs user callbacks off the I/O threads.
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <exception>
+#include <algorithm>
+#include <cstdint>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class CallbackPool
+    /// \brief Worker threads serving per-lane FIFO queues.
+    ///
+    /// Tasks of one lane (one client slot) run one at a time and in the order
+    /// they were pushed; different lanes run in parallel. A lane that has
+    /// work sits once in the ready queue, so a busy client cannot starve the
+    /// others: after each task the lane goes to the back of the line.
+    class CallbackPool {
+    public:
+        using Task = std::function<void()>;
+        using ExceptionHandler = std::function<void(std::exception_ptr)>;
+
+        /// \brief How push() treats a full queue.
+        enum class Admission {
+            Wait,   ///< Block until a worker frees room
+            Try,    ///< Fail at once
+            Force   ///< Queue beyond the capacity
+        };
+
+        CallbackPool() = default;
+        CallbackPool(const CallbackPool&) = delete;
+        CallbackPool& operator=(const CallbackPool&) = delete;
+
+        ~CallbackPool() {
+            stop();
+        }
+
+        /// \brief Starts the workers.
+        /// \param threads Number of worker threads, at least one.
+        /// \param capacity Max tasks queued over all lanes; 0 means unbounded.
+        /// \param on_exception Called on the worker when a task throws.
+        void start(size_t threads, size_t capacity, ExceptionHandler on_exception) {
+            stop();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = capacity;
+            m_on_exception = std::move(on_exception);
+            m_is_stopping = false;
+            m_is_running = true;
+            for (size_t i = 0; i < (std::max)(threads, size_t(1)); ++i) {
+                m_workers.emplace_back(&CallbackPool::run, this);
+            }
+        }
+
+        /// \brief Runs the queued tasks and joins the workers.
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_is_running) return;
+                m_is_stopping = true;
+            }
+            m_work_cv.notify_all();
+            m_room_cv.notify_all();
+            for (auto& worker : m_workers) worker.join();
+            m_workers.clear();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_running = false;
+        }
+
+        /// \brief Checks whether the workers accept tasks.
+        bool is_running() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_is_running && !m_is_stopping;
+        }
+
+        /// \brief Waits until every queued task has finished. Must not be called from a worker.
+        void drain() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle_cv.wait(lock, [this] { return (m_queued == 0 && m_busy == 0) || !m_is_running; });
+        }
+
+        /// \brief Queues a task on a lane.
+        /// \return false if the task was not queued: the queue is full under
+        ///         Admission::Try, or the pool is stopping.
+        bool push(uintptr_t lane, Task&& task, Admission admission) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_is_running || m_is_stopping) return false;
+            if (m_capacity && m_queued >= m_capacity) {
+                if (admission == Admission::Try) return false;
+                if (admission == Admission::Wait) {
+                    m_room_cv.wait(lock, [this] { return m_queued < m_capacity || m_is_stopping; });
+                    if (m_is_stopping) return false;
+                }
+            }
+
+            Lane& queue = m_lanes[lane];
+            queue.tasks.push_back(std::move(task));
+            ++m_queued;
+            if (!queue.is_scheduled) {
+                queue.is_scheduled = true;
+                m_ready.push_back(lane);
+                lock.unlock();
+                m_work_cv.notify_one();
+            }
+            return true;
+        }
+
+        /// \brief Number of queued tasks not yet started.
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_queued;
+        }
+
+    private:
+        struct Lane {
+            std::deque<Task> tasks;
+            bool is_scheduled = false;  ///< In m_ready or running on a worker
+        };
+
+        mutable std::mutex       m_mutex;
+        std::condition_variable  m_work_cv;
+        std::condition_variable  m_room_cv;
+        std::condition_variable  m_idle_cv;
+        std::unordered_map<uintptr_t, Lane> m_lanes;
+        std::deque<uintptr_t>    m_ready;        ///< Lanes with tasks and no worker
+        size_t                   m_queued = 0;
+        size_t                   m_busy = 0;     ///< Tasks running right now
+        size_t                   m_capacity = 0;
+        bool                     m_is_running = false;
+        bool                     m_is_stopping = false;
+        ExceptionHandler         m_on_exception;
+        std::vector<std::thread> m_workers;
+
+        void run() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                m_work_cv.wait(lock, [this] { return !m_ready.empty() || m_is_stopping; });
+                // Stopping workers still finish everything that was queued
+                if (m_ready.empty()) return;
+
+                const uintptr_t lane = m_ready.front();
+                m_ready.pop_front();
+                Task task = std::move(m_lanes[lane].tasks.front());
+                m_lanes[lane].tasks.pop_front();
+                --m_queued;
+                ++m_busy;
+                lock.unlock();
+                m_room_cv.notify_one();
+
+                try {
+                    task();
+                } catch (...) {
+                    if (m_on_exception) m_on_exception(std::current_exception());
+                }
+                task = nullptr;
+
+                lock.lock();
+                --m_busy;
+                auto it = m_lanes.find(lane);
+                if (it->second.tasks.empty()) {
+                    m_lanes.erase(it);
+                } else {
+                    m_ready.push_back(lane);
+                    m_work_cv.notify_one();
+                }
+                if (m_queued == 0 && m_busy == 0) m_idle_cv.notify_all();
+            }
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_CALLBACK_POOL_HPP_INCLUDED
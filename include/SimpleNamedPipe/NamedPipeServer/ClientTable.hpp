@@ -0,0 +1,106 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_CLIENT_TABLE_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_CLIENT_TABLE_HPP_INCLUDED
+
+/// \file ClientTable.hpp
+/// \brief Slab of per-client records that grows on demand.
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class ClientTable
+    /// \brief Chunked slab of records with stable addresses.
+    ///
+    /// Records are allocated in chunks of `ChunkSize` and never move, so
+    /// OVERLAPPED structures and epoll cookies stored inside them stay valid.
+    /// Chunks are freed only by the destructor, which lets other threads look
+    /// up records without locking. acquire(), release() and reset() must be
+    /// serialized by the caller.
+    template <class Record, size_t ChunkSize = 64, size_t MaxChunks = 4096>
+    class ClientTable {
+    public:
+        static constexpr size_t CAPACITY = ChunkSize * MaxChunks;
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        ClientTable() {
+            for (auto& chunk : m_chunks) {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ClientTable(const ClientTable&) = delete;
+        ClientTable& operator=(const ClientTable&) = delete;
+
+        ~ClientTable() {
+            for (auto& chunk : m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        /// \brief Looks up a record from any thread.
+        /// \return Pointer to the record or nullptr if its chunk was never allocated.
+        Record* find(size_t index) const {
+            if (index >= CAPACITY) return nullptr;
+            Record* chunk = m_chunks[index / ChunkSize].load(std::memory_order_acquire);
+            return chunk ? &chunk[index % ChunkSize] : nullptr;
+        }
+
+        /// \brief Accesses an allocated record.
+        Record& operator[](size_t index) {
+            return m_chunks[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+        }
+
+        /// \brief Number of allocated records.
+        size_t size() const {
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        /// \brief Takes a free record, allocating a new chunk when needed.
+        /// \return Index of the record or npos when the table is full.
+        size_t acquire() {
+            if (!m_free.empty()) {
+                size_t index = m_free.back();
+                m_free.pop_back();
+                return index;
+            }
+            size_t size = m_size.load(std::memory_order_relaxed);
+            if (size >= CAPACITY) return npos;
+
+            size_t chunk_index = size / ChunkSize;
+            if (!m_chunks[chunk_index].load(std::memory_order_relaxed)) {
+                m_chunks[chunk_index].store(new Record[ChunkSize], std::memory_order_release);
+            }
+            m_size.store(size + 1, std::memory_order_release);
+            return size;
+        }
+
+        /// \brief Returns a record to the free list.
+        void release(size_t index) {
+            m_free.push_back(index);
+        }
+
+        /// \brief Marks every record as free while keeping the memory.
+        void reset() {
+            m_free.clear();
+            size_t size = m_size.load(std::memory_order_relaxed);
+            m_free.reserve(size);
+            for (size_t i = size; i > 0; --i) {
+                m_free.push_back(i - 1);
+            }
+        }
+
+    private:
+        std::array<std::atomic<Record*>, MaxChunks> m_chunks;
+        std::vector<size_t> m_free;
+        std::atomic<size_t> m_size{0};
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_CLIENT_TABLE_HPP_INCLUDED
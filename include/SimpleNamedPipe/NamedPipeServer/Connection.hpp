@@ -35,6 +35,32 @@ namespace SimpleNamedPipe {
             }
         }
 
+        /// \brief Send message through this connection without copying it.
+        /// \param message Message moved into the send queue.
+        /// \param on_done Optional completion callback.
+        void send(std::string&& message, DoneCallback on_done = nullptr) const {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (is_alive()) {
+                if (m_impl) m_impl->send_to(m_client_id, std::move(message), std::move(on_done));
+            } else if (on_done) {
+                lock.unlock();
+                on_done(make_error_code(NamedPipeErrc::NotConnected));
+            }
+        }
+
+        /// \brief Send a shared payload through this connection.
+        /// \param message Payload kept alive until the write completes.
+        /// \param on_done Optional completion callback.
+        void send(BufferPtr message, DoneCallback on_done = nullptr) const {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (is_alive()) {
+                if (m_impl) m_impl->send_to(m_client_id, std::move(message), std::move(on_done));
+            } else if (on_done) {
+                lock.unlock();
+                on_done(make_error_code(NamedPipeErrc::NotConnected));
+            }
+        }
+
         /// \brief Close this connection.
         /// \param on_done Optional completion callback.
         void close(DoneCallback on_done = nullptr) const {
@@ -5,6 +5,8 @@
 /// \file IConnection.hpp
 /// \brief Interface for server-side connection operations.
 
+#include "Buffer.hpp"
+
 #include <functional>
 
 namespace SimpleNamedPipe {
@@ -21,6 +23,18 @@ namespace SimpleNamedPipe {
         /// \param on_done   Optional completion callback.
         virtual void send_to(int client_id, const std::string& message, DoneCallback on_done) = 0;
 
+        /// \brief Send a message without copying it.
+        /// \param client_id Identifier of the client.
+        /// \param message   Message moved into the send queue.
+        /// \param on_done   Optional completion callback.
+        virtual void send_to(int client_id, std::string&& message, DoneCallback on_done) = 0;
+
+        /// \brief Send a shared payload without copying it.
+        /// \param client_id Identifier of the client.
+        /// \param message   Payload kept alive until the write completes.
+        /// \param on_done   Optional completion callback.
+        virtual void send_to(int client_id, BufferPtr message, DoneCallback on_done) = 0;
+
         /// \brief Close connection with the given client.
         /// \param client_id Identifier of the client.
         /// \param on_done   Optional completion callback.
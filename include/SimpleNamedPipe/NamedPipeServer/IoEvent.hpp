@@ -0,0 +1,43 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_IO_EVENT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_IO_EVENT_HPP_INCLUDED
+
+/// \file IoEvent.hpp
+/// \brief Completion record shared by all transport backends.
+
+#include <system_error>
+#include <cstddef>
+#include <cstdint>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \brief Type of a completed transport operation.
+    enum class IoEventType {
+        Connected,    ///< A client connected to the slot
+        Read,         ///< A read operation finished
+        Write,        ///< A write operation finished (successfully or not)
+        Disconnected, ///< The client went away
+        Command,      ///< A key posted with post()
+        Timer,        ///< A client's keep-alive timer fired; never produced by a transport
+        Error         ///< Transport-level error not bound to a slot
+    };
+
+    /// \brief Completion record produced by Transport::wait().
+    struct IoEvent {
+        IoEventType     type = IoEventType::Error;
+        uintptr_t       key = 0;          ///< Slot index or posted command key
+        size_t          bytes = 0;        ///< Bytes transferred
+        bool            more_data = false;///< Read returned only a part of the message
+        std::error_code error;            ///< Operation status
+
+        IoEvent() = default;
+
+        IoEvent(IoEventType type, uintptr_t key, size_t bytes = 0, const std::error_code& ec = std::error_code())
+            : type(type), key(key), bytes(bytes), error(ec) {}
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_IO_EVENT_HPP_INCLUDED
@@ -0,0 +1,381 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_JOURNAL_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_JOURNAL_HPP_INCLUDED
+
+/// \file Journal.hpp
+/// \brief Session journal: inbound and outbound messages in memory-mapped segment files.
+///
+/// A journal is a series of files `<path>-000000.snpj`, `<path>-000001.snpj`
+/// and so on. Every file starts with a JournalFileHeader followed by records,
+/// each a JournalRecordHeader and the payload padded to 8 bytes. A record
+/// size of 0 ends the file. All integers are in host byte order, which is
+/// little-endian on every supported platform.
+
+#include "MessageView.hpp"
+#include "ServerConfig.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace SimpleNamedPipe {
+
+    /// \brief Which way a journaled message went.
+    enum class JournalDirection : uint8_t {
+        Inbound = 0,  ///< Read from a client
+        Outbound = 1  ///< Written to a client
+    };
+
+    /// \struct JournalRecord
+    /// \brief One journaled message, see JournalReader.
+    struct JournalRecord {
+        uint64_t         time_ns = 0;    ///< Wall-clock time in ns since the Unix epoch, monotonic within a server run
+        int              client_id = 0;  ///< Server-side client id
+        JournalDirection direction = JournalDirection::Inbound;
+        bool             is_partial = false; ///< A chunk of a streamed message, more follow (see ReadLimits::stream_large_messages)
+        MessageView      data;           ///< Payload, valid until the next call to JournalReader::next()
+    };
+
+namespace detail {
+
+    constexpr char     JOURNAL_MAGIC[8] = {'S', 'N', 'P', 'J', 'R', 'N', 'L', '\0'};
+    constexpr uint32_t JOURNAL_VERSION = 1;
+    constexpr uint8_t  JOURNAL_FLAG_PARTIAL = 1;
+
+    struct JournalFileHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t created_ns;   ///< Wall-clock time the file was started
+        uint64_t reserved;
+    };
+
+    struct JournalRecordHeader {
+        uint32_t record_size;  ///< Header, payload and padding; written last, so 0 ends the file
+        uint8_t  direction;
+        uint8_t  flags;
+        uint16_t reserved;
+        int32_t  client_id;
+        uint32_t size;         ///< Payload bytes
+        uint64_t time_ns;
+    };
+
+    static_assert(sizeof(JournalFileHeader) == 32, "Unexpected journal file header layout");
+    static_assert(sizeof(JournalRecordHeader) == 24, "Unexpected journal record header layout");
+
+    inline std::string journal_segment_path(const std::string& path, uint64_t index) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%06llu.snpj", static_cast<unsigned long long>(index));
+        return path + suffix;
+    }
+
+    inline size_t journal_record_size(size_t payload_size) {
+        return (sizeof(JournalRecordHeader) + payload_size + 7) & ~size_t(7);
+    }
+
+    /// \class JournalFile
+    /// \brief A file of fixed size mapped for writing.
+    class JournalFile {
+    public:
+        JournalFile() = default;
+        JournalFile(const JournalFile&) = delete;
+        JournalFile& operator=(const JournalFile&) = delete;
+
+        ~JournalFile() {
+            close(m_size);
+        }
+
+        /// \brief Creates or truncates the file and reserves `size` bytes on disk.
+        bool create(const std::string& path, size_t size, std::error_code& ec) {
+            close(m_size);
+#if defined(_WIN32)
+            m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                 CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) {
+                ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+                return false;
+            }
+            // The mapping extends the file to its size
+            const unsigned long long total = size;
+            m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+                                           static_cast<DWORD>(total >> 32), static_cast<DWORD>(total & 0xFFFFFFFF), nullptr);
+            if (m_mapping) m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+            if (!m_data) {
+                ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+                close(0);
+                return false;
+            }
+#else
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (m_fd < 0) {
+                ec = std::error_code(errno, std::system_category());
+                return false;
+            }
+            // Blocks are allocated now, so a full disk fails here and not as SIGBUS on a later store
+#if defined(__linux__)
+            int err = ::posix_fallocate(m_fd, 0, static_cast<off_t>(size));
+            if (err == EOPNOTSUPP || err == EINVAL) err = ::ftruncate(m_fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#else
+            int err = ::ftruncate(m_fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#endif
+            void* data = err ? MAP_FAILED : ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (data == MAP_FAILED) {
+                ec = std::error_code(err ? err : errno, std::system_category());
+                close(0);
+                return false;
+            }
+            m_data = static_cast<char*>(data);
+#endif
+            m_size = size;
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Unmaps the file and cuts it to the bytes actually written.
+        void close(size_t used) {
+#if defined(_WIN32)
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) {
+                LARGE_INTEGER end;
+                end.QuadPart = static_cast<LONGLONG>(used);
+                if (SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN)) SetEndOfFile(m_file);
+                CloseHandle(m_file);
+            }
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data) ::munmap(m_data, m_size);
+            if (m_fd >= 0) {
+                const int result = ::ftruncate(m_fd, static_cast<off_t>(used));
+                (void)result;
+                ::close(m_fd);
+            }
+            m_fd = -1;
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        char*  m_data = nullptr;
+        size_t m_size = 0;
+#if defined(_WIN32)
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+        int    m_fd = -1;
+#endif
+    };
+
+    /// \class JournalWriter
+    /// \brief Appends records to the mapped segment, starting a new one when it is full.
+    ///
+    /// An append is a clock read and a copy under a mutex; the only syscalls
+    /// are those that create a segment, once per JournalConfig::segment_size
+    /// bytes. Thread-safe.
+    class JournalWriter {
+    public:
+        ~JournalWriter() {
+            close_segment();
+        }
+
+        /// \brief Starts the first segment after those already on disk, so a restarted server appends.
+        bool open(const JournalConfig& config, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            close_segment();
+            m_path = config.path;
+            m_segment_size = (std::max)(config.segment_size, sizeof(JournalFileHeader) + journal_record_size(0));
+            m_index = 0;
+            while (std::ifstream(journal_segment_path(m_path, m_index)).good()) ++m_index;
+            m_steady_base = std::chrono::steady_clock::now();
+            m_wall_base_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            m_is_failed = false;
+            return start_segment(0, ec);
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            close_segment();
+        }
+
+        /// \brief Appends a record.
+        /// \param ec Set on the first failure only; the journal stays off afterwards.
+        bool append(JournalDirection direction, int client_id, bool is_partial,
+                    const char* data, size_t size, std::error_code& ec) {
+            const size_t record_size = journal_record_size(size);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_file.data()) return false;
+            if (m_used + record_size > m_file.size()) {
+                ++m_index;
+                if (!start_segment(record_size, ec)) {
+                    m_is_failed = true;
+                    return false;
+                }
+            }
+            char* out = m_file.data() + m_used;
+            JournalRecordHeader header;
+            header.record_size = 0;
+            header.direction = static_cast<uint8_t>(direction);
+            header.flags = is_partial ? JOURNAL_FLAG_PARTIAL : 0;
+            header.reserved = 0;
+            header.client_id = client_id;
+            header.size = static_cast<uint32_t>(size);
+            header.time_ns = now_ns();
+            std::memcpy(out, &header, sizeof(header));
+            if (size) std::memcpy(out + sizeof(header), data, size);
+            // Readers of a live file stop at the first record without a size
+            const uint32_t stored_size = static_cast<uint32_t>(record_size);
+            std::memcpy(out, &stored_size, sizeof(stored_size));
+            m_used += record_size;
+            return true;
+        }
+
+    private:
+        std::mutex   m_mutex;
+        JournalFile  m_file;
+        size_t       m_used = 0;
+        std::string  m_path;
+        size_t       m_segment_size = 0;
+        uint64_t     m_index = 0;
+        std::chrono::steady_clock::time_point m_steady_base;
+        uint64_t     m_wall_base_ns = 0;
+        bool         m_is_failed = false;
+
+        uint64_t now_ns() const {
+            return m_wall_base_ns + static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_steady_base).count());
+        }
+
+        void close_segment() {
+            m_file.close(m_used);
+            m_used = 0;
+        }
+
+        // A record larger than a segment gets a segment of its own size
+        bool start_segment(size_t record_size, std::error_code& ec) {
+            close_segment();
+            if (m_is_failed) return false;
+            const size_t size = (std::max)(m_segment_size, sizeof(JournalFileHeader) + record_size);
+            if (!m_file.create(journal_segment_path(m_path, m_index), size, ec)) return false;
+            JournalFileHeader header;
+            std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+            header.version = JOURNAL_VERSION;
+            header.header_size = sizeof(JournalFileHeader);
+            header.created_ns = now_ns();
+            header.reserved = 0;
+            std::memcpy(m_file.data(), &header, sizeof(header));
+            m_used = sizeof(header);
+            return true;
+        }
+    };
+
+} // namespace detail
+
+    /// \class JournalReader
+    /// \brief Reads the records of a journal written with ServerConfig::journal.
+    class JournalReader {
+    public:
+        /// \brief Opens the journal.
+        /// \param path JournalConfig::path of the server, without the segment suffix.
+        /// \return false if there is no first segment or it is not a journal.
+        bool open(const std::string& path, std::error_code& ec) {
+            m_path = path;
+            m_index = 0;
+            m_offset = 0;
+            m_data.clear();
+            m_error.clear();
+            if (!load_segment()) {
+                if (!m_error) m_error = std::make_error_code(std::errc::no_such_file_or_directory);
+                ec = m_error;
+                return false;
+            }
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Reads the next record in write order.
+        /// \return false at the end of the journal or on a damaged file, see error().
+        bool next(JournalRecord& record) {
+            for (;;) {
+                if (m_data.empty()) return false;
+                detail::JournalRecordHeader header;
+                const size_t left = m_data.size() - m_offset;
+                if (left >= sizeof(header)) std::memcpy(&header, m_data.data() + m_offset, sizeof(header));
+                if (left < sizeof(header) || header.record_size == 0) {
+                    ++m_index;
+                    if (!load_segment()) return false;
+                    continue;
+                }
+                if (header.record_size < detail::journal_record_size(header.size) || header.record_size > left) {
+                    m_error = std::make_error_code(std::errc::illegal_byte_sequence);
+                    m_data.clear();
+                    return false;
+                }
+                record.time_ns = header.time_ns;
+                record.client_id = header.client_id;
+                record.direction = static_cast<JournalDirection>(header.direction);
+                record.is_partial = (header.flags & detail::JOURNAL_FLAG_PARTIAL) != 0;
+                record.data = MessageView(m_data.data() + m_offset + sizeof(header), header.size);
+                m_offset += header.record_size;
+                return true;
+            }
+        }
+
+        /// \brief Why the last open() or next() failed; empty at a clean end.
+        const std::error_code& error() const { return m_error; }
+
+    private:
+        std::string       m_path;
+        uint64_t          m_index = 0;
+        std::vector<char> m_data;    ///< Current segment
+        size_t            m_offset = 0;
+        std::error_code   m_error;
+
+        // A missing segment ends the journal
+        bool load_segment() {
+            m_data.clear();
+            m_offset = 0;
+            std::ifstream file(detail::journal_segment_path(m_path, m_index), std::ios::binary);
+            if (!file) return false;
+            m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            detail::JournalFileHeader header;
+            std::memset(&header, 0, sizeof(header));
+            if (m_data.size() >= sizeof(header)) std::memcpy(&header, m_data.data(), sizeof(header));
+            if (std::memcmp(header.magic, detail::JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+                header.version != detail::JOURNAL_VERSION || header.header_size < sizeof(header) ||
+                header.header_size > m_data.size()) {
+                m_error = std::make_error_code(std::errc::illegal_byte_sequence);
+                m_data.clear();
+                return false;
+            }
+            m_offset = header.header_size;
+            return true;
+        }
+    };
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_JOURNAL_HPP_INCLUDED
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_MESSAGE_VIEW_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_MESSAGE_VIEW_HPP_INCLUDED
+
+/// \file MessageView.hpp
+/// \brief Non-owning view of a received message.
+
+#include "Buffer.hpp"
+
+#include <string>
+#include <cstddef>
+#include <system_error>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define SIMPLE_NAMED_PIPE_HAS_STRING_VIEW
+#endif
+
+namespace SimpleNamedPipe {
+
+    /// \class MessageView
+    /// \brief Bytes of a received message, owned by the server.
+    ///
+    /// The view points into a pooled receive buffer and is valid only until
+    /// the callback returns. Call to_string() or to_buffer() to keep the payload.
+    class MessageView {
+    public:
+        MessageView() = default;
+
+        MessageView(const char* data, size_t size)
+            : m_data(data), m_size(size) {}
+
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const char* begin() const { return m_data; }
+        const char* end() const { return m_data + m_size; }
+
+        char operator[](size_t pos) const { return m_data[pos]; }
+
+        /// \brief Copies the payload into an owned string.
+        std::string to_string() const {
+            return std::string(m_data, m_size);
+        }
+
+        /// \brief Copies the payload into a shared buffer, e.g. to forward it with send_to().
+        BufferPtr to_buffer() const {
+            return make_buffer(to_string());
+        }
+
+#ifdef SIMPLE_NAMED_PIPE_HAS_STRING_VIEW
+        operator std::string_view() const {
+            return std::string_view(m_data, m_size);
+        }
+#endif
+
+    private:
+        const char* m_data = nullptr;
+        size_t      m_size = 0;
+    };
+
+    /// \struct MessageChunk
+    /// \brief Part of a large message delivered in streaming mode.
+    ///
+    /// See ReadLimits::stream_large_messages. Every streamed message ends with
+    /// a chunk that has `last` set; if the message was cut short by the receive
+    /// limit or a disconnect, that chunk is empty and carries the reason.
+    struct MessageChunk {
+        MessageView     data;           ///< Bytes of this chunk, valid until the callback returns
+        size_t          offset = 0;     ///< Position of the chunk within the message
+        bool            first = false;  ///< The message starts with this chunk
+        bool            last = false;   ///< The message ends with this chunk
+        std::error_code error;          ///< Why the message ended early
+    };
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_MESSAGE_VIEW_HPP_INCLUDED
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_MPSC_QUEUE_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_MPSC_QUEUE_HPP_INCLUDED
+
+/// \file MpscQueue.hpp
+/// \brief Lock-free multi-producer/single-consumer queue.
+
+#include <atomic>
+#include <utility>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class MpscQueue
+    /// \brief Unbounded intrusive MPSC queue (Vyukov) with a stub node.
+    ///
+    /// push() is wait-free and may be called from any thread. pop() must be
+    /// called by one consumer at a time. pop() may report an empty queue while
+    /// a producer is between its two steps; that producer's item becomes
+    /// visible as soon as push() returns, so callers signal the consumer
+    /// after push().
+    template <class T>
+    class MpscQueue {
+    public:
+        MpscQueue()
+            : m_head(&m_stub), m_tail(&m_stub) {
+            m_stub.next.store(nullptr, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        ~MpscQueue() {
+            T value;
+            while (pop(value)) {}
+        }
+
+        /// \brief Appends an item. Thread-safe.
+        void push(T&& value) {
+            push_node(new Node(std::move(value)));
+        }
+
+        /// \brief Takes the oldest item. Single consumer only.
+        /// \return false if no completed push is available.
+        bool pop(T& value) {
+            NodeBase* tail = m_tail;
+            NodeBase* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &m_stub) {
+                if (!next) return false;
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (next) {
+                m_tail = next;
+                take(tail, value);
+                return true;
+            }
+            if (tail != m_head.load(std::memory_order_acquire)) {
+                // A producer swapped the head but has not linked its node yet
+                return false;
+            }
+            push_node(&m_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next) {
+                m_tail = next;
+                take(tail, value);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        struct NodeBase {
+            std::atomic<NodeBase*> next;
+        };
+
+        struct Node : NodeBase {
+            explicit Node(T&& v) : value(std::move(v)) {}
+            T value;
+        };
+
+        std::atomic<NodeBase*> m_head;  ///< Last pushed node, swapped by producers
+        NodeBase*              m_tail;  ///< Next node to consume
+        NodeBase               m_stub;
+
+        void push_node(NodeBase* node) {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            NodeBase* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        static void take(NodeBase* node, T& value) {
+            Node* item = static_cast<Node*>(node);
+            value = std::move(item->value);
+            delete item;
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_MPSC_QUEUE_HPP_INCLUDED
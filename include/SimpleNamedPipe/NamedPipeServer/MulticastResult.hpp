@@ -0,0 +1,28 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_MULTICAST_RESULT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_MULTICAST_RESULT_HPP_INCLUDED
+
+/// \file MulticastResult.hpp
+/// \brief Aggregate outcome of a broadcast or group send.
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <system_error>
+
+namespace SimpleNamedPipe {
+
+    /// \struct MulticastResult
+    /// \brief Outcome of one payload sent to several clients.
+    struct MulticastResult {
+        size_t recipients = 0;  ///< Clients the payload was addressed to
+        size_t delivered = 0;   ///< Writes that completed successfully
+        std::vector<std::pair<int, std::error_code>> failures; ///< Client id and reason of every failed write
+    };
+
+    /// \brief Invoked once after the payload was written to or failed for every recipient.
+    using MulticastCallback = std::function<void(const MulticastResult&)>;
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_MULTICAST_RESULT_HPP_INCLUDED
@@ -2,36 +2,39 @@
 #include "../NamedPipeServer.hpp"
 #endif
 
-#include <codecvt>
-#include <locale>
 #include <algorithm>
 
 namespace SimpleNamedPipe {
 
-    NamedPipeServer::NamedPipeServer() {
-        for (size_t i = 0; i < MAX_CLIENTS; ++i) {
-            m_pipes[i] = INVALID_HANDLE_VALUE;
-        }
-    };
+    template <class Handler>
+    BasicNamedPipeServer<Handler>::BasicNamedPipeServer() {}
 
-    NamedPipeServer::NamedPipeServer(const ServerConfig& config) {
+    template <class Handler>
+    BasicNamedPipeServer<Handler>::BasicNamedPipeServer(const ServerConfig& config) {
         set_config(config);
-    };
-
-    NamedPipeServer::~NamedPipeServer() {
-        stop();
     }
 
-    void NamedPipeServer::set_event_handler(std::shared_ptr<ServerEventHandler> handler) {
-        m_event_handler = handler;
+    template <class Handler>
+    BasicNamedPipeServer<Handler>::BasicNamedPipeServer(const ServerConfig& config, Handler handler)
+        : detail::HandlerHolder<Handler>(std::move(handler)) {
+        set_config(config);
     }
 
-    std::shared_ptr<ServerEventHandler> NamedPipeServer::get_event_handler() const {
-        return m_event_handler;
+    template <class Handler>
+    BasicNamedPipeServer<Handler>::~BasicNamedPipeServer() {
+        stop();
     }
 
-    void NamedPipeServer::set_config(const ServerConfig& config) {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::set_config(const ServerConfig& config) {
         std::unique_lock<std::mutex> lock(m_config_mutex);
+        // Without a restart pending, m_config is what the running server uses
+        if (m_is_running.load(std::memory_order_acquire) && !m_is_config_updated &&
+            !requires_restart(m_config, config)) {
+            m_config = config;
+            apply_live_config(config);
+            return;
+        }
         m_config = config;
         m_is_config_updated = true;
         lock.unlock();
@@ -39,45 +42,106 @@ namespace SimpleNamedPipe {
         m_config_cv.notify_one();
 
         if (m_is_running.load(std::memory_order_acquire)) {
-            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
-            if (completion_port) {
-                PostQueuedCompletionStatus(completion_port, 0, CMD_TYPE_STOP, nullptr);
-            }
+            m_transport.post(CMD_TYPE_STOP);
         }
     }
 
-    const ServerConfig NamedPipeServer::get_config() const {
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::requires_restart(const ServerConfig& current, const ServerConfig& next) {
+        const WriteBatching& a = current.write_batching;
+        const WriteBatching& b = next.write_batching;
+        return current.pipe_name != next.pipe_name ||
+            current.io_threads != next.io_threads ||
+            a.enabled != b.enabled || a.length_prefix != b.length_prefix ||
+            a.max_bytes != b.max_bytes || a.flush_delay_us != b.flush_delay_us ||
+            // The batch size defaults to buffer_size
+            (a.enabled && !a.max_bytes && current.buffer_size != next.buffer_size) ||
+            current.metrics.enabled != next.metrics.enabled ||
+            current.metrics.report_interval_ms != next.metrics.report_interval_ms ||
+            current.callback_dispatch.worker_threads != next.callback_dispatch.worker_threads ||
+            current.callback_dispatch.max_queued_events != next.callback_dispatch.max_queued_events ||
+            current.callback_dispatch.overflow != next.callback_dispatch.overflow ||
+            current.journal.enabled != next.journal.enabled ||
+            (next.journal.enabled && (current.journal.path != next.journal.path ||
+                                      current.journal.segment_size != next.journal.segment_size));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::apply_live_config(const ServerConfig& config) {
+        const WriteQueueLimits& limits = config.write_limits;
+        const size_t high = limits.high_watermark_bytes;
+        m_max_pending_writes.store(limits.max_pending_writes_per_client, std::memory_order_relaxed);
+        m_max_message_size.store(limits.max_message_size, std::memory_order_relaxed);
+        m_high_watermark.store(high, std::memory_order_relaxed);
+        m_low_watermark.store(limits.low_watermark_bytes ? (std::min)(limits.low_watermark_bytes, high) : high / 2,
+                              std::memory_order_relaxed);
+        m_slow_consumer.store(limits.slow_consumer, std::memory_order_relaxed);
+        m_slow_consumer_timeout_ms.store(limits.slow_consumer_timeout_ms, std::memory_order_relaxed);
+        m_max_overtakes.store(limits.max_overtakes, std::memory_order_relaxed);
+        m_has_send_timers.store((config.write_batching.enabled && config.write_batching.flush_delay_us > 0) ||
+                                (high && limits.slow_consumer == SlowConsumerPolicy::Disconnect),
+                                std::memory_order_relaxed);
+        m_buffer_size.store(config.buffer_size, std::memory_order_relaxed);
+        m_max_receive_size.store(config.read_limits.max_message_size, std::memory_order_relaxed);
+        m_oversized_policy.store(config.read_limits.oversized, std::memory_order_relaxed);
+        m_is_streaming.store(config.read_limits.stream_large_messages, std::memory_order_relaxed);
+        m_listen_instances.store((std::max)(config.listen_instances, size_t(1)), std::memory_order_relaxed);
+        m_max_clients.store(config.max_clients, std::memory_order_relaxed);
+        m_is_shm_enabled.store(config.shared_memory.enabled, std::memory_order_relaxed);
+        m_shm_spin_us.store(config.shared_memory.spin_us, std::memory_order_relaxed);
+        m_io_spin_us.store(config.io_spin_us, std::memory_order_relaxed);
+        const KeepAliveConfig& keep_alive = config.keep_alive;
+        m_idle_timeout_ms.store(keep_alive.idle_timeout_ms, std::memory_order_relaxed);
+        m_heartbeat_interval_ms.store(keep_alive.heartbeat_message.empty() ? 0 : keep_alive.heartbeat_interval_ms,
+                                      std::memory_order_relaxed);
+        std::atomic_store(&m_heartbeat, std::make_shared<const Buffer>(keep_alive.heartbeat_message));
+        m_is_sessions.store(config.sessions.enabled, std::memory_order_relaxed);
+        m_retransmit_bytes.store(config.sessions.retransmit_bytes, std::memory_order_relaxed);
+        m_resume_timeout_ms.store(config.sessions.resume_timeout_ms, std::memory_order_relaxed);
+        m_transport.reconfigure(config);
+    }
+
+    template <class Handler>
+    const ServerConfig BasicNamedPipeServer<Handler>::get_config() const {
         std::lock_guard<std::mutex> lock(m_config_mutex);
         return m_config;
     }
 
-    void NamedPipeServer::start(bool run_async) {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::start(bool run_async) {
         std::lock_guard<std::mutex> lock(m_mutex);
         if (m_server_thread.joinable()) {
-            m_is_stop_server = true;
+            {
+                std::lock_guard<std::mutex> config_lock(m_config_mutex);
+                m_is_stop_server = true;
+            }
+            m_config_cv.notify_one();
 
-            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
-            if (m_is_running.load(std::memory_order_acquire) && completion_port) {
-                PostQueuedCompletionStatus(completion_port, 0, CMD_TYPE_STOP, nullptr);
+            if (m_is_running.load(std::memory_order_acquire)) {
+                m_transport.post(CMD_TYPE_STOP);
             }
             m_server_thread.join();
         }
         m_is_stop_server = false;
         if (run_async) {
-            m_server_thread = std::thread(&NamedPipeServer::main_loop, this);
+            m_server_thread = std::thread(&BasicNamedPipeServer::main_loop, this);
         } else {
             main_loop();
         }
     }
 
-    void NamedPipeServer::stop() {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::stop() {
         std::lock_guard<std::mutex> lock(m_mutex);
         if (m_is_stop_server) return;
-        m_is_stop_server = true;
+        {
+            std::lock_guard<std::mutex> config_lock(m_config_mutex);
+            m_is_stop_server = true;
+        }
+        m_config_cv.notify_one();
 
-        HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
-        if (m_is_running.load(std::memory_order_acquire) && completion_port) {
-            PostQueuedCompletionStatus(completion_port, 0, CMD_TYPE_STOP, nullptr);
+        if (m_is_running.load(std::memory_order_acquire)) {
+            m_transport.post(CMD_TYPE_STOP);
         }
 
         if (m_server_thread.joinable()) {
@@ -85,128 +149,554 @@ namespace SimpleNamedPipe {
         }
     }
 
-    bool NamedPipeServer::is_running() const {
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::is_running() const {
         return m_is_running.load(std::memory_order_acquire);
     }
 
-    void NamedPipeServer::send_to(int client_id, const std::string& message, DoneCallback on_done) {
-        HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, const std::string& message, DoneCallback on_done) {
+        send_to(client_id, message, SendPriority::Normal, std::move(on_done));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, std::string&& message, DoneCallback on_done) {
+        send_to(client_id, std::move(message), SendPriority::Normal, std::move(on_done));
+    }
 
-        if (!m_is_running.load(std::memory_order_acquire) || !completion_port) {
-            if (on_done) on_done(make_error_code(NamedPipeErrc::ServerStopped));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, BufferPtr message, DoneCallback on_done) {
+        send_to(client_id, std::move(message), SendPriority::Normal, std::move(on_done));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, const std::string& message, SendPriority priority, DoneCallback on_done) {
+        WriteCommand cmd(client_id, message, std::move(on_done));
+        cmd.priority = priority;
+        enqueue_write(std::move(cmd));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, std::string&& message, SendPriority priority, DoneCallback on_done) {
+        WriteCommand cmd(client_id, std::move(message), std::move(on_done));
+        cmd.priority = priority;
+        enqueue_write(std::move(cmd));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to(int client_id, BufferPtr message, SendPriority priority, DoneCallback on_done) {
+        if (!message) {
+            message = std::make_shared<const Buffer>();
+        }
+        WriteCommand cmd(client_id, std::move(message), std::move(on_done));
+        cmd.priority = priority;
+        enqueue_write(std::move(cmd));
+    }
+
+    template <class Handler>
+    TimerId BasicNamedPipeServer<Handler>::schedule(std::chrono::milliseconds delay, std::function<void()> fn) {
+        if (!fn || !m_is_running.load(std::memory_order_acquire)) return 0;
+        // One tick more, so a timer started late in a tick still waits the whole delay
+        const uint64_t ticks = delay.count() > 0 ? static_cast<uint64_t>(delay.count()) + 1 : 0;
+        return add_timer(timer_tick() + ticks, std::move(fn));
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::cancel_timer(TimerId id) {
+        std::function<void()> fn;
+        {
+            std::lock_guard<std::mutex> lock(m_timer_mutex);
+            fn = m_timers.cancel(id);
+            m_next_timer_tick.store(m_timers.next_tick(), std::memory_order_relaxed);
+        }
+        // Destroyed outside the lock: a send_after() reports TimerCancelled from here
+        return static_cast<bool>(fn);
+    }
+
+    template <class Handler>
+    TimerId BasicNamedPipeServer<Handler>::send_after(int client_id, std::chrono::milliseconds delay, std::string message, DoneCallback on_done) {
+        auto pending = std::make_shared<DelayedSend>();
+        pending->client_id = client_id;
+        pending->message = std::move(message);
+        pending->on_done = std::move(on_done);
+        pending->is_sent = false;
+        TimerId id = schedule(delay, [this, pending] {
+            pending->is_sent = true;
+            send_to(pending->client_id, std::move(pending->message), std::move(pending->on_done));
+        });
+        if (!id && pending->on_done) {
+            pending->is_sent = true;
+            pending->on_done(make_error_code(NamedPipeErrc::ServerStopped));
+        }
+        return id;
+    }
+
+    template <class Handler>
+    TimerId BasicNamedPipeServer<Handler>::send_after(int client_id, std::chrono::milliseconds delay, BufferPtr message, DoneCallback on_done) {
+        auto pending = std::make_shared<DelayedSend>();
+        pending->client_id = client_id;
+        pending->shared = std::move(message);
+        pending->on_done = std::move(on_done);
+        pending->is_sent = false;
+        TimerId id = schedule(delay, [this, pending] {
+            pending->is_sent = true;
+            send_to(pending->client_id, std::move(pending->shared), std::move(pending->on_done));
+        });
+        if (!id && pending->on_done) {
+            pending->is_sent = true;
+            pending->on_done(make_error_code(NamedPipeErrc::ServerStopped));
+        }
+        return id;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::enqueue_write(WriteCommand&& cmd) {
+        if (!m_is_running.load(std::memory_order_acquire) || !m_transport.is_open()) {
+            complete_write(cmd, make_error_code(NamedPipeErrc::ServerStopped));
             return;
         }
 
         std::error_code ec;
-        size_t index = check_client_id(client_id);
+        size_t index = check_client_id(cmd.client_id);
 
-        std::unique_lock<std::mutex> lock(m_write_mutex);
-        if (!check_write_limits(client_id, message, ec)) {
-            if (on_done) on_done(ec);
+        ClientRecord* client = find_client(cmd.client_id);
+        if (!client) {
+            complete_write(cmd, make_error_code(NamedPipeErrc::NotConnected));
             return;
         }
-        m_pending_writes[index].push({index, 0, message, std::move(on_done)});
-        lock.unlock();
+        if (!reserve_write(*client, cmd.size(), ec)) {
+            complete_write(cmd, ec);
+            return;
+        }
+        if (m_is_metrics) cmd.enqueued = std::chrono::steady_clock::now();
+        client->pending_writes.push(std::move(cmd));
 
-        PostQueuedCompletionStatus(completion_port, 0, CMD_TYPE_SEND | (index & CMD_INDEX_MASK), nullptr);
+        // One packet per burst: the strand clears the flag before draining
+        if (!client->is_send_posted.exchange(true, std::memory_order_acq_rel)) {
+            m_transport.post((static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_SEND);
+        }
     }
 
-    void NamedPipeServer::close(int client_id, DoneCallback on_done) {
-        HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_conflated(int client_id, const std::string& key, const std::string& message, DoneCallback on_done) {
+        enqueue_conflated(key, WriteCommand(client_id, message, std::move(on_done)));
+    }
 
-        if (!m_is_running.load(std::memory_order_acquire) || !completion_port) {
-            if (on_done) on_done(make_error_code(NamedPipeErrc::ServerStopped));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_conflated(int client_id, const std::string& key, std::string&& message, DoneCallback on_done) {
+        enqueue_conflated(key, WriteCommand(client_id, std::move(message), std::move(on_done)));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_conflated(int client_id, const std::string& key, BufferPtr message, DoneCallback on_done) {
+        if (!message) {
+            message = std::make_shared<const Buffer>();
+        }
+        enqueue_conflated(key, WriteCommand(client_id, std::move(message), std::move(on_done)));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::enqueue_conflated(const std::string& key, WriteCommand&& cmd) {
+        if (!m_is_running.load(std::memory_order_acquire) || !m_transport.is_open()) {
+            complete_write(cmd, make_error_code(NamedPipeErrc::ServerStopped));
             return;
         }
 
-        size_t index = check_client_id(client_id);
+        std::error_code ec;
+        size_t index = check_client_id(cmd.client_id);
+
+        ClientRecord* client = find_client(cmd.client_id);
+        if (!client) {
+            complete_write(cmd, make_error_code(NamedPipeErrc::NotConnected));
+            return;
+        }
+        if (cmd.size() > m_max_message_size.load(std::memory_order_relaxed)) {
+            if (m_is_metrics) client->traffic.rejected_writes.fetch_add(1, std::memory_order_relaxed);
+            complete_write(cmd, make_error_code(NamedPipeErrc::MessageTooLarge));
+            return;
+        }
+        if (m_is_metrics) cmd.enqueued = std::chrono::steady_clock::now();
+
+        WriteCommand replaced;
+        bool is_replaced = false;
+        bool is_grown = false;
+        {
+            std::lock_guard<std::mutex> lock(client->conflation_mutex);
+            if (!client->conflation) client->conflation.reset(new ConflationQueue());
+            ConflationQueue& queue = *client->conflation;
+            auto it = queue.latest.find(key);
+            if (it != queue.latest.end()) {
+                // The key keeps its place in the queue, only the payload changes;
+                // a larger one passes the watermark like a new message
+                const size_t old_size = it->second.size();
+                if (cmd.size() <= old_size) {
+                    client->queued_bytes.fetch_sub(old_size - cmd.size(), std::memory_order_acq_rel);
+                } else if (reserve_bytes(*client, cmd.size() - old_size, cmd.size(), ec)) {
+                    is_grown = true;
+                } else {
+                    // The queued payload stays
+                    replaced = std::move(cmd);
+                }
+                if (!ec) {
+                    replaced = std::move(it->second);
+                    it->second = std::move(cmd);
+                }
+                is_replaced = true;
+            } else if (reserve_write(*client, cmd.size(), ec)) {
+                queue.order.push_back(key);
+                queue.latest.emplace(key, std::move(cmd));
+                client->conflated_count.fetch_add(1, std::memory_order_acq_rel);
+            }
+        }
+        if (is_replaced) {
+            if (ec) {
+                complete_write(replaced, ec);
+                return;
+            }
+            if (m_is_metrics) client->traffic.superseded_writes.fetch_add(1, std::memory_order_relaxed);
+            complete_write(replaced, make_error_code(NamedPipeErrc::Superseded));
+            // The key is already queued, so a SEND is on its way or a write is in flight;
+            // the strand still has to see a crossed watermark to apply the policy
+            if (is_grown && !client->is_send_posted.exchange(true, std::memory_order_acq_rel)) {
+                m_transport.post((static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_SEND);
+            }
+            return;
+        }
+        if (ec) {
+            complete_write(cmd, ec);
+            return;
+        }
+
+        if (!client->is_send_posted.exchange(true, std::memory_order_acq_rel)) {
+            m_transport.post((static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_SEND);
+        }
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::take_conflated(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (client.conflated_count.load(std::memory_order_acquire) == 0) return false;
+
+        std::lock_guard<std::mutex> lock(client.conflation_mutex);
+        if (!client.conflation || client.conflation->order.empty()) return false;
+        ConflationQueue& queue = *client.conflation;
+
+        // Take one message, or enough to fill a batch; the rest stays replaceable
+        size_t bytes = 0;
+        do {
+            auto it = queue.latest.find(queue.order.front());
+            bytes += framed_size(it->second);
+            client.active_writes.push_back(std::move(it->second));
+            queue.latest.erase(it);
+            queue.order.pop_front();
+            client.conflated_count.fetch_sub(1, std::memory_order_acq_rel);
+        } while (m_is_batching && bytes < m_batch_max_bytes && !queue.order.empty());
+        return true;
+    }
 
-        std::unique_lock<std::mutex> lock(m_write_mutex);
-        m_pending_closes[index].push(std::move(on_done));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::complete_write(WriteCommand& cmd, const std::error_code& ec) {
+        if (cmd.on_done) cmd.on_done(ec);
+        if (cmd.multicast) {
+            cmd.multicast->record(cmd.client_id, ec);
+            cmd.multicast->release();
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::broadcast(BufferPtr message, MulticastCallback on_done) {
+        std::vector<int> client_ids;
+        const size_t size = m_clients.size();
+        for (size_t i = 0; i < size; ++i) {
+            ClientRecord* client = m_clients.find(i);
+            if (client && client->is_connected.load(std::memory_order_acquire)) {
+                client_ids.push_back(make_client_id(i, client->generation.load(std::memory_order_acquire)));
+            }
+        }
+        multicast(client_ids, std::move(message), std::move(on_done));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::broadcast(const std::string& message, MulticastCallback on_done) {
+        broadcast(make_buffer(std::string(message)), std::move(on_done));
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::join_group(const std::string& group, int client_id) {
+        std::lock_guard<std::mutex> lock(m_groups_mutex);
+        ClientRecord* client = find_client(client_id);
+        if (!client || !client->is_connected.load(std::memory_order_acquire)) return false;
+        if (m_groups[group].insert(client_id).second) {
+            client->groups.push_back(group);
+        }
+        return true;
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::leave_group(const std::string& group, int client_id) {
+        std::lock_guard<std::mutex> lock(m_groups_mutex);
+        auto it = m_groups.find(group);
+        if (it == m_groups.end() || it->second.erase(client_id) == 0) return false;
+        if (it->second.empty()) m_groups.erase(it);
+
+        ClientRecord* client = find_client(client_id);
+        if (client) {
+            auto name = std::find(client->groups.begin(), client->groups.end(), group);
+            if (name != client->groups.end()) client->groups.erase(name);
+        }
+        return true;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to_group(const std::string& group, BufferPtr message, MulticastCallback on_done) {
+        std::vector<int> client_ids;
+        {
+            std::lock_guard<std::mutex> lock(m_groups_mutex);
+            auto it = m_groups.find(group);
+            if (it != m_groups.end()) {
+                client_ids.assign(it->second.begin(), it->second.end());
+            }
+        }
+        multicast(client_ids, std::move(message), std::move(on_done));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_to_group(const std::string& group, const std::string& message, MulticastCallback on_done) {
+        send_to_group(group, make_buffer(std::string(message)), std::move(on_done));
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::multicast(const std::vector<int>& client_ids, BufferPtr message, MulticastCallback on_done) {
+        if (!message) {
+            message = std::make_shared<const Buffer>();
+        }
+        auto state = std::make_shared<MulticastState>();
+        state->on_done = std::move(on_done);
+
+        if (!m_is_running.load(std::memory_order_acquire) || !m_transport.is_open()) {
+            for (int client_id : client_ids) {
+                state->record(client_id, make_error_code(NamedPipeErrc::ServerStopped));
+            }
+            state->release();
+            return;
+        }
+
+        // Every recipient gets a pointer to the same payload; all queues are
+        // filled under one lock and the I/O loop is woken once
+        bool is_post = false;
+        const auto enqueued = m_is_metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        std::unique_lock<std::mutex> lock(m_multicast_mutex);
+        for (int client_id : client_ids) {
+            ClientRecord* client = client_id < 0 ? nullptr : find_client(client_id);
+            std::error_code ec;
+            if (!client) {
+                state->record(client_id, make_error_code(NamedPipeErrc::NotConnected));
+                continue;
+            }
+            if (!reserve_write(*client, message->size(), ec)) {
+                state->record(client_id, ec);
+                continue;
+            }
+            state->remaining.fetch_add(1, std::memory_order_relaxed);
+            WriteCommand cmd(client_id, message, nullptr);
+            cmd.multicast = state;
+            cmd.enqueued = enqueued;
+            client->pending_writes.push(std::move(cmd));
+            m_multicast_indices.push_back(static_cast<size_t>(client_id) & CLIENT_INDEX_MASK);
+        }
+        if (!m_multicast_indices.empty() && !m_is_multicast_posted) {
+            m_is_multicast_posted = true;
+            is_post = true;
+        }
         lock.unlock();
 
-        PostQueuedCompletionStatus(completion_port, 0, CMD_TYPE_CLOSE | (index & CMD_INDEX_MASK), nullptr);
+        if (is_post) {
+            m_transport.post(CMD_TYPE_MULTICAST);
+        }
+        state->release();
     }
 
-    bool NamedPipeServer::is_connected(int client_id) const {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::close(int client_id, DoneCallback on_done) {
+        if (!m_is_running.load(std::memory_order_acquire) || !m_transport.is_open()) {
+            if (on_done) on_done(make_error_code(NamedPipeErrc::ServerStopped));
+            return;
+        }
+
         size_t index = check_client_id(client_id);
-        return m_is_connected[index].load(std::memory_order_acquire);
+
+        ClientRecord* client = find_client(client_id);
+        if (!client) {
+            if (on_done) on_done(make_error_code(NamedPipeErrc::NotConnected));
+            return;
+        }
+        client->pending_closes.push({client_id, std::move(on_done)});
+
+        if (!client->is_close_posted.exchange(true, std::memory_order_acq_rel)) {
+            m_transport.post((static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_CLOSE);
+        }
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::is_connected(int client_id) const {
+        ClientRecord* client = find_client(client_id);
+        return client && client->is_connected.load(std::memory_order_acquire);
     }
 
-    size_t NamedPipeServer::check_client_id(int client_id) const {
-        if (client_id < 0 || static_cast<size_t>(client_id) >= MAX_CLIENTS) {
+    template <class Handler>
+    QueueDepth BasicNamedPipeServer<Handler>::get_queue_depth(int client_id) const {
+        QueueDepth depth;
+        ClientRecord* client = find_client(client_id);
+        if (!client || !client->is_connected.load(std::memory_order_acquire)) return depth;
+        depth.messages = client->pending_write_count.load(std::memory_order_relaxed);
+        depth.bytes = client->queued_bytes.load(std::memory_order_relaxed);
+        return depth;
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::is_shared_memory(int client_id) const {
+        ClientRecord* client = find_client(client_id);
+        return client && client->is_connected.load(std::memory_order_acquire) &&
+            client->is_shm_active.load(std::memory_order_acquire);
+    }
+
+    template <class Handler>
+    int BasicNamedPipeServer<Handler>::make_client_id(size_t index, uint32_t generation) {
+        return static_cast<int>((static_cast<size_t>(generation & GENERATION_MASK) << CLIENT_INDEX_BITS) | index);
+    }
+
+    template <class Handler>
+    size_t BasicNamedPipeServer<Handler>::check_client_id(int client_id) const {
+        if (client_id < 0) {
             throw std::out_of_range("client_id is out of range");
         }
-        return static_cast<size_t>(client_id);
+        return static_cast<size_t>(client_id) & CLIENT_INDEX_MASK;
+    }
+
+    template <class Handler>
+    typename BasicNamedPipeServer<Handler>::ClientRecord* BasicNamedPipeServer<Handler>::find_client(int client_id) const {
+        size_t index = check_client_id(client_id);
+        ClientRecord* client = m_clients.find(index);
+        if (!client) return nullptr;
+        uint32_t generation = client->generation.load(std::memory_order_acquire);
+        if (make_client_id(index, generation) != client_id) return nullptr;
+        return client;
+    }
+
+    template <class Handler>
+    int BasicNamedPipeServer<Handler>::client_id_of(size_t index) {
+        return make_client_id(index, m_clients[index].generation.load(std::memory_order_relaxed));
     }
 
-    bool NamedPipeServer::check_write_limits(int client_id, const std::string& message, std::error_code& ec) {
-        if (message.size() > m_write_limits.max_message_size) {
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::reserve_write(ClientRecord& client, size_t message_size, std::error_code& ec) {
+        if (message_size > m_max_message_size.load(std::memory_order_relaxed)) {
+            if (m_is_metrics) client.traffic.rejected_writes.fetch_add(1, std::memory_order_relaxed);
             ec = make_error_code(NamedPipeErrc::MessageTooLarge);
             return false;
         }
 
-        size_t index = check_client_id(client_id);
-
-        if (m_pending_writes[index].size() >= m_write_limits.max_pending_writes_per_client) {
+        if (client.pending_write_count.fetch_add(1, std::memory_order_relaxed) >= m_max_pending_writes.load(std::memory_order_relaxed)) {
+            client.pending_write_count.fetch_sub(1, std::memory_order_relaxed);
+            if (m_is_metrics) client.traffic.rejected_writes.fetch_add(1, std::memory_order_relaxed);
             ec = make_error_code(NamedPipeErrc::QueueFull);
             return false;
         }
 
-        ec.clear();
+        if (!reserve_bytes(client, message_size, message_size, ec)) {
+            client.pending_write_count.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
         return true;
     }
 
-    void NamedPipeServer::init(const ServerConfig& config) {
-        m_write_limits = config.write_limits;
-
-        HANDLE completion_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 0);
-        if (!completion_port) {
-            throw std::system_error(GetLastError(), std::system_category(), "Failed to create IO completion port");
+    // Adds `bytes` of a message of `message_size` to the queued bytes, subject
+    // to the high watermark
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::reserve_bytes(ClientRecord& client, size_t bytes, size_t message_size, std::error_code& ec) {
+        const size_t queued = client.queued_bytes.fetch_add(bytes, std::memory_order_acq_rel) + bytes;
+        const size_t high = m_high_watermark.load(std::memory_order_relaxed);
+        if (high && queued >= high) {
+            client.is_write_blocked.store(true, std::memory_order_release);
+            // A message larger than the watermark still passes an empty queue
+            if (m_slow_consumer.load(std::memory_order_relaxed) == SlowConsumerPolicy::Reject &&
+                queued > high && queued > message_size) {
+                client.queued_bytes.fetch_sub(bytes, std::memory_order_acq_rel);
+                // Let the strand re-check the watermark in case the queue
+                // drained before the flag was set
+                if (!client.is_send_posted.exchange(true, std::memory_order_acq_rel)) {
+                    m_transport.post((static_cast<uintptr_t>(client.endpoint.slot) << CMD_TYPE_BITS) | CMD_TYPE_SEND);
+                }
+                if (m_is_metrics) client.traffic.rejected_writes.fetch_add(1, std::memory_order_relaxed);
+                ec = make_error_code(NamedPipeErrc::QueueFull);
+                return false;
+            }
         }
-        m_completion_port.store(completion_port, std::memory_order_release);
 
-        for (size_t i = 0; i < MAX_CLIENTS; ++i) {
-            m_read_buffers[i].resize(config.buffer_size);
-            m_write_buffers[i].resize(config.buffer_size);
-            m_read_overlapped[i] = {};
-            m_write_overlapped[i] = {};
-            m_is_writing[i] = false;
-            m_is_connected[i] = false;
-            create_pipe(i, completion_port, config);
-        }
+        ec.clear();
+        return true;
     }
 
-    void NamedPipeServer::create_pipe(size_t index, HANDLE completion_port, const ServerConfig& config) {
-        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> conv;
-        std::wstring pipe_name_w = L"\\\\.\\pipe\\" + conv.from_bytes(config.pipe_name);
-
-        m_pipes[index] = CreateNamedPipeW(
-            pipe_name_w.c_str(),
-            PIPE_ACCESS_DUPLEX |
-            FILE_FLAG_OVERLAPPED,
-            PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
-            PIPE_UNLIMITED_INSTANCES,
-            static_cast<DWORD>(config.buffer_size),
-            static_cast<DWORD>(config.buffer_size),
-            static_cast<DWORD>(config.timeout),
-            nullptr
-        );
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::release_write(ClientRecord& client, size_t message_size) {
+        client.pending_write_count.fetch_sub(1, std::memory_order_relaxed);
+        client.queued_bytes.fetch_sub(message_size, std::memory_order_acq_rel);
+    }
 
-        if (m_pipes[index] == INVALID_HANDLE_VALUE) {
-            throw std::system_error(GetLastError(), std::system_category(), "Failed to create named pipe.");
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::init(const ServerConfig& config) {
+        m_io_threads = (std::max)(config.io_threads, size_t(1));
+        m_is_batching = config.write_batching.enabled;
+        m_is_length_prefix = m_is_batching && config.write_batching.length_prefix;
+        m_batch_max_bytes = config.write_batching.max_bytes ? config.write_batching.max_bytes : config.buffer_size;
+        m_flush_delay = std::chrono::microseconds(m_is_batching ? config.write_batching.flush_delay_us : 0);
+        m_is_metrics = config.metrics.enabled;
+        m_metrics_interval = std::chrono::milliseconds(m_is_metrics ? config.metrics.report_interval_ms : 0);
+        m_next_metrics_report = (std::chrono::steady_clock::now() + m_metrics_interval).time_since_epoch().count();
+        m_connects = 0;
+        m_disconnects = 0;
+        m_io_waits = 0;
+        m_io_events = 0;
+        m_dropped_callbacks = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_metrics_mutex);
+            m_retired_traffic = ConnectionMetrics();
         }
-
-        if (!CreateIoCompletionPort(m_pipes[index], completion_port, static_cast<ULONG_PTR>(index), 0)) {
-            throw std::system_error(GetLastError(), std::system_category(), "Failed to associate pipe with Completion Port.");
+        m_listening_count = 0;
+        m_slot_count = 0;
+        m_is_loop_stopped = false;
+        m_callback_overflow = config.callback_dispatch.overflow;
+        m_is_dispatching = config.callback_dispatch.worker_threads > 0;
+        if (m_is_dispatching) {
+            m_callback_pool.start(config.callback_dispatch.worker_threads, config.callback_dispatch.max_queued_events,
+                [this](std::exception_ptr) {
+                    // A throwing callback must not take a worker down; on_error itself may throw too
+                    try {
+                        Hooks::error(this->handler(), make_error_code(NamedPipeErrc::UnhandledException));
+                    } catch (...) {}
+                });
+        }
+        m_is_journaling = config.journal.enabled;
+        if (m_is_journaling) {
+            std::error_code ec;
+            if (!m_journal.open(config.journal, ec)) {
+                m_is_journaling = false;
+                throw std::system_error(ec, "Failed to open the journal.");
+            }
         }
+        m_transport.open(config);
 
-        if (!reconnect_client(index, completion_port, &m_read_overlapped[index])) {
-            throw std::system_error(GetLastError(), std::system_category(), "Failed to post completion status.");
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        while (needs_listener()) {
+            std::error_code ec;
+            if (!listen_new_client(ec)) {
+                throw std::system_error(ec, "Failed to create named pipe.");
+            }
         }
     }
 
-    void NamedPipeServer::main_loop() {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::main_loop() {
         while (!m_is_stop_server) {
             std::unique_lock<std::mutex> lock(m_config_mutex);
             m_config_cv.wait(lock, [this] {
@@ -217,6 +707,7 @@ namespace SimpleNamedPipe {
 
             m_is_config_updated = false;
             auto config = m_config;
+            apply_live_config(config);
             lock.unlock();
 
             try {
@@ -234,320 +725,1601 @@ namespace SimpleNamedPipe {
             }
 
             cleanup_pending_operations(make_error_code(NamedPipeErrc::ServerStopped));
+            {
+                // Sessions do not outlive the server
+                std::lock_guard<std::mutex> sessions_lock(m_sessions_mutex);
+                m_sessions.clear();
+            }
+            drop_timers();
+            m_transport.close();
+            m_journal.close();
+            m_is_journaling = false;
+            // Runs the disconnect callbacks queued by the cleanup
+            m_callback_pool.stop();
+            m_is_dispatching = false;
+
+            for (size_t i = 0; i < m_clients.size(); ++i) {
+                ClientRecord& client = m_clients[i];
+                client.endpoint.reset();
+                client.endpoint.slot = i;
+                client.is_listening = false;
+                client.strand_queue.clear();
+                client.strand_active = false;
+                client.is_send_posted = false;
+                client.is_close_posted = false;
+            }
+            m_clients.reset();
+            m_listening_count = 0;
+            m_slot_count = 0;
+            m_multicast_indices.clear();
+            m_is_multicast_posted = false;
+            std::lock_guard<std::mutex> flush_lock(m_flush_mutex);
+            m_flush_timers = decltype(m_flush_timers)();
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::run_server_loop(const ServerConfig& config) {
+        notify_start(config);
 
-            for (size_t i = 0; i < MAX_CLIENTS; ++i) {
-                if (m_pipes[i] != nullptr &&
-                    m_pipes[i] != INVALID_HANDLE_VALUE) {
-                    CancelIoEx(m_pipes[i], nullptr);
-                    DisconnectNamedPipe(m_pipes[i]);
-                    CloseHandle(m_pipes[i]);
-                    m_pipes[i] = INVALID_HANDLE_VALUE;
+        std::vector<std::thread> workers;
+        try {
+            for (size_t i = 1; i < m_io_threads; ++i) {
+                workers.emplace_back(&BasicNamedPipeServer::run_io_worker, this);
+            }
+        } catch (...) {
+            m_is_loop_stopped = true;
+            m_transport.post(CMD_TYPE_STOP);
+            for (auto& worker : workers) worker.join();
+            throw;
+        }
+
+        run_io_worker();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        notify_stop(config);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::run_io_worker() {
+        std::array<IoEvent, MAX_IO_EVENTS> events;
+        // With several workers take one completion at a time, like
+        // GetQueuedCompletionStatus, so idle threads pick up the rest
+        const size_t batch = m_io_threads > 1 ? 1 : events.size();
+        try {
+            while (!m_is_stop_server && !m_is_loop_stopped.load(std::memory_order_acquire)) {
+                size_t count = wait_io_events(events.data(), batch);
+                if (m_next_timer_tick.load(std::memory_order_relaxed) != detail::TimerWheel::NO_TICK) {
+                    // Reads and sends are stamped with this tick for the keep-alive checks
+                    m_timer_tick.store(timer_tick(), std::memory_order_relaxed);
                 }
+                for (size_t i = 0; i < count; ++i) {
+                    if (!handle_io_event(events[i])) {
+                        m_is_loop_stopped = true;
+                        break;
+                    }
+                }
+                run_due_timers();
             }
+        } catch (const std::system_error& ex) {
+            notify_error(ex.code());
+            m_is_loop_stopped = true;
+        } catch (const std::exception&) {
+            notify_error(make_error_code(NamedPipeErrc::UnhandledException));
+            m_is_loop_stopped = true;
+        } catch (...) {
+            notify_error(make_error_code(NamedPipeErrc::UnknownSystemError));
+            m_is_loop_stopped = true;
+        }
+
+        // Wake the next worker still blocked in wait()
+        if (m_io_threads > 1) {
+            m_transport.post(CMD_TYPE_STOP);
+        }
+    }
+
+    // The whole batch is handled before the next wait. With io_spin_us the
+    // queue is polled without blocking first, so a completion arriving
+    // within the spin is picked up without a thread wakeup
+    template <class Handler>
+    size_t BasicNamedPipeServer<Handler>::wait_io_events(IoEvent* events, size_t max_events) {
+        size_t count = 0;
+        uint64_t waits = 0;
+        const auto spin = std::chrono::microseconds(m_io_spin_us.load(std::memory_order_relaxed));
+        if (spin.count() && next_wait_timeout() != 0) {
+            const auto deadline = std::chrono::steady_clock::now() + spin;
+            do {
+                count = m_transport.wait(events, max_events, 0);
+                ++waits;
+            } while (!count && !m_is_loop_stopped.load(std::memory_order_acquire) &&
+                     std::chrono::steady_clock::now() < deadline);
+        }
+        if (!count) {
+            count = m_transport.wait(events, max_events, next_wait_timeout());
+            ++waits;
+        }
+        if (m_is_metrics) {
+            m_io_waits.fetch_add(waits, std::memory_order_relaxed);
+            m_io_events.fetch_add(count, std::memory_order_relaxed);
+        }
+        return count;
+    }
 
-            HANDLE completion_port = m_completion_port.exchange(nullptr, std::memory_order_acq_rel);
-            if (completion_port) {
-                CloseHandle(completion_port);
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::handle_io_event(const IoEvent& event) {
+        size_t index = 0;
+        if (event.type == detail::IoEventType::Command) {
+            index = static_cast<size_t>(event.key >> CMD_TYPE_BITS);
+            switch (event.key & CMD_TYPE_MASK) {
+            case CMD_TYPE_MULTICAST:
+                // A new earliest timer only has to end the wait, run_due_timers() follows
+                if (event.key != CMD_TIMERS) handle_multicast();
+                return true;
+            case CMD_TYPE_SEND:
+            case CMD_TYPE_CLOSE:
+                if (index >= m_clients.size()) return true;
+                break;
+            case CMD_TYPE_STOP:
+                // Server stop signal
+                return false;
+            default:
+                return true;
+            }
+        } else
+        if (event.type == detail::IoEventType::Error) {
+            notify_error(event.error);
+            return true;
+        } else {
+            index = event.key;
+            if (index >= m_clients.size()) {
+                notify_error(make_error_code(NamedPipeErrc::ClientIndexOutOfRange));
+                return true;
             }
         }
+
+        dispatch_client_event(index, event);
+        return true;
     }
 
-    void NamedPipeServer::run_server_loop(const ServerConfig& config) {
-        notify_start(config);
-        HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
-        while (!m_is_stop_server) {
-            DWORD bytes_transferred;
-            ULONG_PTR key;
-            OVERLAPPED* ov;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_multicast() {
+        std::vector<size_t> indices;
+        {
+            std::lock_guard<std::mutex> lock(m_multicast_mutex);
+            indices.swap(m_multicast_indices);
+            m_is_multicast_posted = false;
+        }
+        for (size_t index : indices) {
+            dispatch_client_event(index, IoEvent(detail::IoEventType::Command, (static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_SEND));
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::dispatch_client_event(size_t index, const IoEvent& event) {
+        if (m_io_threads == 1) {
+            handle_client_event(index, event);
+            return;
+        }
 
-            BOOL ok = GetQueuedCompletionStatus(completion_port, &bytes_transferred, &key, &ov, INFINITE);
-            size_t index = key & CMD_INDEX_MASK;
+        // Strand: the first thread to find the client idle drains its queue,
+        // other threads only enqueue, so per-client events never overlap
+        ClientRecord& client = m_clients[index];
+        std::unique_lock<std::mutex> lock(client.strand_mutex);
+        client.strand_queue.push_back(event);
+        if (client.strand_active) return;
+        client.strand_active = true;
+
+        while (!client.strand_queue.empty()) {
+            IoEvent next = client.strand_queue.front();
+            client.strand_queue.pop_front();
+            lock.unlock();
+            try {
+                handle_client_event(index, next);
+            } catch (...) {
+                lock.lock();
+                client.strand_active = false;
+                throw;
+            }
+            lock.lock();
+        }
+        client.strand_active = false;
+    }
 
-            // Special handling of send commands
-            if ((key & CMD_TYPE_SEND) == CMD_TYPE_SEND) {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_client_event(size_t index, const IoEvent& event) {
+        switch (event.type) {
+        case detail::IoEventType::Command:
+            if ((event.key & CMD_TYPE_MASK) == CMD_TYPE_SEND) {
                 process_write_commands(index);
-                continue;
+            } else {
+                handle_close(index);
             }
+            break;
+        case detail::IoEventType::Connected:
+            handle_connected(index);
+            break;
+        case detail::IoEventType::Read:
+            handle_read_completion(index, event.bytes, event.more_data, event.error);
+            break;
+        case detail::IoEventType::Write:
+            handle_write_completion(index, event.bytes, event.error);
+            break;
+        case detail::IoEventType::Disconnected:
+            handle_disconnect(index, event.error);
+            break;
+        case detail::IoEventType::Timer:
+            handle_keep_alive(index);
+            break;
+        default:
+            break;
+        }
+    }
 
-            if ((key & CMD_TYPE_CLOSE) == CMD_TYPE_CLOSE) {
-                handle_close(index, completion_port);
-                continue;
+    // Called with m_clients_mutex held
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::listen_new_client(std::error_code& ec) {
+        size_t index = m_clients.acquire();
+        if (index == ClientTable::npos) {
+            ec = make_error_code(NamedPipeErrc::ClientIndexOutOfRange);
+            return false;
+        }
+        ++m_slot_count;
+
+        ClientRecord& client = m_clients[index];
+        client.endpoint.slot = index;
+        if (!m_transport.listen(client.endpoint, ec)) {
+            m_transport.release(client.endpoint);
+            m_clients.release(index);
+            --m_slot_count;
+            return false;
+        }
+        client.is_listening = true;
+        ++m_listening_count;
+        return true;
+    }
+
+    // Called with m_clients_mutex held
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::needs_listener() const {
+        const size_t max_clients = m_max_clients.load(std::memory_order_relaxed);
+        return m_listening_count < m_listen_instances.load(std::memory_order_relaxed) &&
+            (!max_clients || m_slot_count < max_clients);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_connected(size_t index) {
+        ClientRecord& client = m_clients[index];
+        {
+            std::lock_guard<std::mutex> lock(m_clients_mutex);
+            if (client.is_listening) {
+                client.is_listening = false;
+                --m_listening_count;
             }
+        }
 
-            // Server stop signal
-            if (((key & CMD_TYPE_STOP) == CMD_TYPE_STOP) ||
-                (key == 0 && ov == nullptr && bytes_transferred == 0)) {
+        client.read_buffer = m_receive_pool.acquire(m_buffer_size.load(std::memory_order_relaxed));
+        if (m_is_batching) client.batch_buffer.reserve(m_batch_max_bytes);
+        client.is_handshake_window = true;
+        const uint64_t idle_timeout = m_idle_timeout_ms.load(std::memory_order_relaxed);
+        const uint64_t heartbeat = m_heartbeat_interval_ms.load(std::memory_order_relaxed);
+        if (idle_timeout || heartbeat) {
+            const uint64_t now = timer_tick();
+            // The loop refreshes the tick only while timers are pending, this may be the first
+            m_timer_tick.store(now, std::memory_order_relaxed);
+            client.last_read_tick = now;
+            client.last_send_tick = now;
+            arm_keep_alive(index, now + (idle_timeout && heartbeat ? (std::min)(idle_timeout, heartbeat) : idle_timeout + heartbeat));
+        }
+        notify_connected(index);
+        start_read(index);
+
+        // Replace the consumed instance, so idle instances stay constant while clients grow
+        std::unique_lock<std::mutex> lock(m_clients_mutex);
+        while (needs_listener()) {
+            std::error_code ec;
+            if (!listen_new_client(ec)) {
+                lock.unlock();
+                notify_error(ec);
                 break;
             }
+        }
+    }
 
-            DWORD err = GetLastError();
-            if (!ok) {
-                if (ov == nullptr) {
-                    // Severe queue error, ov is null so we cannot continue
-                    notify_error(std::error_code(static_cast<int>(err), std::system_category()));
-                    continue;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::start_read(size_t index) {
+        ClientRecord& client = m_clients[index];
+
+        // Skip reading if still not connected
+        if (!client.is_connected.load(std::memory_order_acquire)) return;
+
+        std::error_code ec;
+        if (!m_transport.read(client.endpoint, client.read_buffer.data(), client.read_buffer.size(), ec)) {
+            handle_disconnect(index, ec);
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_read_completion(size_t index, size_t bytes_transferred, bool more_data, const std::error_code& ec) {
+        ClientRecord& client = m_clients[index];
+        if (!client.is_connected.load(std::memory_order_acquire)) return;
+        client.last_read_tick = m_timer_tick.load(std::memory_order_relaxed);
+        if (ec) {
+            // The transport already dropped a message above the limit
+            if (!reject_message(index, ec)) return;
+        } else if (client.shm) {
+            // Messages come through the ring, the pipe only wakes us up
+            handle_shm_wakeup(index);
+        } else if (client.is_handshake_window && !more_data && client.received_size == 0 &&
+                   detail::is_session_message(client.read_buffer.data(), bytes_transferred, detail::SESSION_HELLO)) {
+            // The window stays open, a ring request may follow
+            open_session(index, MessageView(client.read_buffer.data(), bytes_transferred));
+        } else if (client.is_handshake_window && !more_data && client.received_size == 0 &&
+                   detail::is_shared_memory_message(client.read_buffer.data(), bytes_transferred, detail::SHARED_MEMORY_REQUEST)) {
+            client.is_handshake_window = false;
+            accept_shared_memory(index, MessageView(client.read_buffer.data(), bytes_transferred));
+        } else if (client.is_discarding) {
+            client.is_discarding = more_data;
+        } else if (bytes_transferred > 0) {
+            client.is_handshake_window = false;
+            if (m_is_metrics) detail::TrafficCounters::add(client.traffic.bytes_in, bytes_transferred);
+            client.received_size += bytes_transferred;
+            const size_t max_receive_size = m_max_receive_size.load(std::memory_order_relaxed);
+            if (max_receive_size && client.received_size > max_receive_size) {
+                if (!reject_message(index, make_error_code(NamedPipeErrc::IncomingMessageTooLarge))) return;
+                client.is_discarding = more_data;
+            } else if (client.is_streaming || (more_data && client.received_size == bytes_transferred &&
+                                                m_is_streaming.load(std::memory_order_relaxed))) {
+                // Streaming starts only with the first read of a message, a
+                // message half assembled when set_config() enabled it stays whole
+                MessageChunk chunk;
+                chunk.data = MessageView(client.read_buffer.data(), bytes_transferred);
+                chunk.offset = client.received_size - bytes_transferred;
+                chunk.first = !client.is_streaming;
+                chunk.last = !more_data;
+                client.is_streaming = more_data;
+                if (!more_data) client.received_size = 0;
+                notify_message_chunk(index, chunk);
+            } else if (!more_data && client.message_buffer.empty()) {
+                // The whole message arrived in one read, deliver it in place
+                client.received_size = 0;
+                notify_message(index, MessageView(client.read_buffer.data(), bytes_transferred));
+            } else {
+                client.message_buffer.append(client.read_buffer.data(), bytes_transferred);
+                if (!more_data) {
+                    client.received_size = 0;
+                    notify_message(index, MessageView(client.message_buffer.data(), client.message_buffer.size()));
                 }
+            }
+        }
+        start_read(index);
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::reject_message(size_t index, const std::error_code& ec) {
+        if (m_oversized_policy.load(std::memory_order_relaxed) == OversizedMessagePolicy::Disconnect) {
+            handle_disconnect(index, ec);
+            return false;
+        }
+
+        ClientRecord& client = m_clients[index];
+        if (client.is_streaming) {
+            MessageChunk chunk;
+            chunk.offset = client.received_size;
+            chunk.last = true;
+            chunk.error = ec;
+            client.is_streaming = false;
+            notify_message_chunk(index, chunk);
+        }
+        client.received_size = 0;
+        client.message_buffer.clear();
+        notify_error(ec);
+        return true;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_disconnect(size_t index, const std::error_code& ec) {
+        if (!m_clients[index].is_connected.load(std::memory_order_acquire)) return;
+        notify_disconnected(index, ec);
+        recycle_client(index);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::recycle_client(size_t index) {
+        ClientRecord& client = m_clients[index];
+        m_transport.disconnect(client.endpoint);
+        const bool is_held = detach_session(index);
+        fail_active_writes(index, make_error_code(NamedPipeErrc::NotConnected), is_held);
+
+        const int client_id = client_id_of(index);
+        // A new generation makes client ids held by the user stale
+        client.generation.fetch_add(1, std::memory_order_acq_rel);
+        leave_all_groups(index, client_id);
+        fail_pending_commands(index, make_error_code(NamedPipeErrc::NotConnected));
+        retire_traffic(index);
+
+        m_receive_pool.release(std::move(client.read_buffer));
+        std::vector<char>().swap(client.batch_buffer);
+        std::string().swap(client.message_buffer);
+        client.received_size = 0;
+        client.is_discarding = false;
+        client.is_write_blocked.store(false, std::memory_order_relaxed);
+        client.is_slow = false;
+        client.connection.reset();
+        reset_shared_memory(index);
+        cancel_keep_alive(index);
+
+        std::unique_lock<std::mutex> clients_lock(m_clients_mutex);
+        // The slot is still counted, so it may listen again unless max_clients shrank below it
+        const size_t max_clients = m_max_clients.load(std::memory_order_relaxed);
+        if (m_listening_count < m_listen_instances.load(std::memory_order_relaxed) &&
+            (!max_clients || m_slot_count <= max_clients)) {
+            std::error_code ec;
+            if (m_transport.listen(client.endpoint, ec)) {
+                client.is_listening = true;
+                ++m_listening_count;
+                return;
+            }
+            clients_lock.unlock();
+            notify_error(ec);
+            clients_lock.lock();
+        }
+        m_transport.release(client.endpoint);
+        m_clients.release(index);
+        --m_slot_count;
+    }
+
+    // Process all accumulated write commands
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::process_write_commands(size_t index) {
+        ClientRecord& client = m_clients[index];
+        // Clear the flag first so a send racing with the drain posts again
+        client.is_send_posted.exchange(false, std::memory_order_acq_rel);
+        WriteCommand cmd;
+        if (client.pending_writes.pop(cmd)) {
+            client.last_send_tick = m_timer_tick.load(std::memory_order_relaxed);
+            do {
+                queue_write(index, std::move(cmd));
+            } while (client.pending_writes.pop(cmd));
+        }
+        if (!apply_slow_consumer_policy(index)) return;
+
+        if (!client.is_writing) {
+            client.is_writing = true;
+            post_next_write(index);
+        }
+        check_writable(index);
+    }
+
+    // active_writes is kept in write order: a message goes behind the last
+    // one of its priority or higher, ahead of the lower-priority ones it may
+    // overtake
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::queue_write(size_t index, WriteCommand&& cmd) {
+        auto& queue = m_clients[index].active_writes;
+        const size_t first = (std::min)(m_clients[index].inflight_writes, queue.size());
+        size_t position = queue.size();
+        while (position > first && can_overtake(cmd, queue[position - 1])) --position;
+        for (size_t i = position; i < queue.size(); ++i) ++queue[i].overtaken;
+        insert_write(index, position, std::move(cmd));
+    }
+
+    // deque::insert() in the middle may shift the commands in front, and a
+    // command on the wire must stay put: its header and a short owned
+    // message live inside it
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::insert_write(size_t index, size_t position, WriteCommand&& cmd) {
+        auto& queue = m_clients[index].active_writes;
+        queue.push_back(std::move(cmd));
+        std::rotate(queue.begin() + position, queue.end() - 1, queue.end());
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::can_overtake(const WriteCommand& cmd, const WriteCommand& queued) const {
+        // A sequenced message keeps its place, the client drops what comes out of order
+        if (queued.is_control || queued.is_sequenced || queued.priority >= cmd.priority) return false;
+        if (queued.overtaken >= m_max_overtakes.load(std::memory_order_relaxed)) return false;
+        // A started message is interrupted only between chunks that are separate writes anyway
+        return queued.offset == 0 || !m_is_batching;
+    }
+
+    // At a chunk boundary the rest of a large message waits behind the
+    // higher-priority messages queued since its first chunk
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::yield_partial_write(size_t index) {
+        auto& queue = m_clients[index].active_writes;
+        WriteCommand& partial = queue.front();
+        size_t position = 1;
+        while (position < queue.size() && can_overtake(queue[position], partial)) {
+            ++partial.overtaken;
+            ++position;
+        }
+        if (position == 1) return false;
+        std::rotate(queue.begin(), queue.begin() + 1, queue.begin() + position);
+        return true;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::pop_active_write(size_t index, const std::error_code& ec) {
+        ClientRecord& client = m_clients[index];
+        WriteCommand& cmd = client.active_writes.front();
+        if (cmd.is_control) {
+            // With the accepting reply out, the client reads the ring
+            if (!ec && client.shm && !client.is_shm_active.load(std::memory_order_relaxed) &&
+                !cmd.is_sequenced && detail::is_shared_memory_message(cmd.data(), cmd.size(), detail::SHARED_MEMORY_REPLY)) {
+                client.is_shm_active.store(true, std::memory_order_release);
+            }
+            client.active_writes.pop_front();
+            return;
+        }
+        release_write(client, cmd.size());
+        if (m_is_metrics) {
+            if (ec) {
+                detail::TrafficCounters::add(client.traffic.failed_writes, 1);
+            } else {
+                detail::TrafficCounters::add(client.traffic.messages_out, 1);
+                detail::TrafficCounters::add(client.traffic.bytes_out, cmd.size());
+                const auto latency = std::chrono::steady_clock::now() - cmd.enqueued;
+                client.traffic.record_latency(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+            }
+        }
+        complete_write(cmd, ec);
+        client.active_writes.pop_front();
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::apply_slow_consumer_policy(size_t index) {
+        const size_t high = m_high_watermark.load(std::memory_order_relaxed);
+        if (!high) return true;
+        ClientRecord& client = m_clients[index];
+        if (client.queued_bytes.load(std::memory_order_acquire) < high) {
+            client.is_slow = false;
+            return true;
+        }
+
+        switch (m_slow_consumer.load(std::memory_order_relaxed)) {
+        case SlowConsumerPolicy::DropOldest:
+            drop_oldest_writes(index);
+            break;
+        case SlowConsumerPolicy::Disconnect: {
+            if (!client.is_connected.load(std::memory_order_acquire)) break;
+            const auto now = std::chrono::steady_clock::now();
+            const auto timeout = std::chrono::milliseconds(m_slow_consumer_timeout_ms.load(std::memory_order_relaxed));
+            if (!client.is_slow) {
+                // Come back when the grace period is over
+                client.is_slow = true;
+                client.slow_since = now;
+                schedule_send(index, now + timeout);
+            } else if (now - client.slow_since >= timeout) {
+                handle_disconnect(index, make_error_code(NamedPipeErrc::SlowConsumer));
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        return true;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::drop_oldest_writes(size_t index) {
+        ClientRecord& client = m_clients[index];
+        const size_t high = m_high_watermark.load(std::memory_order_relaxed);
+        // Messages already on the wire stay, and so does the newest one
+        auto it = client.active_writes.begin() + (std::min)(client.inflight_writes, client.active_writes.size());
+        while (it != client.active_writes.end() && std::next(it) != client.active_writes.end() &&
+               client.queued_bytes.load(std::memory_order_acquire) >= high) {
+            if (it->offset > 0 || it->is_control) {
+                ++it;
+                continue;
+            }
+            release_write(client, it->size());
+            if (m_is_metrics) detail::TrafficCounters::add(client.traffic.dropped_writes, 1);
+            complete_write(*it, make_error_code(NamedPipeErrc::MessageDropped));
+            it = client.active_writes.erase(it);
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::check_writable(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.is_write_blocked.load(std::memory_order_acquire)) return;
+        const size_t queued = client.queued_bytes.load(std::memory_order_acquire);
+        if (queued < m_high_watermark.load(std::memory_order_relaxed)) client.is_slow = false;
+        if (queued > m_low_watermark.load(std::memory_order_relaxed)) return;
+        if (!client.is_write_blocked.exchange(false, std::memory_order_acq_rel)) return;
+        notify_writable(index);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_write_completion(size_t index, size_t bytes_transferred, const std::error_code& ec) {
+        ClientRecord& client = m_clients[index];
+        if (client.is_shm_active.load(std::memory_order_relaxed)) {
+            // Only wakeups use the pipe now; a failed one shows up as a disconnect on the read side
+            client.is_wakeup_pending = false;
+            if (client.is_wakeup_due) {
+                client.is_wakeup_due = false;
+                send_shm_wakeup(index);
+            }
+            return;
+        }
+        if (!client.is_writing || client.active_writes.empty()) return;
+
+        // In batching mode one write covers several commands
+        size_t count = (std::max)(client.inflight_writes, size_t(1));
+        client.inflight_writes = 0;
+        while (count > 0 && !client.active_writes.empty()) {
+            auto& cmd = client.active_writes.front();
+            if (!ec) {
+                size_t consumed = (std::min)(bytes_transferred, framed_size(cmd) - cmd.offset);
+                cmd.offset += consumed;
+                bytes_transferred -= consumed;
+                if (cmd.offset < framed_size(cmd)) break;
+            }
+            pop_active_write(index, ec);
+            --count;
+        }
+        post_next_write(index);
+        check_writable(index);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::post_next_write(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (client.is_shm_active.load(std::memory_order_relaxed)) {
+            post_shm_writes(index);
+            client.is_writing = false;
+            return;
+        }
+        while (!client.active_writes.empty() || take_conflated(index)) {
+            auto& cmd = client.active_writes.front();
+
+            if (!client.is_connected.load(std::memory_order_acquire) ||
+                cmd.client_id != client_id_of(index)) {
+                pop_active_write(index, make_error_code(NamedPipeErrc::NotConnected));
+                continue;
+            }
 
-                // ov != nullptr means the operation completed with an error
-                if (err == ERROR_BROKEN_PIPE) {
-                    notify_disconnected(index, std::error_code(err, std::system_category()));
-                    DisconnectNamedPipe(m_pipes[index]);
-                    reconnect_client(index, completion_port, &m_read_overlapped[index]);
+            std::error_code ec;
+            if (m_is_batching && !cmd.is_control) {
+                if (framed_size(cmd) == 0) {
+                    // Nothing to carry for an empty unframed message
+                    pop_active_write(index, std::error_code{});
                     continue;
                 }
-
-                notify_error(std::error_code(static_cast<int>(err), std::system_category()));
+                if (defer_batch(index)) break;
+                if (post_batch_write(index, ec)) return;
+                pop_active_write(index, ec);
                 continue;
             }
 
-            if (index >= MAX_CLIENTS) {
-                notify_error(make_error_code(NamedPipeErrc::ClientIndexOutOfRange));
+            if (cmd.offset > 0 && yield_partial_write(index)) continue;
+
+            // Only the first chunk of a message carries its sequence number, so
+            // a message to a session has to fit into one pipe message
+            const size_t buffer_size = m_buffer_size.load(std::memory_order_relaxed);
+            if (client.session && cmd.offset == 0 && !cmd.is_control && !cmd.is_sequenced) {
+                if (cmd.size() + detail::SEQUENCE_SIZE > buffer_size) {
+                    pop_active_write(index, make_error_code(NamedPipeErrc::MessageTooLarge));
+                    continue;
+                }
+                sequence_write(index, cmd);
+            }
+            // A repeated message may have been kept before buffer_size shrank
+            if (cmd.offset == 0 && cmd.is_sequenced && cmd.wire_size() > buffer_size) {
+                pop_active_write(index, make_error_code(NamedPipeErrc::MessageTooLarge));
                 continue;
             }
 
-            // Connection completed (ConnectNamedPipe)
-            if (ov == &m_read_overlapped[index] &&
-                bytes_transferred == 0 &&
-                !m_is_connected[index]) {
-                notify_connected(index);
-            } else
-            // Handle write completion
-            if (ov == &m_write_overlapped[index]) {
-                handle_write_completion(index, bytes_transferred);
-            } else
-            // Handle read completion
-            if (ov == &m_read_overlapped[index] && bytes_transferred > 0) {
-                err = GetLastError();
-                m_message_buffers[index].append(m_read_buffers[index].data(), bytes_transferred);
-                if (err != ERROR_MORE_DATA) {
-                    notify_message(index);
+            // Write straight from the command's storage; it stays put in the
+            // queue until the completion arrives
+            size_t msg_offset = cmd.offset;
+            size_t remaining = (msg_offset < cmd.wire_size())
+                ? (cmd.wire_size() - msg_offset)
+                : 0;
+            size_t chunk_size = (std::min)(buffer_size, remaining);
+
+            // The sequence number goes out in front of the payload within the same message
+            const size_t header_size = cmd.header_size();
+            const size_t header_part = msg_offset < header_size ? (std::min)(header_size - msg_offset, chunk_size) : 0;
+            const size_t data_offset = (std::max)(msg_offset + header_part, header_size) - header_size;
+            if (m_transport.write(client.endpoint, cmd.header + (std::min)(msg_offset, header_size), header_part,
+                                  cmd.data() + data_offset, chunk_size - header_part, ec)) {
+                if (m_is_journaling && msg_offset == 0 && !cmd.is_control) {
+                    journal_message(JournalDirection::Outbound, cmd.client_id, cmd.payload());
                 }
+                client.inflight_writes = 1;
+                return;
             }
 
-            // Skip reading if still not connected
-            if (!m_is_connected[index].load(std::memory_order_acquire)) continue;
+            pop_active_write(index, ec);
+        }
+        client.is_writing = false;
+    }
 
-            DWORD dummy = 0;
-            OVERLAPPED* new_ov = &m_read_overlapped[index];
-            BOOL result = ReadFile(m_pipes[index], m_read_buffers[index].data(), static_cast<DWORD>(m_read_buffers[index].size()), &dummy, new_ov);
+    template <class Handler>
+    size_t BasicNamedPipeServer<Handler>::framed_size(const WriteCommand& cmd) const {
+        return cmd.wire_size() + (m_is_length_prefix && !cmd.is_control ? sizeof(uint32_t) : 0);
+    }
 
-            err = GetLastError();
-            if (!result && err != ERROR_IO_PENDING) {
-                if (err == ERROR_BROKEN_PIPE ||
-                    err == ERROR_NO_DATA) {
-                    DisconnectNamedPipe(m_pipes[index]);
-                    reconnect_client(index, completion_port, new_ov);
-                    continue;
-                } else {
-                    notify_error(std::error_code(static_cast<int>(err), std::system_category()));
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::post_batch_write(size_t index, std::error_code& ec) {
+        ClientRecord& client = m_clients[index];
+        const int client_id = client_id_of(index);
+        const size_t prefix_size = m_is_length_prefix ? sizeof(uint32_t) : 0;
+        auto& buffer = client.batch_buffer;
+        buffer.clear();
+
+        // Pack the framed bytes of consecutive commands, the last one possibly in part
+        size_t commands = 0;
+        for (auto& cmd : client.active_writes) {
+            if (buffer.size() >= m_batch_max_bytes || cmd.client_id != client_id || cmd.is_control) break;
+            if (client.session && cmd.offset == 0 && !cmd.is_sequenced) sequence_write(index, cmd);
+            size_t offset = cmd.offset;
+            size_t take = (std::min)(framed_size(cmd) - offset, m_batch_max_bytes - buffer.size());
+            const bool is_partial = offset + take < framed_size(cmd);
+
+            // Framed as length prefix, sequence number, payload
+            const uint32_t size = static_cast<uint32_t>(cmd.wire_size());
+            const char prefix[4] = {
+                static_cast<char>(size & 0xFF),
+                static_cast<char>((size >> 8) & 0xFF),
+                static_cast<char>((size >> 16) & 0xFF),
+                static_cast<char>((size >> 24) & 0xFF)
+            };
+            const char* parts[3] = {prefix, cmd.header, cmd.data()};
+            const size_t part_sizes[3] = {prefix_size, cmd.header_size(), cmd.size()};
+            for (size_t i = 0; i < 3 && take > 0; ++i) {
+                if (offset >= part_sizes[i]) {
+                    offset -= part_sizes[i];
                     continue;
                 }
+                size_t count = (std::min)(part_sizes[i] - offset, take);
+                buffer.insert(buffer.end(), parts[i] + offset, parts[i] + offset + count);
+                offset = 0;
+                take -= count;
             }
+
+            ++commands;
+            if (is_partial) break;
         }
 
-        notify_stop(config);
+        if (!m_transport.write(client.endpoint, buffer.data(), buffer.size(), ec)) {
+            return false;
+        }
+        if (m_is_journaling) {
+            for (size_t i = 0; i < commands; ++i) {
+                const WriteCommand& cmd = client.active_writes[i];
+                if (cmd.offset == 0) journal_message(JournalDirection::Outbound, client_id, cmd.payload());
+            }
+        }
+        client.inflight_writes = commands;
+        return true;
     }
 
-    // Process all accumulated write commands
-    void NamedPipeServer::process_write_commands(size_t index) {
-        std::unique_lock<std::mutex> lock(m_write_mutex);
-        while (!m_pending_writes[index].empty()) {
-            m_active_writes[index].push(std::move(m_pending_writes[index].front()));
-            m_pending_writes[index].pop();
+    // Nagle-like policy: a partial batch waits for more messages until it
+    // fills up or its deadline passes
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::defer_batch(size_t index) {
+        if (m_flush_delay.count() == 0) return false;
+        ClientRecord& client = m_clients[index];
+
+        // A high-priority message is not held back
+        size_t pending = 0;
+        bool is_urgent = false;
+        for (const auto& cmd : client.active_writes) {
+            pending += framed_size(cmd) - cmd.offset;
+            is_urgent = is_urgent || cmd.priority == SendPriority::High;
+            if (pending >= m_batch_max_bytes || is_urgent) break;
         }
-        lock.unlock();
 
-        if (!m_is_writing[index]) {
-            m_is_writing[index] = true;
-            post_next_write(index);
+        auto now = std::chrono::steady_clock::now();
+        if (pending >= m_batch_max_bytes || is_urgent ||
+            (client.is_flush_scheduled && now >= client.flush_deadline)) {
+            client.is_flush_scheduled = false;
+            return false;
         }
+        if (!client.is_flush_scheduled) {
+            client.is_flush_scheduled = true;
+            client.flush_deadline = now + m_flush_delay;
+            schedule_send(index, client.flush_deadline);
+        }
+        return true;
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::schedule_send(size_t index, std::chrono::steady_clock::time_point deadline) {
+        std::lock_guard<std::mutex> lock(m_flush_mutex);
+        m_flush_timers.push({deadline, index});
     }
 
-    void NamedPipeServer::handle_write_completion(size_t index, size_t bytes_transferred) {
-        if (!m_active_writes[index].empty()) {
-            auto& cmd = m_active_writes[index].front();
-            cmd.offset += bytes_transferred;
-            if (cmd.offset >= cmd.message.size()) {
-                if (cmd.on_done) cmd.on_done(std::error_code{});
-                m_active_writes[index].pop();
+    template <class Handler>
+    int BasicNamedPipeServer<Handler>::next_wait_timeout() {
+        using clock = std::chrono::steady_clock;
+        const bool is_metrics_timer = m_metrics_interval.count() > 0;
+        const bool has_send_timers = m_has_send_timers.load(std::memory_order_relaxed);
+        const uint64_t next_timer = m_next_timer_tick.load(std::memory_order_relaxed);
+        const bool has_timers = next_timer != detail::TimerWheel::NO_TICK;
+        if (!has_send_timers && !is_metrics_timer && !has_timers) return -1;
+
+        clock::time_point deadline = (clock::time_point::max)();
+        if (is_metrics_timer) {
+            deadline = clock::time_point(clock::duration(m_next_metrics_report.load(std::memory_order_relaxed)));
+        }
+        if (has_timers) {
+            deadline = (std::min)(deadline, m_timer_epoch + std::chrono::milliseconds(next_timer));
+        }
+        clock::time_point flush_deadline = (clock::time_point::max)();
+        if (has_send_timers) {
+            std::lock_guard<std::mutex> lock(m_flush_mutex);
+            if (!m_flush_timers.empty()) flush_deadline = m_flush_timers.top().deadline;
+        }
+        if (deadline == (clock::time_point::max)() && flush_deadline == (clock::time_point::max)()) return -1;
+
+        const auto now = clock::now();
+        if (flush_deadline < deadline) {
+            // flush_delay_us is finer than a timed wait: block until the wait
+            // cannot oversleep the deadline any more, then poll the rest
+            auto delay = std::chrono::duration_cast<std::chrono::microseconds>(flush_deadline - now).count();
+            delay -= detail::Transport::WAIT_RESOLUTION_US;
+            return delay <= 0 ? 0 : static_cast<int>(delay / 1000);
+        }
+        auto delay = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count();
+        if (delay <= 0) return 0;
+        // Round up so the wait never returns before the deadline
+        return static_cast<int>((delay + 999) / 1000);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::run_due_timers() {
+        if (m_metrics_interval.count() > 0) {
+            // One worker claims the report by moving the deadline forward
+            const auto now = std::chrono::steady_clock::now();
+            auto next = m_next_metrics_report.load(std::memory_order_relaxed);
+            if (now.time_since_epoch().count() >= next &&
+                m_next_metrics_report.compare_exchange_strong(next, (now + m_metrics_interval).time_since_epoch().count(),
+                                                              std::memory_order_relaxed)) {
+                notify_metrics(std::make_shared<const ServerMetrics>(get_metrics()));
             }
         }
-        post_next_write(index);
+        const uint64_t next_timer = m_next_timer_tick.load(std::memory_order_relaxed);
+        if (next_timer != detail::TimerWheel::NO_TICK) {
+            const uint64_t tick = timer_tick();
+            if (tick >= next_timer) {
+                std::vector<std::function<void()>> expired;
+                {
+                    std::lock_guard<std::mutex> lock(m_timer_mutex);
+                    m_timers.advance(tick, expired);
+                    m_next_timer_tick.store(m_timers.next_tick(), std::memory_order_relaxed);
+                }
+                for (auto& fn : expired) fn();
+            }
+        }
+        if (!m_has_send_timers.load(std::memory_order_relaxed)) return;
+        std::vector<size_t> due;
+        {
+            std::lock_guard<std::mutex> lock(m_flush_mutex);
+            auto now = std::chrono::steady_clock::now();
+            while (!m_flush_timers.empty() && m_flush_timers.top().deadline <= now) {
+                due.push_back(m_flush_timers.top().index);
+                m_flush_timers.pop();
+            }
+        }
+        for (size_t index : due) {
+            dispatch_client_event(index, IoEvent(detail::IoEventType::Command, (static_cast<uintptr_t>(index) << CMD_TYPE_BITS) | CMD_TYPE_SEND));
+        }
     }
 
-    void NamedPipeServer::post_next_write(size_t index) {
-        if (m_active_writes[index].empty()) {
-            m_is_writing[index] = false;
-            return;
+    template <class Handler>
+    uint64_t BasicNamedPipeServer<Handler>::timer_tick() const {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_timer_epoch).count());
+    }
+
+    template <class Handler>
+    TimerId BasicNamedPipeServer<Handler>::add_timer(uint64_t tick, std::function<void()>&& fn) {
+        TimerId id = 0;
+        bool is_earliest = false;
+        {
+            std::lock_guard<std::mutex> lock(m_timer_mutex);
+            id = m_timers.add(tick, std::move(fn));
+            const uint64_t next = m_timers.next_tick();
+            is_earliest = next < m_next_timer_tick.load(std::memory_order_relaxed);
+            m_next_timer_tick.store(next, std::memory_order_relaxed);
         }
+        // A loop blocked in wait() has to pick up the shorter timeout
+        if (is_earliest) m_transport.post(CMD_TIMERS);
+        return id;
+    }
 
-        auto& cmd = m_active_writes[index].front();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::drop_timers() {
+        std::vector<std::function<void()>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(m_timer_mutex);
+            m_timers.clear(dropped);
+            m_next_timer_tick.store(detail::TimerWheel::NO_TICK, std::memory_order_relaxed);
+        }
+        // Pending send_after() calls report TimerCancelled as they are destroyed here
+    }
 
-        if (!m_is_connected[index].load(std::memory_order_acquire)) {
-            if (cmd.on_done) cmd.on_done(make_error_code(NamedPipeErrc::NotConnected));
-            m_active_writes[index].pop();
-            return;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::arm_keep_alive(size_t index, uint64_t tick) {
+        m_clients[index].keep_alive_timer = add_timer(tick, [this, index] {
+            dispatch_client_event(index, IoEvent(detail::IoEventType::Timer, index));
+        });
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::cancel_keep_alive(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.keep_alive_timer) return;
+        cancel_timer(client.keep_alive_timer);
+        client.keep_alive_timer = 0;
+    }
+
+    // Deadlines are checked lazily: reads and sends only stamp a tick, the
+    // timer compares the stamps when it fires and re-arms for the earlier one
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_keep_alive(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.is_connected.load(std::memory_order_acquire)) return;
+        // A timer of the slot's previous client may fire here too; checking early is harmless
+        cancel_keep_alive(index);
+
+        const uint64_t now = timer_tick();
+        const uint64_t idle_timeout = m_idle_timeout_ms.load(std::memory_order_relaxed);
+        const uint64_t heartbeat = m_heartbeat_interval_ms.load(std::memory_order_relaxed);
+        uint64_t next = detail::TimerWheel::NO_TICK;
+        if (idle_timeout) {
+            next = client.last_read_tick + idle_timeout;
+            if (now >= next) {
+                handle_disconnect(index, make_error_code(NamedPipeErrc::IdleTimeout));
+                return;
+            }
         }
+        if (heartbeat) {
+            if (now >= client.last_send_tick + heartbeat) {
+                client.last_send_tick = now;
+                WriteCommand cmd(client_id_of(index), std::atomic_load(&m_heartbeat), nullptr);
+                cmd.is_transient = true;
+                enqueue_write(std::move(cmd));
+            }
+            next = (std::min)(next, client.last_send_tick + heartbeat);
+        }
+        if (next != detail::TimerWheel::NO_TICK) arm_keep_alive(index, next);
+    }
 
-        if (cmd.client_index >= MAX_CLIENTS) {
-            if (cmd.on_done) cmd.on_done(make_error_code(NamedPipeErrc::ClientIndexOutOfRange));
-            m_active_writes[index].pop();
-            return;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::fail_active_writes(size_t index, const std::error_code& reason, bool is_held) {
+        ClientRecord& client = m_clients[index];
+        const std::error_code held = make_error_code(NamedPipeErrc::HeldForResume);
+        while (!client.active_writes.empty()) {
+            // Sequenced messages of a detached session are repeated on resume, they are not lost
+            const WriteCommand& cmd = client.active_writes.front();
+            pop_active_write(index, is_held && cmd.is_sequenced && !cmd.is_transient ? held : reason);
         }
+        client.inflight_writes = 0;
+        client.is_flush_scheduled = false;
+        client.is_writing = false;
+    }
 
-        if (m_pipes[cmd.client_index] == INVALID_HANDLE_VALUE) {
-            if (cmd.on_done) cmd.on_done(make_error_code(NamedPipeErrc::InvalidPipeHandle));
-            m_active_writes[index].pop();
-            return;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_close(size_t index) {
+        ClientRecord& client = m_clients[index];
+        client.is_close_posted.exchange(false, std::memory_order_acq_rel);
+        CloseCommand cmd;
+        while (client.pending_closes.pop(cmd)) {
+            if (!client.is_connected.load(std::memory_order_acquire) ||
+                cmd.client_id != client_id_of(index)) {
+                if (cmd.on_done) cmd.on_done(make_error_code(NamedPipeErrc::NotConnected));
+                continue;
+            }
+
+            notify_disconnected(index, std::error_code{});
+            // A client closed on purpose does not come back for its messages
+            end_session(index);
+            recycle_client(index);
+            if (cmd.on_done) cmd.on_done(std::error_code{});
         }
+    }
 
-        size_t buffer_size = m_write_buffers[index].size();
-        size_t msg_offset = cmd.offset;
-        size_t remaining = (msg_offset < cmd.message.size())
-            ? (cmd.message.size() - msg_offset)
-            : 0;
-        size_t bytes_to_copy = (std::min)(buffer_size, remaining);
-        auto& buffer = m_write_buffers[index];
-        buffer.assign(cmd.message.begin() + msg_offset, cmd.message.begin() + msg_offset + bytes_to_copy);
-        cmd.offset += bytes_to_copy;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::accept_shared_memory(size_t index, MessageView request) {
+        ClientRecord& client = m_clients[index];
+        size_t ring_size = 0;
+        std::string name;
+        bool is_accepted = m_is_shm_enabled.load(std::memory_order_relaxed) && !m_is_batching &&
+            detail::parse_shared_memory_request(request.data(), request.size(), ring_size, name) &&
+            detail::SharedChannel::is_valid_name(name) &&
+            ring_size == detail::SharedChannel::ring_size_for(ring_size);
+        if (is_accepted) {
+            std::error_code ec;
+            client.shm.reset(new detail::SharedChannel());
+            if (!client.shm->attach(name, ring_size, ec)) {
+                client.shm.reset();
+                is_accepted = false;
+                notify_error(ec);
+            }
+        }
 
-        OVERLAPPED* ov = &m_write_overlapped[index];
-        memset(ov, 0, sizeof(OVERLAPPED));
+        // The queued messages behind the reply are written to the ring, in the same order
+        insert_control(index, WriteCommand::control(client_id_of(index), detail::make_shared_memory_reply(is_accepted)));
+        if (!client.is_writing) {
+            client.is_writing = true;
+            post_next_write(index);
+        }
+    }
+
+    // A control message goes out after the message on the wire, the started
+    // messages and the control messages queued before it, ahead of the
+    // regular messages
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::insert_control(size_t index, WriteCommand&& cmd) {
+        ClientRecord& client = m_clients[index];
+        auto begin = client.active_writes.begin() + (std::min)(client.inflight_writes, client.active_writes.size());
+        auto is_ahead = [](const WriteCommand& queued) { return queued.offset > 0 || queued.is_control; };
+        // A message that overtook a started one at a chunk boundary moves behind the control message
+        auto end = begin;
+        for (auto it = begin; it != client.active_writes.end(); ++it) {
+            if (is_ahead(*it)) end = std::next(it);
+        }
+        const auto position = std::stable_partition(begin, end, is_ahead) - client.active_writes.begin();
+        insert_write(index, static_cast<size_t>(position), std::move(cmd));
+    }
 
-        DWORD bytes_written = 0;
-        BOOL success = WriteFile(m_pipes[index], buffer.data(), static_cast<DWORD>(bytes_to_copy), &bytes_written, ov);
-        DWORD err = GetLastError();
-        if (!success && err != ERROR_IO_PENDING) {
-            if (cmd.on_done) cmd.on_done(std::error_code(static_cast<int>(err), std::system_category()));
-            m_active_writes[index].pop();
-            m_is_writing[index] = false;
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::open_session(size_t index, MessageView hello) {
+        ClientRecord& client = m_clients[index];
+        // A repeated hello is ignored, the client has its welcome already
+        if (client.session) return;
+        const int client_id = client_id_of(index);
+        std::string token;
+        uint64_t last_sequence = 0;
+        detail::SessionStatus status = detail::SessionStatus::Refused;
+        int previous_client_id = -1;
+        std::vector<std::pair<uint64_t, BufferPtr>> missed;
+        std::error_code error;
+        if (m_is_sessions.load(std::memory_order_relaxed) &&
+            detail::parse_session_hello(hello.data(), hello.size(), token, last_sequence)) {
+            std::lock_guard<std::mutex> lock(m_sessions_mutex);
+            auto it = token.empty() ? m_sessions.end() : m_sessions.find(token);
+            // A session still attached belongs to a connection not yet seen closing; it is not taken over
+            if (it != m_sessions.end() && !it->second->is_attached) {
+                std::shared_ptr<Session> session = it->second;
+                // An expiry timer already running finds the session attached and keeps it
+                if (session->expiry_timer) cancel_timer(session->expiry_timer);
+                session->expiry_timer = 0;
+                if (last_sequence < session->next_sequence && session->retransmit.covers(last_sequence)) {
+                    session->retransmit.collect_after(last_sequence, missed);
+                    previous_client_id = session->client_id;
+                    client.session = session;
+                    status = detail::SessionStatus::Resumed;
+                } else {
+                    // Part of the gap was evicted, the client has to start over
+                    m_sessions.erase(it);
+                }
+            }
+            if (!client.session) {
+                try {
+                    do {
+                        token = detail::make_session_token();
+                    } while (m_sessions.count(token));
+                    client.session = std::make_shared<Session>();
+                    client.session->token = token;
+                    m_sessions.emplace(token, client.session);
+                    status = detail::SessionStatus::New;
+                } catch (const std::exception&) {
+                    // Without entropy the client is refused rather than given a guessable token
+                    client.session.reset();
+                    error = make_error_code(NamedPipeErrc::SessionFailed);
+                }
+            }
+            if (client.session) {
+                client.session->client_id = client_id;
+                client.session->is_attached = true;
+                client.session->retransmit.set_capacity(m_retransmit_bytes.load(std::memory_order_relaxed));
+            }
+        }
+        if (error) notify_error(error);
+
+        // The welcome and the repeated messages go out before anything queued;
+        // messages behind them are sequenced as they are written
+        insert_control(index, WriteCommand::control(client_id,
+            detail::make_session_welcome(client.session ? client.session->token : std::string(), status)));
+        for (auto& message : missed) {
+            WriteCommand cmd = WriteCommand::control(client_id, std::move(message.second));
+            cmd.set_sequence(message.first);
+            insert_control(index, std::move(cmd));
         }
+        if (!client.is_writing) {
+            client.is_writing = true;
+            post_next_write(index);
+        }
+        if (status == detail::SessionStatus::Resumed) notify_session_resumed(index, previous_client_id);
     }
 
-    bool NamedPipeServer::reconnect_client(size_t index, HANDLE completion_port, OVERLAPPED* ov) {
-        memset(ov, 0, sizeof(OVERLAPPED));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::sequence_write(size_t index, WriteCommand& cmd) {
+        Session& session = *m_clients[index].session;
+        const uint64_t sequence = session.next_sequence++;
+        // The ring shares the payload; an owned one is moved, not copied
+        if (!cmd.shared) cmd.shared = make_buffer(std::move(cmd.message));
+        cmd.set_sequence(sequence);
+        // A missed heartbeat is stale by the time the client resumes
+        if (!cmd.is_transient) session.retransmit.push(sequence, cmd.shared);
+    }
 
-        BOOL connected = ConnectNamedPipe(m_pipes[index], ov);
-        if (connected) {
-            PostQueuedCompletionStatus(completion_port, 0, static_cast<ULONG_PTR>(index), ov);
-            return true;
+    // Returns whether the session waits for its client, holding its messages
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::detach_session(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.session) return false;
+
+        // Messages not written yet wait in the retransmit ring for the client to resume
+        WriteCommand cmd;
+        while (client.pending_writes.pop(cmd)) {
+            queue_write(index, std::move(cmd));
+        }
+        while (take_conflated(index)) {}
+        const int client_id = client.session->client_id;
+        // A message too large to repeat in one piece is not held
+        const size_t buffer_size = m_buffer_size.load(std::memory_order_relaxed);
+        for (auto& queued : client.active_writes) {
+            if (queued.offset == 0 && !queued.is_control && !queued.is_sequenced && !queued.is_transient &&
+                queued.client_id == client_id && queued.size() + detail::SEQUENCE_SIZE <= buffer_size) {
+                sequence_write(index, queued);
+            }
         }
 
-        DWORD err = GetLastError();
-        if (err == ERROR_PIPE_CONNECTED) {
-            PostQueuedCompletionStatus(completion_port, 0, static_cast<ULONG_PTR>(index), ov);
-            return true;
-        } else
-        if (err != ERROR_IO_PENDING) {
-            notify_error(std::error_code(static_cast<int>(err), std::system_category()));
+        std::shared_ptr<Session> session = std::move(client.session);
+        const uint64_t timeout = m_resume_timeout_ms.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        session->is_attached = false;
+        if (!timeout) {
+            m_sessions.erase(session->token);
             return false;
         }
+        session->expires_tick = timer_tick() + timeout;
+        const std::string token = session->token;
+        session->expiry_timer = add_timer(session->expires_tick + 1, [this, token] {
+            expire_session(token);
+        });
         return true;
     }
 
-    void NamedPipeServer::handle_close(size_t index, HANDLE completion_port) {
-        std::unique_lock<std::mutex> lock(m_write_mutex);
-        if (m_pending_closes[index].empty()) return;
-        auto on_done = std::move(m_pending_closes[index].front());
-        m_pending_closes[index].pop();
-        lock.unlock();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::end_session(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.session) return;
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        if (client.session->expiry_timer) cancel_timer(client.session->expiry_timer);
+        m_sessions.erase(client.session->token);
+        client.session.reset();
+    }
 
-        if (m_pipes[index] &&
-            m_pipes[index] != INVALID_HANDLE_VALUE) {
-            notify_disconnected(index, std::error_code{});
-            CancelIoEx(m_pipes[index], nullptr);
-            DisconnectNamedPipe(m_pipes[index]);
-            if (reconnect_client(index, completion_port, &m_read_overlapped[index])) {
-                if (on_done) on_done(std::error_code{});
-            } else {
-                if (on_done) on_done(std::error_code(GetLastError(), std::system_category()));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::expire_session(const std::string& token) {
+        std::shared_ptr<Session> expired; // Its messages are released after the lock
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        auto it = m_sessions.find(token);
+        // Resumed meanwhile, or detached again with a later deadline
+        if (it == m_sessions.end() || it->second->is_attached || timer_tick() < it->second->expires_tick) return;
+        expired = std::move(it->second);
+        m_sessions.erase(it);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::handle_shm_wakeup(size_t index) {
+        ClientRecord& client = m_clients[index];
+        const auto spin = std::chrono::microseconds(m_shm_spin_us.load(std::memory_order_relaxed));
+        const auto deadline = std::chrono::steady_clock::now() + spin;
+        for (;;) {
+            if (!drain_shared_memory(index)) break;
+            // The wakeup may also mean room in the outgoing ring
+            process_write_commands(index);
+            if (!client.is_connected.load(std::memory_order_acquire)) return;
+            if (spin.count() && std::chrono::steady_clock::now() < deadline) {
+                // Senders skip the SEND packet while the flag is up, the next
+                // round picks their messages up
+                client.is_send_posted.store(true, std::memory_order_release);
+                continue;
             }
-            return;
+            if (client.shm->inbound().prepare_consumer_wait()) return;
         }
-        if (on_done) on_done(make_error_code(NamedPipeErrc::InvalidPipeHandle));
+        // Gone while spinning; the next client of the slot needs the flag down
+        client.is_send_posted.store(false, std::memory_order_release);
     }
 
-    void NamedPipeServer::cleanup_pending_operations(const std::error_code& reason) {
-        std::array<std::queue<WriteCommand>, MAX_CLIENTS> pending_writes;
-        std::array<std::queue<DoneCallback>, MAX_CLIENTS> pending_closes;
-
-        std::unique_lock<std::mutex> lock(m_write_mutex);
-        std::swap(pending_writes, m_pending_writes);
-        std::swap(pending_closes, m_pending_closes);
-        lock.unlock();
+    // Delivers everything in the incoming ring; false if the client is gone
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::drain_shared_memory(size_t index) {
+        ClientRecord& client = m_clients[index];
+        detail::SharedRing& ring = client.shm->inbound();
+        MessageView message;
+        std::error_code ec;
+        while (ring.peek(message, ec)) {
+            client.last_read_tick = m_timer_tick.load(std::memory_order_relaxed);
+            if (m_is_metrics) detail::TrafficCounters::add(client.traffic.bytes_in, message.size());
+            const size_t max_receive_size = m_max_receive_size.load(std::memory_order_relaxed);
+            if (max_receive_size && message.size() > max_receive_size) {
+                ring.pop();
+                if (!reject_message(index, make_error_code(NamedPipeErrc::IncomingMessageTooLarge))) return false;
+                continue;
+            }
+            notify_message(index, message);
+            if (!client.is_connected.load(std::memory_order_acquire)) return false;
+            ring.pop();
+        }
+        if (ec) {
+            handle_disconnect(index, ec);
+            return false;
+        }
+        if (ring.take_producer_wakeup()) send_shm_wakeup(index);
+        return true;
+    }
 
-        for (size_t i = 0; i < MAX_CLIENTS; ++i) {
-            if (m_is_connected[i].load(std::memory_order_acquire)) {
-                if (m_connections[i]) {
-                    m_connections[i]->invalidate();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::post_shm_writes(size_t index) {
+        ClientRecord& client = m_clients[index];
+        detail::SharedRing& ring = client.shm->outbound();
+        const int client_id = client_id_of(index);
+        while (!client.active_writes.empty() || take_conflated(index)) {
+            WriteCommand& cmd = client.active_writes.front();
+            if (!client.is_connected.load(std::memory_order_acquire) || cmd.client_id != client_id) {
+                pop_active_write(index, make_error_code(NamedPipeErrc::NotConnected));
+                continue;
+            }
+            if (client.session && !cmd.is_control && !cmd.is_sequenced) {
+                if (cmd.size() + detail::SEQUENCE_SIZE > ring.max_message_size()) {
+                    pop_active_write(index, make_error_code(NamedPipeErrc::MessageTooLarge));
+                    continue;
                 }
-                notify_disconnected(i, reason);
+                sequence_write(index, cmd);
+            }
+            if (cmd.wire_size() > ring.max_message_size()) {
+                pop_active_write(index, make_error_code(NamedPipeErrc::MessageTooLarge));
+                continue;
             }
+            if (!ring.try_write(cmd.header, cmd.header_size(), cmd.data(), cmd.size())) {
+                // Full: the client wakes us when it has made room
+                if (ring.prepare_producer_wait(cmd.wire_size())) break;
+                continue;
+            }
+            if (m_is_journaling && !cmd.is_control) journal_message(JournalDirection::Outbound, client_id, cmd.payload());
+            pop_active_write(index, std::error_code{});
+        }
+        if (ring.take_consumer_wakeup()) send_shm_wakeup(index);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::send_shm_wakeup(size_t index) {
+        ClientRecord& client = m_clients[index];
+        // The transport takes one write at a time
+        if (client.is_wakeup_pending) {
+            client.is_wakeup_due = true;
+            return;
+        }
+        std::error_code ec;
+        client.is_wakeup_pending = m_transport.write(client.endpoint, &detail::SHARED_MEMORY_WAKEUP, 1, ec);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::reset_shared_memory(size_t index) {
+        ClientRecord& client = m_clients[index];
+        client.shm.reset();
+        client.is_shm_active.store(false, std::memory_order_relaxed);
+        client.is_handshake_window = false;
+        client.is_wakeup_pending = false;
+        client.is_wakeup_due = false;
+    }
 
-            while (!m_active_writes[i].empty()) {
-                auto& cmd = m_active_writes[i].front();
-                if (cmd.on_done) cmd.on_done(reason);
-                m_active_writes[i].pop();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::fail_pending_commands(size_t index, const std::error_code& reason) {
+        ClientRecord& client = m_clients[index];
+        WriteCommand write;
+        while (client.pending_writes.pop(write)) {
+            release_write(client, write.size());
+            if (m_is_metrics) detail::TrafficCounters::add(client.traffic.failed_writes, 1);
+            complete_write(write, reason);
+        }
+
+        std::unique_ptr<ConflationQueue> conflation;
+        {
+            std::lock_guard<std::mutex> lock(client.conflation_mutex);
+            conflation.swap(client.conflation);
+            client.conflated_count.store(0, std::memory_order_release);
+        }
+        if (conflation) {
+            for (auto& item : conflation->latest) {
+                release_write(client, item.second.size());
+                if (m_is_metrics) detail::TrafficCounters::add(client.traffic.failed_writes, 1);
+                complete_write(item.second, reason);
             }
+        }
 
-            while (!pending_writes[i].empty()) {
-                auto& cmd = pending_writes[i].front();
-                if (cmd.on_done) cmd.on_done(reason);
-                pending_writes[i].pop();
+        CloseCommand close;
+        while (client.pending_closes.pop(close)) {
+            if (close.on_done) close.on_done(reason);
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::cleanup_pending_operations(const std::error_code& reason) {
+        for (size_t i = 0; i < m_clients.size(); ++i) {
+            ClientRecord& client = m_clients[i];
+            if (client.is_connected.load(std::memory_order_acquire)) {
+                notify_disconnected(i, reason);
             }
+            m_transport.release(client.endpoint);
+            fail_active_writes(i, reason);
+
+            const int client_id = client_id_of(i);
+            client.generation.fetch_add(1, std::memory_order_acq_rel);
+            leave_all_groups(i, client_id);
+            fail_pending_commands(i, reason);
+            retire_traffic(i);
+
+            m_receive_pool.release(std::move(client.read_buffer));
+            std::vector<char>().swap(client.batch_buffer);
+            std::string().swap(client.message_buffer);
+            client.received_size = 0;
+            client.is_discarding = false;
+            client.is_write_blocked.store(false, std::memory_order_relaxed);
+            client.is_slow = false;
+            client.connection.reset();
+            client.session.reset();
+            reset_shared_memory(i);
+            cancel_keep_alive(i);
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::retire_traffic(size_t index) {
+        if (!m_is_metrics) return;
+        ConnectionMetrics traffic;
+        m_clients[index].traffic.take(traffic);
+        std::lock_guard<std::mutex> lock(m_metrics_mutex);
+        m_retired_traffic += traffic;
+    }
+
+    template <class Handler>
+    ServerMetrics BasicNamedPipeServer<Handler>::get_metrics() const {
+        ServerMetrics metrics;
+        if (!m_is_metrics) return metrics;
+        metrics.connects = m_connects.load(std::memory_order_relaxed);
+        metrics.disconnects = m_disconnects.load(std::memory_order_relaxed);
+        metrics.dropped_callbacks = m_dropped_callbacks.load(std::memory_order_relaxed);
+        metrics.io_waits = m_io_waits.load(std::memory_order_relaxed);
+        metrics.io_events = m_io_events.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_metrics_mutex);
+            metrics.traffic = m_retired_traffic;
+        }
+
+        const size_t size = m_clients.size();
+        for (size_t i = 0; i < size; ++i) {
+            ClientRecord* client = m_clients.find(i);
+            if (!client || !client->is_connected.load(std::memory_order_acquire)) continue;
+            ClientMetrics item;
+            item.client_id = make_client_id(i, client->generation.load(std::memory_order_acquire));
+            client->traffic.load(item.traffic);
+            item.queued.messages = client->pending_write_count.load(std::memory_order_relaxed);
+            item.queued.bytes = client->queued_bytes.load(std::memory_order_relaxed);
+            metrics.traffic += item.traffic;
+            metrics.queued.messages += item.queued.messages;
+            metrics.queued.bytes += item.queued.bytes;
+            metrics.clients.push_back(item);
+        }
+        metrics.connected_clients = metrics.clients.size();
+        return metrics;
+    }
 
-            while (!pending_closes[i].empty()) {
-                auto& cb = pending_closes[i].front();
-                if (cb) cb(reason);
-                pending_closes[i].pop();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::leave_all_groups(size_t index, int client_id) {
+        ClientRecord& client = m_clients[index];
+        std::lock_guard<std::mutex> lock(m_groups_mutex);
+        for (const auto& group : client.groups) {
+            auto it = m_groups.find(group);
+            if (it == m_groups.end()) continue;
+            it->second.erase(client_id);
+            if (it->second.empty()) m_groups.erase(it);
+        }
+        client.groups.clear();
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_connected(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (client.is_connected.load(std::memory_order_acquire)) return;
+        client.is_connected.store(true, std::memory_order_release);
+        if (m_is_metrics) m_connects.fetch_add(1, std::memory_order_relaxed);
+        const int client_id = client_id_of(index);
+        if (Hooks::uses_connections) client.connection = std::make_shared<Connection>(client_id, this);
+        if (!m_is_dispatching) {
+            Hooks::connected(this->handler(), client_id, client.connection);
+            return;
+        }
+        std::shared_ptr<Connection> connection = client.connection;
+        dispatch_callback(index, [this, client_id, connection] {
+            Hooks::connected(this->handler(), client_id, connection);
+        }, false);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_disconnected(size_t index, const std::error_code& ec) {
+        ClientRecord& client = m_clients[index];
+        if (!client.is_connected.load(std::memory_order_acquire)) return;
+        client.is_connected.store(false, std::memory_order_release);
+        if (m_is_metrics) m_disconnects.fetch_add(1, std::memory_order_relaxed);
+        if (client.is_streaming) {
+            // Finish the open stream so the handler can drop its partial state
+            MessageChunk chunk;
+            chunk.offset = client.received_size;
+            chunk.last = true;
+            chunk.error = ec;
+            client.is_streaming = false;
+            notify_message_chunk(index, chunk);
+        }
+        const int client_id = client_id_of(index);
+        if (client.connection) client.connection->invalidate();
+        if (!m_is_dispatching) {
+            Hooks::disconnected(this->handler(), client_id, client.connection, ec);
+            return;
+        }
+        std::shared_ptr<Connection> connection = client.connection;
+        dispatch_callback(index, [this, client_id, connection, ec] {
+            Hooks::disconnected(this->handler(), client_id, connection, ec);
+        }, false);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::journal_message(JournalDirection direction, int client_id, MessageView message, bool is_partial) {
+        std::error_code ec;
+        if (!m_journal.append(direction, client_id, is_partial, message.data(), message.size(), ec) && ec) {
+            // Reported once, the journal stays off afterwards
+            notify_error(ec);
+        }
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_message(size_t index, MessageView message) {
+        ClientRecord& client = m_clients[index];
+        const int client_id = client_id_of(index);
+        if (m_is_metrics) detail::TrafficCounters::add(client.traffic.messages_in, 1);
+        if (m_is_journaling) journal_message(JournalDirection::Inbound, client_id, message);
+        if (m_is_dispatching) {
+            // The read buffer is reused at once, the worker gets its own copy
+            auto payload = std::make_shared<std::string>(message.data(), message.size());
+            client.message_buffer.clear();
+            std::shared_ptr<Connection> connection = client.connection;
+            const bool is_queued = dispatch_callback(index, [this, client_id, connection, payload] {
+                Hooks::message_view(this->handler(), client_id, MessageView(payload->data(), payload->size()));
+                if (Hooks::wants_message(this->handler())) {
+                    Hooks::message(this->handler(), client_id, connection, *payload);
+                }
+            }, true);
+            if (is_queued) return;
+            if (m_callback_overflow == CallbackOverflowPolicy::Disconnect) {
+                handle_disconnect(index, make_error_code(NamedPipeErrc::CallbackQueueFull));
+            } else {
+                m_dropped_callbacks.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        Hooks::message_view(this->handler(), client_id, message);
+        if (Hooks::wants_message(this->handler())) {
+            // String callbacks need an owned copy; message_buffer keeps its capacity between
+            // messages unless a handler moves from it
+            if (message.data() != client.message_buffer.data()) {
+                client.message_buffer.assign(message.data(), message.size());
             }
+            Hooks::message(this->handler(), client_id, client.connection, client.message_buffer);
         }
+        client.message_buffer.clear();
     }
 
-    void NamedPipeServer::notify_connected(size_t index) {
-        if (m_is_connected[index].load(std::memory_order_acquire)) return;
-        m_is_connected[index].store(true, std::memory_order_release);
-        m_connections[index] = std::make_shared<Connection>(index, this);
-        if (m_event_handler) m_event_handler->on_connected(static_cast<int>(index));
-        if (on_connected) on_connected(static_cast<int>(index));
-        if (on_event) on_event(ServerEvent::client_connected(static_cast<int>(index), m_connections[index]));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_message_chunk(size_t index, const MessageChunk& chunk) {
+        const int client_id = client_id_of(index);
+        if (m_is_metrics && chunk.last && !chunk.error) {
+            detail::TrafficCounters::add(m_clients[index].traffic.messages_in, 1);
+        }
+        if (m_is_journaling && !chunk.error) journal_message(JournalDirection::Inbound, client_id, chunk.data, !chunk.last);
+        if (!m_is_dispatching) {
+            Hooks::message_chunk(this->handler(), client_id, chunk);
+            return;
+        }
+        // Chunks are never dropped: the handler would see a broken stream
+        auto data = std::make_shared<std::string>(chunk.data.data(), chunk.data.size());
+        dispatch_callback(index, [this, client_id, chunk, data] {
+            MessageChunk copy = chunk;
+            copy.data = MessageView(data->data(), data->size());
+            Hooks::message_chunk(this->handler(), client_id, copy);
+        }, false);
     }
 
-    void NamedPipeServer::notify_disconnected(size_t index, const std::error_code& ec) {
-        if (!m_is_connected[index].load(std::memory_order_acquire)) return;
-        m_is_connected[index].store(false, std::memory_order_release);
-        if (m_connections[index]) m_connections[index]->invalidate();
-        if (m_event_handler) m_event_handler->on_disconnected(static_cast<int>(index), ec);
-        if (on_disconnected) on_disconnected(static_cast<int>(index), ec);
-        if (on_event) on_event(ServerEvent::client_disconnected(static_cast<int>(index), m_connections[index], ec));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_writable(size_t index) {
+        ClientRecord& client = m_clients[index];
+        if (!client.is_connected.load(std::memory_order_acquire)) return;
+        const int client_id = client_id_of(index);
+        if (!m_is_dispatching) {
+            Hooks::writable(this->handler(), client_id, client.connection);
+            return;
+        }
+        std::shared_ptr<Connection> connection = client.connection;
+        dispatch_callback(index, [this, client_id, connection] {
+            Hooks::writable(this->handler(), client_id, connection);
+        }, false);
     }
 
-    void NamedPipeServer::notify_message(size_t index) {
-        if (m_event_handler) m_event_handler->on_message(static_cast<int>(index), m_message_buffers[index]);
-        if (on_message) on_message(static_cast<int>(index), m_message_buffers[index]);
-        if (on_event) on_event(ServerEvent::message_received(static_cast<int>(index), m_connections[index], std::move(m_message_buffers[index])));
-        m_message_buffers[index].clear();
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_session_resumed(size_t index, int previous_client_id) {
+        ClientRecord& client = m_clients[index];
+        const int client_id = client_id_of(index);
+        if (!m_is_dispatching) {
+            Hooks::session_resumed(this->handler(), client_id, client.connection, previous_client_id);
+            return;
+        }
+        std::shared_ptr<Connection> connection = client.connection;
+        dispatch_callback(index, [this, client_id, connection, previous_client_id] {
+            Hooks::session_resumed(this->handler(), client_id, connection, previous_client_id);
+        }, false);
+    }
+
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_metrics(std::shared_ptr<const ServerMetrics> metrics) {
+        if (!m_is_dispatching) {
+            Hooks::metrics(this->handler(), std::move(metrics));
+            return;
+        }
+        dispatch_callback(SERVER_LANE, [this, metrics] {
+            Hooks::metrics(this->handler(), metrics);
+        }, false);
     }
 
-    void NamedPipeServer::notify_start(const ServerConfig& config) {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_start(const ServerConfig& config) {
         if (m_is_running.load(std::memory_order_acquire)) return;
         m_is_running.store(true, std::memory_order_release);
-        if (m_event_handler) m_event_handler->on_start(config);
-        if (on_start) on_start(config);
-        if (on_event) on_event(ServerEvent::server_started());
+        Hooks::start(this->handler(), config);
     }
 
-    void NamedPipeServer::notify_stop(const ServerConfig& config) {
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_stop(const ServerConfig& config) {
         if (!m_is_running.load(std::memory_order_acquire)) return;
+        // on_stop comes after every callback queued so far
+        m_callback_pool.drain();
         m_is_running.store(false, std::memory_order_release);
-        if (m_event_handler) m_event_handler->on_stop(config);
-        if (on_stop) on_stop(config);
-        if (on_event) on_event(ServerEvent::server_stopped());
+        Hooks::stop(this->handler(), config);
     }
 
-    void NamedPipeServer::notify_error(const std::error_code& ec) {
-        if (m_event_handler) m_event_handler->on_error(ec);
-        if (on_error) on_error(ec);
-        if (on_event) on_event(ServerEvent::error_occurred(ec));
+    template <class Handler>
+    void BasicNamedPipeServer<Handler>::notify_error(const std::error_code& ec) {
+        if (!m_is_dispatching) {
+            Hooks::error(this->handler(), ec);
+            return;
+        }
+        dispatch_callback(SERVER_LANE, [this, ec] {
+            Hooks::error(this->handler(), ec);
+        }, false);
+    }
+
+    template <class Handler>
+    bool BasicNamedPipeServer<Handler>::dispatch_callback(uintptr_t lane, std::function<void()>&& task, bool is_droppable) {
+        using Admission = detail::CallbackPool::Admission;
+        Admission admission = Admission::Wait;
+        if (m_callback_overflow != CallbackOverflowPolicy::Block) {
+            admission = is_droppable ? Admission::Try : Admission::Force;
+        }
+        if (m_callback_pool.push(lane, std::move(task), admission)) return true;
+        if (admission == Admission::Try && m_callback_pool.is_running()) return false;
+        // The pool is shutting down, push() left the task untouched
+        task();
+        return true;
     }
 };
@@ -0,0 +1,150 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_CALLBACKS_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_CALLBACKS_HPP_INCLUDED
+
+/// \file ServerCallbacks.hpp
+/// \brief Runtime-assignable callbacks, the handler of NamedPipeServer.
+
+#include "ServerHooks.hpp"
+#include "ServerEvent.hpp"
+#include "ServerEventHandler.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace SimpleNamedPipe {
+
+    /// \class ServerCallbacks
+    /// \brief Handler made of std::function members and an optional ServerEventHandler.
+    ///
+    /// NamedPipeServer derives from it, so the members are set on the server
+    /// itself. Every event costs an indirect call per assigned callback, and
+    /// `on_event` also a ServerEvent with a Connection reference; use
+    /// BasicNamedPipeServer with a handler class to avoid both.
+    class ServerCallbacks {
+    public:
+        // Callbacks
+        std::function<void(const ServerEvent&)>          on_event;
+        std::function<void(int)>                         on_connected;
+        std::function<void(int, const std::error_code&)> on_disconnected;
+        std::function<void(int, const std::string&)>     on_message;
+        std::function<void(int, MessageView)>            on_message_view; ///< Allocation-free, see MessageView
+        std::function<void(int, const MessageChunk&)>    on_message_chunk; ///< Streaming mode, see ReadLimits
+        std::function<void(int)>                         on_writable; ///< Queue drained to the low watermark
+        std::function<void(int, int)>                    on_session_resumed; ///< New and previous client id, see SessionConfig
+        std::function<void(const ServerMetrics&)>        on_metrics;  ///< Every MetricsConfig::report_interval_ms
+        std::function<void(const ServerConfig&)>         on_start;
+        std::function<void(const ServerConfig&)>         on_stop;
+        std::function<void(const std::error_code&)>      on_error;
+
+        /// \brief Sets a custom event handler instance.
+        /// \param handler Shared pointer to the handler.
+        void set_event_handler(std::shared_ptr<ServerEventHandler> handler) {
+            m_event_handler = std::move(handler);
+        }
+
+        /// \brief Returns the currently assigned event handler.
+        /// \return Shared pointer to the handler or nullptr.
+        std::shared_ptr<ServerEventHandler> get_event_handler() const {
+            return m_event_handler;
+        }
+
+    private:
+        friend struct ServerHooks<ServerCallbacks>;
+
+        std::shared_ptr<ServerEventHandler> m_event_handler;
+    };
+
+    /// \brief Calls the assigned callbacks in the order: event handler, callback, on_event.
+    template <>
+    struct ServerHooks<ServerCallbacks> {
+        static constexpr bool uses_connections = true;
+
+        static bool wants_message(const ServerCallbacks& h) {
+            return h.m_event_handler || h.on_message || h.on_event;
+        }
+
+        static void connected(ServerCallbacks& h, int client_id, const detail::ConnectionPtr& connection) {
+            if (h.m_event_handler) h.m_event_handler->on_connected(client_id);
+            if (h.on_connected) h.on_connected(client_id);
+            if (h.on_event) h.on_event(ServerEvent::client_connected(client_id, connection));
+        }
+
+        static void disconnected(ServerCallbacks& h, int client_id, const detail::ConnectionPtr& connection, const std::error_code& ec) {
+            if (h.m_event_handler) h.m_event_handler->on_disconnected(client_id, ec);
+            if (h.on_disconnected) h.on_disconnected(client_id, ec);
+            if (h.on_event) h.on_event(ServerEvent::client_disconnected(client_id, connection, ec));
+        }
+
+        static void message_view(ServerCallbacks& h, int client_id, MessageView message) {
+            if (h.m_event_handler) h.m_event_handler->on_message_view(client_id, message);
+            if (h.on_message_view) h.on_message_view(client_id, message);
+        }
+
+        static void message(ServerCallbacks& h, int client_id, const detail::ConnectionPtr& connection, std::string& message) {
+            if (h.m_event_handler) h.m_event_handler->on_message(client_id, message);
+            if (h.on_message) h.on_message(client_id, message);
+            // The event owns a copy; `message` is the client's message_buffer
+            if (h.on_event) h.on_event(ServerEvent::message_received(client_id, connection, std::string(message)));
+        }
+
+        static void message_chunk(ServerCallbacks& h, int client_id, const MessageChunk& chunk) {
+            if (h.m_event_handler) h.m_event_handler->on_message_chunk(client_id, chunk);
+            if (h.on_message_chunk) h.on_message_chunk(client_id, chunk);
+        }
+
+        static void writable(ServerCallbacks& h, int client_id, const detail::ConnectionPtr& connection) {
+            if (h.m_event_handler) h.m_event_handler->on_writable(client_id);
+            if (h.on_writable) h.on_writable(client_id);
+            if (h.on_event) h.on_event(ServerEvent::client_writable(client_id, connection));
+        }
+
+        static void session_resumed(ServerCallbacks& h, int client_id, const detail::ConnectionPtr& connection, int previous_client_id) {
+            if (h.m_event_handler) h.m_event_handler->on_session_resumed(client_id, previous_client_id);
+            if (h.on_session_resumed) h.on_session_resumed(client_id, previous_client_id);
+            if (h.on_event) h.on_event(ServerEvent::session_resumed(client_id, connection, previous_client_id));
+        }
+
+        static void metrics(ServerCallbacks& h, std::shared_ptr<const ServerMetrics> metrics) {
+            if (h.m_event_handler) h.m_event_handler->on_metrics(*metrics);
+            if (h.on_metrics) h.on_metrics(*metrics);
+            if (h.on_event) h.on_event(ServerEvent::metrics_reported(std::move(metrics)));
+        }
+
+        static void start(ServerCallbacks& h, const ServerConfig& config) {
+            if (h.m_event_handler) h.m_event_handler->on_start(config);
+            if (h.on_start) h.on_start(config);
+            if (h.on_event) h.on_event(ServerEvent::server_started());
+        }
+
+        static void stop(ServerCallbacks& h, const ServerConfig& config) {
+            if (h.m_event_handler) h.m_event_handler->on_stop(config);
+            if (h.on_stop) h.on_stop(config);
+            if (h.on_event) h.on_event(ServerEvent::server_stopped());
+        }
+
+        static void error(ServerCallbacks& h, const std::error_code& ec) {
+            if (h.m_event_handler) h.m_event_handler->on_error(ec);
+            if (h.on_error) h.on_error(ec);
+            if (h.on_event) h.on_event(ServerEvent::error_occurred(ec));
+        }
+    };
+
+namespace detail {
+
+    /// \brief NamedPipeServer exposes its callbacks as its own members.
+    template <>
+    class HandlerHolder<ServerCallbacks> : public ServerCallbacks {
+    public:
+        ServerCallbacks& handler() { return *this; }
+        const ServerCallbacks& handler() const { return *this; }
+
+    protected:
+        HandlerHolder() = default;
+        explicit HandlerHolder(ServerCallbacks&& handler) : ServerCallbacks(std::move(handler)) {}
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_CALLBACKS_HPP_INCLUDED
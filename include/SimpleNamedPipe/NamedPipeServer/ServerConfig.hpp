@@ -9,11 +9,174 @@
 
 namespace SimpleNamedPipe {
 
+    /// \brief What happens to a client whose queued bytes reach the high watermark.
+    enum class SlowConsumerPolicy {
+        Reject,     ///< New sends fail with NamedPipeErrc::QueueFull
+        DropOldest, ///< Queued messages not yet on the wire are dropped with NamedPipeErrc::MessageDropped
+        Disconnect  ///< The client is dropped with NamedPipeErrc::SlowConsumer after slow_consumer_timeout_ms
+    };
+
+    /// \brief Write lane of a message, see BasicNamedPipeServer::send_to().
+    ///
+    /// A message is written ahead of the queued lower-priority messages that
+    /// have not started yet. Without write batching it also gets in between
+    /// the chunks of a lower-priority message larger than buffer_size.
+    enum class SendPriority : int {
+        Low    = -1, ///< Bulk transfers, e.g. a history dump
+        Normal = 0,  ///< send_to() without a priority, broadcasts and heartbeats
+        High   = 1   ///< Small urgent messages, e.g. order acks
+    };
+
     /// \struct WriteQueueLimits
     /// \brief Limits for the write queue, including message count and single message size restrictions.
+    ///
+    /// Queued messages count until their write completes. With a high
+    /// watermark set, the slow-consumer policy applies once that many bytes are
+    /// queued for a client, and on_writable fires when the queue drains to the
+    /// low watermark again.
     struct WriteQueueLimits {
         size_t max_pending_writes_per_client = 1000;           ///< Max messages queued per client
         size_t max_message_size = 64 * 1024;                   ///< Max single message size (64 KB)
+        size_t high_watermark_bytes = 0;                       ///< Queued bytes that trigger the policy; 0 disables it
+        size_t low_watermark_bytes = 0;                        ///< Queued bytes at which on_writable fires; 0 uses half the high watermark
+        SlowConsumerPolicy slow_consumer = SlowConsumerPolicy::Reject; ///< Policy above the high watermark
+        size_t slow_consumer_timeout_ms = 1000;                ///< Time above the high watermark before Disconnect applies
+        size_t max_overtakes = 64;                             ///< Higher-priority messages written ahead of a queued one
+                                                               ///< before it goes next; 0 keeps the queue FIFO
+    };
+
+    /// \struct QueueDepth
+    /// \brief Data queued for one client and not yet written.
+    struct QueueDepth {
+        size_t messages = 0;
+        size_t bytes = 0;
+    };
+
+    /// \brief Action taken when a client sends a message above ReadLimits::max_message_size.
+    enum class OversizedMessagePolicy {
+        Disconnect, ///< Drop the client; on_disconnected gets NamedPipeErrc::IncomingMessageTooLarge
+        Discard     ///< Skip the message; on_error gets NamedPipeErrc::IncomingMessageTooLarge
+    };
+
+    /// \struct ReadLimits
+    /// \brief Limits and delivery mode for incoming messages.
+    struct ReadLimits {
+        size_t max_message_size = 0;    ///< Max incoming message size; 0 means unlimited
+        OversizedMessagePolicy oversized = OversizedMessagePolicy::Disconnect; ///< What to do with larger messages
+        bool   stream_large_messages = false; ///< Deliver messages larger than buffer_size chunk by chunk
+                                              ///< to on_message_chunk instead of assembling them
+    };
+
+    /// \struct WriteBatching
+    /// \brief Opt-in coalescing of consecutive queued messages into one write.
+    ///
+    /// A coalesced write carries several messages, so on message-mode pipes the
+    /// receiver gets them as one message. With `length_prefix` every message is
+    /// preceded by its size as a 32-bit little-endian integer and the receiver
+    /// splits the stream by it. `on_done` still fires once per message.
+    struct WriteBatching {
+        bool   enabled = false;         ///< Pack queued messages into one write
+        bool   length_prefix = true;    ///< Frame every message with a 4-byte length
+        size_t max_bytes = 0;           ///< Cap on one write; 0 uses buffer_size
+        size_t flush_delay_us = 0;      ///< Hold a partial batch up to this long for more messages; 0 writes at once.
+                                        ///< Kept to the microsecond: the last stretch before the deadline, one OS timer
+                                        ///< tick (1 ms on Linux, 15.6 ms on Windows), is polled on the I/O threads.
+    };
+
+    /// \struct MetricsConfig
+    /// \brief Collection and periodic reporting of server metrics.
+    struct MetricsConfig {
+        bool   enabled = true;          ///< Count traffic and time writes, see NamedPipeServer::get_metrics()
+        size_t report_interval_ms = 0;  ///< Period of the metrics event; 0 disables it
+    };
+
+    /// \brief What happens to a callback when CallbackDispatch::max_queued_events are already queued.
+    enum class CallbackOverflowPolicy {
+        Block,      ///< The I/O thread waits for a worker, which slows down reading from all clients
+        DropNewest, ///< Message callbacks are skipped and counted in ServerMetrics::dropped_callbacks
+        Disconnect  ///< The client is dropped with NamedPipeErrc::CallbackQueueFull
+    };
+
+    /// \struct CallbackDispatch
+    /// \brief Where user callbacks run.
+    ///
+    /// By default callbacks run on the I/O threads, so a slow handler stalls
+    /// reading and writing. With worker threads the I/O threads only queue the
+    /// events and a pool runs them; callbacks of one client still run one at a
+    /// time and in order. Connect, disconnect and chunk events are never
+    /// dropped, only whole messages are. Write `on_done` callbacks and
+    /// on_start/on_stop stay on the server threads.
+    struct CallbackDispatch {
+        size_t worker_threads = 0;      ///< Callback threads; 0 runs callbacks on the I/O threads
+        size_t max_queued_events = 10000; ///< Events waiting for a worker; 0 means unbounded
+        CallbackOverflowPolicy overflow = CallbackOverflowPolicy::Block; ///< What to do when the queue is full
+    };
+
+    /// \struct SharedMemoryConfig
+    /// \brief Shared-memory rings for clients on the same host.
+    ///
+    /// A client with ClientSharedMemoryConfig::enabled asks for the rings
+    /// when it connects. Accepted clients exchange messages through them, the
+    /// pipe then carries only wakeups, so send_to() and on_message work as
+    /// before without a syscall per message. Not available with write_batching.
+    struct SharedMemoryConfig {
+        bool   enabled = false;  ///< Accept the rings offered by clients
+        size_t spin_us = 0;      ///< Poll the ring this long after a wakeup before sleeping again;
+                                 ///< trades an I/O thread for lower latency
+    };
+
+    /// \struct KeepAliveConfig
+    /// \brief Idle detection and heartbeats.
+    ///
+    /// Both run on the I/O threads off the server's timer wheel with
+    /// millisecond resolution, no extra thread is started. New values apply
+    /// at a client's next check; turning either on with set_config() covers
+    /// clients that connect afterwards.
+    struct KeepAliveConfig {
+        size_t idle_timeout_ms = 0;       ///< Disconnect a client that sent nothing for this long with
+                                          ///< NamedPipeErrc::IdleTimeout; 0 disables it
+        size_t heartbeat_interval_ms = 0; ///< Send heartbeat_message after this long without a message
+                                          ///< queued for the client; 0 disables it
+        std::string heartbeat_message = "heartbeat"; ///< Payload of the heartbeat, must not be empty
+    };
+
+    /// \struct JournalConfig
+    /// \brief Recording of all traffic for replay, see JournalReader and the journal_replay benchmark.
+    ///
+    /// Inbound messages are recorded when they are delivered, outbound ones
+    /// when their write is posted. Records go to memory-mapped segment files
+    /// `<path>-NNNNNN.snpj` created with their full size, so recording costs a
+    /// copy under a lock and no syscall per message.
+    struct JournalConfig {
+        bool        enabled = false;               ///< Record traffic
+        std::string path = "snp-journal";          ///< Segment file prefix, may include a directory
+        size_t      segment_size = 64 * 1024 * 1024; ///< Bytes per segment file
+    };
+
+    /// \struct SessionConfig
+    /// \brief Resumable sessions for clients that reconnect.
+    ///
+    /// A client with ClientSessionConfig::enabled opens a session when it
+    /// connects. Every message to it then carries a sequence number, and the
+    /// newest `retransmit_bytes` of them are kept; heartbeats are numbered
+    /// but never kept or repeated. When the client reconnects
+    /// within `resume_timeout_ms`, it presents its session token and the last
+    /// sequence it has seen, and the server repeats only the messages after
+    /// it. Messages still queued when the connection dropped are kept too;
+    /// their `on_done` reports NamedPipeErrc::HeldForResume rather than
+    /// NotConnected, which is left for messages that are gone. Whether a held
+    /// message arrives is known only once the client resumes. `on_session_resumed`
+    /// tells the new client id. A session whose gap was evicted restarts,
+    /// and the client reports NamedPipeErrc::SessionFailed.
+    ///
+    /// Only the first chunk of a message carries its sequence number, so without
+    /// write batching a message to a session has to fit into `buffer_size`
+    /// together with its 8 bytes; a larger one fails with
+    /// NamedPipeErrc::MessageTooLarge.
+    struct SessionConfig {
+        bool   enabled = false;                 ///< Accept sessions offered by clients
+        size_t retransmit_bytes = 1024 * 1024;  ///< Bytes of sent messages kept per session
+        size_t resume_timeout_ms = 30000;       ///< How long a disconnected session waits for its client
     };
 
     /// \class ServerConfig
@@ -22,8 +185,23 @@ namespace SimpleNamedPipe {
     public:
         std::string      pipe_name;    ///< Named pipe name
         WriteQueueLimits write_limits; ///< Limits for the write queue
+        ReadLimits       read_limits;  ///< Limits for incoming messages
+        WriteBatching    write_batching; ///< Write coalescing, disabled by default
+        MetricsConfig    metrics;      ///< Traffic counters and latency histogram
+        CallbackDispatch callback_dispatch; ///< Run callbacks on a worker pool, disabled by default
+        SharedMemoryConfig shared_memory; ///< Fast path for co-located clients, disabled by default
+        KeepAliveConfig  keep_alive;   ///< Idle timeout and heartbeats, disabled by default
+        JournalConfig    journal;      ///< Traffic recording, disabled by default
+        SessionConfig    sessions;     ///< Resumable sessions, disabled by default
         size_t           buffer_size;  ///< Size of I/O buffers
         size_t           timeout;      ///< Timeout in milliseconds
+        size_t           io_threads = 1; ///< Threads dequeuing completions; callbacks of different clients may then run concurrently.
+                                         ///< Only a single thread dequeues up to 64 completions per call; several take one each
+        size_t           io_spin_us = 0; ///< Poll for completions this long before blocking in the kernel;
+                                         ///< lower wakeup latency for a core per I/O thread. A poll returns a batch
+                                         ///< of completions only with io_threads == 1
+        size_t           listen_instances = 4; ///< Idle listening instances kept armed; one is added per accepted client
+        size_t           max_clients = 0;      ///< Max connected plus listening instances, further clients wait for a free one; 0 means the client id capacity
 
         /// \brief Construct with optional parameters.
         /// \param pipe_name Name of the pipe.
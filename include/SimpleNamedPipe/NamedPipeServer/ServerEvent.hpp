@@ -9,6 +9,7 @@
 namespace SimpleNamedPipe {
 
     class Connection;
+    struct ServerMetrics;
 
     /// \brief Type of server-side event.
     enum class ServerEventType {
@@ -17,6 +18,9 @@ namespace SimpleNamedPipe {
         ClientConnected,
         ClientDisconnected,
         MessageReceived,
+        ClientWritable,
+        SessionResumed,
+        MetricsReported,
         ErrorOccurred
     };
 
@@ -28,6 +32,8 @@ namespace SimpleNamedPipe {
         std::shared_ptr<Connection> connection;      ///< Optional connection wrapper
         std::string message;                         ///< Message buffer (for Message events)
         std::error_code error;                       ///< Error info (for Error and Close events)
+        std::shared_ptr<const ServerMetrics> metrics; ///< Snapshot (for Metrics events)
+        int previous_client_id = -1;                 ///< Client the session belonged to (for SessionResumed events)
 
         // --- Constructors ---
         ServerEvent(ServerEventType type)
@@ -69,6 +75,22 @@ namespace SimpleNamedPipe {
             return ServerEvent(ServerEventType::MessageReceived, id, std::move(conn), std::move(msg));
         }
 
+        static inline ServerEvent client_writable(int id, std::shared_ptr<Connection> conn) {
+            return ServerEvent(ServerEventType::ClientWritable, id, std::move(conn));
+        }
+
+        static inline ServerEvent session_resumed(int id, std::shared_ptr<Connection> conn, int previous_id) {
+            ServerEvent event(ServerEventType::SessionResumed, id, std::move(conn));
+            event.previous_client_id = previous_id;
+            return event;
+        }
+
+        static inline ServerEvent metrics_reported(std::shared_ptr<const ServerMetrics> metrics) {
+            ServerEvent event(ServerEventType::MetricsReported);
+            event.metrics = std::move(metrics);
+            return event;
+        }
+
         static inline ServerEvent error_occurred(const std::error_code& ec) {
             return ServerEvent(ServerEventType::ErrorOccurred, ec);
         }
@@ -16,6 +16,11 @@ namespace SimpleNamedPipe {
         virtual void on_connected(int client_id) {}
         virtual void on_disconnected(int client_id, const std::error_code& ec) {}
         virtual void on_message(int client_id, const std::string& message) {}
+        virtual void on_message_view(int client_id, MessageView message) {}
+        virtual void on_message_chunk(int client_id, const MessageChunk& chunk) {}
+        virtual void on_writable(int client_id) {}
+        virtual void on_session_resumed(int client_id, int previous_client_id) {}
+        virtual void on_metrics(const ServerMetrics& metrics) {}
         virtual void on_start(const ServerConfig& config) {}
         virtual void on_stop(const ServerConfig& config) {}
         virtual void on_error(const std::error_code& ec) {}
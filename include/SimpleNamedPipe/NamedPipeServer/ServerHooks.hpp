@@ -0,0 +1,272 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_HOOKS_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_HOOKS_HPP_INCLUDED
+
+/// \file ServerHooks.hpp
+/// \brief Compile-time dispatch of server events to a handler type.
+///
+/// BasicNamedPipeServer<Handler> calls the handler through ServerHooks<Handler>.
+/// The handler is a plain class; it implements only the events it needs:
+///
+///     void on_connected(int client_id);
+///     void on_disconnected(int client_id, const std::error_code& ec);
+///     void on_message_view(int client_id, MessageView message);
+///     void on_message(int client_id, const std::string& message);
+///     void on_message_chunk(int client_id, const MessageChunk& chunk);
+///     void on_writable(int client_id);
+///     void on_session_resumed(int client_id, int previous_client_id);
+///     void on_metrics(const ServerMetrics& metrics);
+///     void on_start(const ServerConfig& config);
+///     void on_stop(const ServerConfig& config);
+///     void on_error(const std::error_code& ec);
+///
+/// Calls are direct and can be inlined; a missing member compiles to
+/// nothing, and without `on_message` the string copy of a message is skipped
+/// too. The client id is the handle to reply with. A handler that wants the
+/// Connection wrapper takes `const std::shared_ptr<Connection>&` after the
+/// client id in on_connected, on_disconnected, on_message or on_writable; the
+/// server then creates one per client, otherwise it never allocates it.
+
+#include "errors.hpp"
+#include "IConnection.hpp"
+#include "Connection.hpp"
+#include "MessageView.hpp"
+#include "ServerConfig.hpp"
+#include "ServerMetrics.hpp"
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    template <class...>
+    struct make_void { typedef void type; };
+
+    /// \brief Overload priority: rank<2> is tried before rank<1>.
+    template <int N> struct rank : rank<N - 1> {};
+    template <> struct rank<0> {};
+
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    template <class H, class = void>
+    struct has_connected_with_connection : std::false_type {};
+    template <class H>
+    struct has_connected_with_connection<H, typename make_void<decltype(
+        std::declval<H&>().on_connected(0, std::declval<const ConnectionPtr&>()))>::type> : std::true_type {};
+
+    template <class H, class = void>
+    struct has_disconnected_with_connection : std::false_type {};
+    template <class H>
+    struct has_disconnected_with_connection<H, typename make_void<decltype(
+        std::declval<H&>().on_disconnected(0, std::declval<const ConnectionPtr&>(), std::declval<const std::error_code&>()))>::type> : std::true_type {};
+
+    template <class H, class = void>
+    struct has_message_with_connection : std::false_type {};
+    template <class H>
+    struct has_message_with_connection<H, typename make_void<decltype(
+        std::declval<H&>().on_message(0, std::declval<const ConnectionPtr&>(), std::declval<std::string&>()))>::type> : std::true_type {};
+
+    template <class H, class = void>
+    struct has_writable_with_connection : std::false_type {};
+    template <class H>
+    struct has_writable_with_connection<H, typename make_void<decltype(
+        std::declval<H&>().on_writable(0, std::declval<const ConnectionPtr&>()))>::type> : std::true_type {};
+
+    template <class H, class = void>
+    struct has_message : has_message_with_connection<H> {};
+    template <class H>
+    struct has_message<H, typename make_void<decltype(
+        std::declval<H&>().on_message(0, std::declval<std::string&>()))>::type> : std::true_type {};
+
+} // namespace detail
+
+    /// \struct ServerHooks
+    /// \brief Calls the events a handler implements and skips the rest.
+    ///
+    /// Specialize it to adapt a handler with a different interface; the
+    /// specialization for ServerCallbacks is the type-erased NamedPipeServer.
+    template <class Handler>
+    struct ServerHooks {
+        /// \brief Whether the server has to create a Connection per client.
+        static constexpr bool uses_connections =
+            detail::has_connected_with_connection<Handler>::value ||
+            detail::has_disconnected_with_connection<Handler>::value ||
+            detail::has_message_with_connection<Handler>::value ||
+            detail::has_writable_with_connection<Handler>::value;
+
+        /// \brief Whether a message has to be copied into a string for on_message.
+        static constexpr bool wants_message(const Handler&) {
+            return detail::has_message<Handler>::value;
+        }
+
+        static void connected(Handler& h, int client_id, const detail::ConnectionPtr& connection) {
+            connected(h, client_id, connection, detail::rank<2>());
+        }
+
+        static void disconnected(Handler& h, int client_id, const detail::ConnectionPtr& connection, const std::error_code& ec) {
+            disconnected(h, client_id, connection, ec, detail::rank<2>());
+        }
+
+        static void message_view(Handler& h, int client_id, MessageView message) {
+            message_view(h, client_id, message, detail::rank<1>());
+        }
+
+        /// \param text Owned copy; a handler may move from it.
+        static void message(Handler& h, int client_id, const detail::ConnectionPtr& connection, std::string& text) {
+            message(h, client_id, connection, text, detail::rank<2>());
+        }
+
+        static void message_chunk(Handler& h, int client_id, const MessageChunk& chunk) {
+            message_chunk(h, client_id, chunk, detail::rank<1>());
+        }
+
+        static void writable(Handler& h, int client_id, const detail::ConnectionPtr& connection) {
+            writable(h, client_id, connection, detail::rank<2>());
+        }
+
+        static void session_resumed(Handler& h, int client_id, const detail::ConnectionPtr&, int previous_client_id) {
+            session_resumed(h, client_id, previous_client_id, detail::rank<1>());
+        }
+
+        static void metrics(Handler& h, std::shared_ptr<const ServerMetrics> snapshot) {
+            metrics(h, *snapshot, detail::rank<1>());
+        }
+
+        static void start(Handler& h, const ServerConfig& config) {
+            start(h, config, detail::rank<1>());
+        }
+
+        static void stop(Handler& h, const ServerConfig& config) {
+            stop(h, config, detail::rank<1>());
+        }
+
+        static void error(Handler& h, const std::error_code& ec) {
+            error(h, ec, detail::rank<1>());
+        }
+
+    private:
+        template <class H>
+        static auto connected(H& h, int id, const detail::ConnectionPtr& c, detail::rank<2>) -> decltype(h.on_connected(id, c), void()) {
+            h.on_connected(id, c);
+        }
+        template <class H>
+        static auto connected(H& h, int id, const detail::ConnectionPtr&, detail::rank<1>) -> decltype(h.on_connected(id), void()) {
+            h.on_connected(id);
+        }
+        template <class H>
+        static void connected(H&, int, const detail::ConnectionPtr&, detail::rank<0>) {}
+
+        template <class H>
+        static auto disconnected(H& h, int id, const detail::ConnectionPtr& c, const std::error_code& ec, detail::rank<2>) -> decltype(h.on_disconnected(id, c, ec), void()) {
+            h.on_disconnected(id, c, ec);
+        }
+        template <class H>
+        static auto disconnected(H& h, int id, const detail::ConnectionPtr&, const std::error_code& ec, detail::rank<1>) -> decltype(h.on_disconnected(id, ec), void()) {
+            h.on_disconnected(id, ec);
+        }
+        template <class H>
+        static void disconnected(H&, int, const detail::ConnectionPtr&, const std::error_code&, detail::rank<0>) {}
+
+        template <class H>
+        static auto message_view(H& h, int id, MessageView m, detail::rank<1>) -> decltype(h.on_message_view(id, m), void()) {
+            h.on_message_view(id, m);
+        }
+        template <class H>
+        static void message_view(H&, int, MessageView, detail::rank<0>) {}
+
+        template <class H>
+        static auto message(H& h, int id, const detail::ConnectionPtr& c, std::string& m, detail::rank<2>) -> decltype(h.on_message(id, c, m), void()) {
+            h.on_message(id, c, m);
+        }
+        template <class H>
+        static auto message(H& h, int id, const detail::ConnectionPtr&, std::string& m, detail::rank<1>) -> decltype(h.on_message(id, m), void()) {
+            h.on_message(id, m);
+        }
+        template <class H>
+        static void message(H&, int, const detail::ConnectionPtr&, std::string&, detail::rank<0>) {}
+
+        template <class H>
+        static auto message_chunk(H& h, int id, const MessageChunk& chunk, detail::rank<1>) -> decltype(h.on_message_chunk(id, chunk), void()) {
+            h.on_message_chunk(id, chunk);
+        }
+        template <class H>
+        static void message_chunk(H&, int, const MessageChunk&, detail::rank<0>) {}
+
+        template <class H>
+        static auto writable(H& h, int id, const detail::ConnectionPtr& c, detail::rank<2>) -> decltype(h.on_writable(id, c), void()) {
+            h.on_writable(id, c);
+        }
+        template <class H>
+        static auto writable(H& h, int id, const detail::ConnectionPtr&, detail::rank<1>) -> decltype(h.on_writable(id), void()) {
+            h.on_writable(id);
+        }
+        template <class H>
+        static void writable(H&, int, const detail::ConnectionPtr&, detail::rank<0>) {}
+
+        template <class H>
+        static auto session_resumed(H& h, int id, int previous_id, detail::rank<1>) -> decltype(h.on_session_resumed(id, previous_id), void()) {
+            h.on_session_resumed(id, previous_id);
+        }
+        template <class H>
+        static void session_resumed(H&, int, int, detail::rank<0>) {}
+
+        template <class H>
+        static auto metrics(H& h, const ServerMetrics& m, detail::rank<1>) -> decltype(h.on_metrics(m), void()) {
+            h.on_metrics(m);
+        }
+        template <class H>
+        static void metrics(H&, const ServerMetrics&, detail::rank<0>) {}
+
+        template <class H>
+        static auto start(H& h, const ServerConfig& config, detail::rank<1>) -> decltype(h.on_start(config), void()) {
+            h.on_start(config);
+        }
+        template <class H>
+        static void start(H&, const ServerConfig&, detail::rank<0>) {}
+
+        template <class H>
+        static auto stop(H& h, const ServerConfig& config, detail::rank<1>) -> decltype(h.on_stop(config), void()) {
+            h.on_stop(config);
+        }
+        template <class H>
+        static void stop(H&, const ServerConfig&, detail::rank<0>) {}
+
+        template <class H>
+        static auto error(H& h, const std::error_code& ec, detail::rank<1>) -> decltype(h.on_error(ec), void()) {
+            h.on_error(ec);
+        }
+        template <class H>
+        static void error(H&, const std::error_code&, detail::rank<0>) {}
+    };
+
+    template <class Handler>
+    constexpr bool ServerHooks<Handler>::uses_connections;
+
+namespace detail {
+
+    /// \class HandlerHolder
+    /// \brief Owns the handler of BasicNamedPipeServer.
+    template <class Handler>
+    class HandlerHolder {
+    public:
+        /// \brief Returns the handler the server calls.
+        Handler& handler() { return m_handler; }
+        const Handler& handler() const { return m_handler; }
+
+    protected:
+        HandlerHolder() = default;
+        explicit HandlerHolder(Handler&& handler) : m_handler(std::move(handler)) {}
+
+    private:
+        Handler m_handler;
+    };
+
+} // namespace detail
+
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_HOOKS_HPP_INCLUDED
@@ -0,0 +1,189 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_METRICS_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_METRICS_HPP_INCLUDED
+
+/// \file ServerMetrics.hpp
+/// \brief Counters and write latency histogram exposed by NamedPipeServer::get_metrics().
+
+#include "ServerConfig.hpp"
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace SimpleNamedPipe {
+
+    /// \struct LatencyHistogram
+    /// \brief Log2-bucketed histogram of microsecond latencies.
+    ///
+    /// Bucket 0 counts latencies below 1 us, bucket i counts [2^(i-1), 2^i) us
+    /// and the last bucket everything above.
+    struct LatencyHistogram {
+        static constexpr size_t BUCKETS = 32;
+        std::array<uint64_t, BUCKETS> counts{};
+
+        /// \brief Bucket index of a latency.
+        static size_t bucket_of(uint64_t us) {
+            size_t bucket = 0;
+            while (us && bucket < BUCKETS - 1) {
+                ++bucket;
+                us >>= 1;
+            }
+            return bucket;
+        }
+
+        /// \brief Upper bound of a bucket in microseconds.
+        static uint64_t upper_bound_us(size_t bucket) {
+            return uint64_t(1) << bucket;
+        }
+
+        /// \brief Number of recorded samples.
+        uint64_t total() const {
+            uint64_t sum = 0;
+            for (uint64_t c : counts) sum += c;
+            return sum;
+        }
+
+        /// \brief Upper bound of the bucket holding the given quantile.
+        /// \param q Quantile in [0, 1], e.g. 0.99.
+        /// \return Latency in microseconds, 0 if the histogram is empty.
+        uint64_t percentile_us(double q) const {
+            const uint64_t n = total();
+            if (n == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(n));
+            if (rank >= n) rank = n - 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                seen += counts[i];
+                if (seen > rank) return upper_bound_us(i);
+            }
+            return upper_bound_us(BUCKETS - 1);
+        }
+
+        LatencyHistogram& operator+=(const LatencyHistogram& other) {
+            for (size_t i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+            return *this;
+        }
+    };
+
+    /// \struct ConnectionMetrics
+    /// \brief Traffic counters of one client or of the whole server.
+    struct ConnectionMetrics {
+        uint64_t messages_in = 0;       ///< Messages received
+        uint64_t bytes_in = 0;          ///< Payload bytes received
+        uint64_t messages_out = 0;      ///< Messages written successfully
+        uint64_t bytes_out = 0;         ///< Payload bytes written successfully
+        uint64_t failed_writes = 0;     ///< Queued messages completed with an error
+        uint64_t rejected_writes = 0;   ///< Sends refused by the queue limits (QueueFull, MessageTooLarge)
+        uint64_t dropped_writes = 0;    ///< Messages dropped by SlowConsumerPolicy::DropOldest
+        uint64_t superseded_writes = 0; ///< Conflated messages replaced by a newer one
+        LatencyHistogram write_latency; ///< From send_to() to write completion
+
+        ConnectionMetrics& operator+=(const ConnectionMetrics& other) {
+            messages_in += other.messages_in;
+            bytes_in += other.bytes_in;
+            messages_out += other.messages_out;
+            bytes_out += other.bytes_out;
+            failed_writes += other.failed_writes;
+            rejected_writes += other.rejected_writes;
+            dropped_writes += other.dropped_writes;
+            superseded_writes += other.superseded_writes;
+            write_latency += other.write_latency;
+            return *this;
+        }
+    };
+
+    /// \struct ClientMetrics
+    /// \brief Counters and queue depth of one connected client.
+    struct ClientMetrics {
+        int               client_id = -1;
+        ConnectionMetrics traffic;
+        QueueDepth        queued;       ///< Messages and bytes waiting to be written
+    };
+
+    /// \struct ServerMetrics
+    /// \brief Snapshot returned by NamedPipeServer::get_metrics().
+    ///
+    /// Counters are read with relaxed loads while the server runs, so
+    /// totals of one snapshot may be off by messages in flight.
+    struct ServerMetrics {
+        uint64_t          connects = 0;     ///< Clients connected since start
+        uint64_t          disconnects = 0;  ///< Clients disconnected since start
+        size_t            connected_clients = 0;
+        uint64_t          dropped_callbacks = 0; ///< Messages skipped by CallbackOverflowPolicy::DropNewest
+        uint64_t          io_waits = 0;     ///< Completion-queue dequeues, at most one system call each
+        uint64_t          io_events = 0;    ///< Events they returned; one dequeue takes up to 64 with one I/O thread
+        ConnectionMetrics traffic;          ///< All clients, including disconnected ones
+        QueueDepth        queued;           ///< Sum over connected clients
+        std::vector<ClientMetrics> clients; ///< Connected clients
+    };
+
+namespace detail {
+
+    /// \class TrafficCounters
+    /// \brief Live counterpart of ConnectionMetrics.
+    ///
+    /// add() is for counters with a single writer, the client's strand: a
+    /// relaxed load and store avoid a locked read-modify-write on the hot path.
+    /// Counters bumped by producer threads use fetch_add().
+    class TrafficCounters {
+    public:
+        std::atomic<uint64_t> messages_in{0};
+        std::atomic<uint64_t> bytes_in{0};
+        std::atomic<uint64_t> messages_out{0};
+        std::atomic<uint64_t> bytes_out{0};
+        std::atomic<uint64_t> failed_writes{0};
+        std::atomic<uint64_t> rejected_writes{0};   ///< Producer threads
+        std::atomic<uint64_t> dropped_writes{0};
+        std::atomic<uint64_t> superseded_writes{0}; ///< Producer threads
+        std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> latency;
+
+        TrafficCounters() {
+            for (auto& c : latency) c.store(0, std::memory_order_relaxed);
+        }
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void record_latency(uint64_t us) {
+            add(latency[LatencyHistogram::bucket_of(us)], 1);
+        }
+
+        /// \brief Copies the counters.
+        void load(ConnectionMetrics& out) const {
+            out.messages_in = messages_in.load(std::memory_order_relaxed);
+            out.bytes_in = bytes_in.load(std::memory_order_relaxed);
+            out.messages_out = messages_out.load(std::memory_order_relaxed);
+            out.bytes_out = bytes_out.load(std::memory_order_relaxed);
+            out.failed_writes = failed_writes.load(std::memory_order_relaxed);
+            out.rejected_writes = rejected_writes.load(std::memory_order_relaxed);
+            out.dropped_writes = dropped_writes.load(std::memory_order_relaxed);
+            out.superseded_writes = superseded_writes.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                out.write_latency.counts[i] = latency[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        /// \brief Moves the counters out and resets them.
+        void take(ConnectionMetrics& out) {
+            out.messages_in = messages_in.exchange(0, std::memory_order_relaxed);
+            out.bytes_in = bytes_in.exchange(0, std::memory_order_relaxed);
+            out.messages_out = messages_out.exchange(0, std::memory_order_relaxed);
+            out.bytes_out = bytes_out.exchange(0, std::memory_order_relaxed);
+            out.failed_writes = failed_writes.exchange(0, std::memory_order_relaxed);
+            out.rejected_writes = rejected_writes.exchange(0, std::memory_order_relaxed);
+            out.dropped_writes = dropped_writes.exchange(0, std::memory_order_relaxed);
+            out.superseded_writes = superseded_writes.exchange(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                out.write_latency.counts[i] = latency[i].exchange(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_METRICS_HPP_INCLUDED
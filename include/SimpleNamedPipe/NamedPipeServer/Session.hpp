@@ -0,0 +1,170 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SESSION_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SESSION_HPP_INCLUDED
+
+/// \file Session.hpp
+/// \brief Wire format and retransmit buffer of resumable sessions.
+///
+/// A client with sessions enabled sends a hello as its first message: the
+/// token of the session it wants to resume (all zero for a new one) and the
+/// last sequence number it has seen. The server answers with a welcome that
+/// carries the token and whether the session was resumed. Every message the
+/// server writes after the welcome starts with its 8-byte little-endian
+/// sequence number; a resumed session first repeats the kept messages the
+/// client has not seen.
+
+#include "Buffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    static constexpr char SESSION_MAGIC[7] = {'\0', 'S', 'N', 'P', 'S', 'E', 'S'};
+    static constexpr char SESSION_HELLO = 1;
+    static constexpr char SESSION_WELCOME = 2;
+    static constexpr size_t SESSION_TOKEN_SIZE = 16;
+    static constexpr size_t SEQUENCE_SIZE = 8;
+
+    /// \brief Server answer to a hello.
+    enum class SessionStatus : char {
+        New     = 0, ///< A new session; an asked-for one has expired or lost messages
+        Resumed = 1, ///< The missed messages follow the welcome
+        Refused = 2  ///< Sessions are disabled on the server
+    };
+
+    inline bool is_session_message(const char* data, size_t size, char kind) {
+        return size > sizeof(SESSION_MAGIC) &&
+            std::memcmp(data, SESSION_MAGIC, sizeof(SESSION_MAGIC)) == 0 &&
+            data[sizeof(SESSION_MAGIC)] == kind;
+    }
+
+    inline void write_sequence(char* out, uint64_t sequence) {
+        for (size_t i = 0; i < SEQUENCE_SIZE; ++i) out[i] = static_cast<char>((sequence >> (8 * i)) & 0xFF);
+    }
+
+    inline uint64_t read_sequence(const char* data) {
+        uint64_t sequence = 0;
+        for (size_t i = 0; i < SEQUENCE_SIZE; ++i) {
+            sequence |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return sequence;
+    }
+
+    /// \brief First client message: magic, kind, token, last seen sequence (LE).
+    /// \param token Session to resume; empty for a new one.
+    inline std::string make_session_hello(const std::string& token, uint64_t last_sequence) {
+        std::string message(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+        message += SESSION_HELLO;
+        message += token.size() == SESSION_TOKEN_SIZE ? token : std::string(SESSION_TOKEN_SIZE, '\0');
+        char sequence[SEQUENCE_SIZE];
+        write_sequence(sequence, last_sequence);
+        return message.append(sequence, SEQUENCE_SIZE);
+    }
+
+    /// \param token Receives the token, empty if the client asks for a new session.
+    inline bool parse_session_hello(const char* data, size_t size, std::string& token, uint64_t& last_sequence) {
+        const size_t fixed = sizeof(SESSION_MAGIC) + 1;
+        if (size != fixed + SESSION_TOKEN_SIZE + SEQUENCE_SIZE || !is_session_message(data, size, SESSION_HELLO)) return false;
+        token.assign(data + fixed, SESSION_TOKEN_SIZE);
+        if (token == std::string(SESSION_TOKEN_SIZE, '\0')) token.clear();
+        last_sequence = read_sequence(data + fixed + SESSION_TOKEN_SIZE);
+        return true;
+    }
+
+    /// \brief A new token, every byte drawn from std::random_device.
+    ///
+    /// Tokens are the only credential for resuming, so they are not derived
+    /// from a seeded generator. A zero token is reserved for the hello.
+    /// \throws std::exception if the entropy source fails.
+    inline std::string make_session_token() {
+        std::random_device random;
+        const std::string zero(SESSION_TOKEN_SIZE, '\0');
+        std::string token;
+        do {
+            token.clear();
+            while (token.size() < SESSION_TOKEN_SIZE) {
+                const std::random_device::result_type bits = random();
+                const size_t count = (std::min)(sizeof(bits), SESSION_TOKEN_SIZE - token.size());
+                token.append(reinterpret_cast<const char*>(&bits), count);
+            }
+        } while (token == zero);
+        return token;
+    }
+
+    /// \brief Server answer: magic, kind, token, status.
+    inline std::string make_session_welcome(const std::string& token, SessionStatus status) {
+        std::string message(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+        message += SESSION_WELCOME;
+        message += token.size() == SESSION_TOKEN_SIZE ? token : std::string(SESSION_TOKEN_SIZE, '\0');
+        message += static_cast<char>(status);
+        return message;
+    }
+
+    inline bool parse_session_welcome(const char* data, size_t size, std::string& token, SessionStatus& status) {
+        const size_t fixed = sizeof(SESSION_MAGIC) + 1;
+        if (size != fixed + SESSION_TOKEN_SIZE + 1 || !is_session_message(data, size, SESSION_WELCOME)) return false;
+        token.assign(data + fixed, SESSION_TOKEN_SIZE);
+        const char value = data[size - 1];
+        if (value != static_cast<char>(SessionStatus::New) && value != static_cast<char>(SessionStatus::Resumed)) {
+            status = SessionStatus::Refused;
+        } else {
+            status = static_cast<SessionStatus>(value);
+        }
+        return true;
+    }
+
+    /// \class RetransmitRing
+    /// \brief The newest sequenced messages of a session, bounded in bytes.
+    ///
+    /// Holds the payloads with their sequence numbers, sharing the buffers of
+    /// the original sends. Sequence numbers ascend with gaps where heartbeats
+    /// went out; the oldest messages are evicted once the kept bytes exceed
+    /// the capacity.
+    class RetransmitRing {
+    public:
+        /// \brief Sets the byte budget; takes effect with the next push().
+        void set_capacity(size_t bytes) { m_capacity = bytes; }
+
+        /// \brief Keeps a message, evicting the oldest ones over the budget.
+        /// Each one counts with its sequence number, as written.
+        void push(uint64_t sequence, BufferPtr payload) {
+            m_bytes += SEQUENCE_SIZE + payload->size();
+            m_entries.emplace_back(sequence, std::move(payload));
+            while (!m_entries.empty() && m_bytes > m_capacity) {
+                m_bytes -= SEQUENCE_SIZE + m_entries.front().second->size();
+                m_evicted = m_entries.front().first;
+                m_entries.pop_front();
+            }
+        }
+
+        /// \brief Whether every message after `sequence` is still kept.
+        bool covers(uint64_t sequence) const { return sequence >= m_evicted; }
+
+        /// \brief Appends the kept (sequence, payload) pairs after `sequence` in order.
+        template <class Container>
+        void collect_after(uint64_t sequence, Container& out) const {
+            for (const auto& entry : m_entries) {
+                if (entry.first > sequence) out.push_back(entry);
+            }
+        }
+
+        size_t bytes() const { return m_bytes; }
+
+    private:
+        std::deque<std::pair<uint64_t, BufferPtr>> m_entries;
+        size_t   m_bytes = 0;
+        size_t   m_capacity = 0;
+        uint64_t m_evicted = 0; ///< Newest sequence no longer kept
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SESSION_HPP_INCLUDED
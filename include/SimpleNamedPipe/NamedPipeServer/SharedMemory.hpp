@@ -0,0 +1,144 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SHARED_MEMORY_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SHARED_MEMORY_HPP_INCLUDED
+
+/// \file SharedMemory.hpp
+/// \brief Named shared memory region: POSIX shm on Unix, a file mapping on Windows.
+
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class SharedMemory
+    /// \brief Maps a named region into the process.
+    ///
+    /// One side create()s the region under a fresh name and passes the name
+    /// on, the other open()s it. On Unix the name stays in /dev/shm until
+    /// remove() is called; either side may do that once both have mapped it.
+    class SharedMemory {
+    public:
+        SharedMemory() = default;
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+
+        ~SharedMemory() {
+            close();
+        }
+
+        /// \brief Name prefix of the regions created by this library.
+        static const char* prefix() {
+#if defined(_WIN32)
+            return "Local\\snp-";
+#else
+            return "/snp-";
+#endif
+        }
+
+        /// \brief Creates a zero-filled region; fails if the name exists.
+        bool create(const std::string& name, size_t size, std::error_code& ec) {
+            return map(name, size, true, ec);
+        }
+
+        /// \brief Maps an existing region of at least `size` bytes.
+        bool open(const std::string& name, size_t size, std::error_code& ec) {
+            return map(name, size, false, ec);
+        }
+
+        /// \brief Unmaps the region.
+        void close() {
+#if defined(_WIN32)
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            m_mapping = nullptr;
+#else
+            if (m_data) ::munmap(m_data, m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        /// \brief Removes the name; mapped views stay valid. No-op on Windows.
+        static void remove(const std::string& name) {
+#if !defined(_WIN32)
+            ::shm_unlink(name.c_str());
+#else
+            (void)name;
+#endif
+        }
+
+        char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        char*  m_data = nullptr;
+        size_t m_size = 0;
+#if defined(_WIN32)
+        HANDLE m_mapping = nullptr;
+#endif
+
+        bool map(const std::string& name, size_t size, bool is_create, std::error_code& ec) {
+            close();
+#if defined(_WIN32)
+            const std::wstring wide_name(name.begin(), name.end());
+            const unsigned long long total = size;
+            m_mapping = is_create
+                ? CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(total >> 32), static_cast<DWORD>(total & 0xFFFFFFFF), wide_name.c_str())
+                : OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, wide_name.c_str());
+            if (!m_mapping || (is_create && GetLastError() == ERROR_ALREADY_EXISTS)) {
+                ec = std::error_code(m_mapping ? ERROR_ALREADY_EXISTS : static_cast<int>(GetLastError()), std::system_category());
+                close();
+                return false;
+            }
+            m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+            if (!m_data) {
+                ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+                close();
+                return false;
+            }
+#else
+            int fd = ::shm_open(name.c_str(), is_create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+            if (fd < 0) {
+                ec = std::error_code(errno, std::system_category());
+                return false;
+            }
+            struct stat info;
+            bool is_sized = is_create ? ::ftruncate(fd, static_cast<off_t>(size)) == 0
+                                      : ::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= size;
+            if (!is_sized) {
+                ec = errno ? std::error_code(errno, std::system_category()) : std::make_error_code(std::errc::invalid_argument);
+                ::close(fd);
+                if (is_create) ::shm_unlink(name.c_str());
+                return false;
+            }
+            void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED) {
+                ec = std::error_code(errno, std::system_category());
+                if (is_create) ::shm_unlink(name.c_str());
+                return false;
+            }
+            m_data = static_cast<char*>(data);
+#endif
+            m_size = size;
+            ec.clear();
+            return true;
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SHARED_MEMORY_HPP_INCLUDED
@@ -0,0 +1,387 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SHARED_RING_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SHARED_RING_HPP_INCLUDED
+
+/// \file SharedRing.hpp
+/// \brief SPSC message rings in shared memory, the fast path between co-located peers.
+///
+/// The client creates a region with two rings, client-to-server and
+/// server-to-client, and sends its name over the pipe as the first message
+/// (see make_shared_memory_request()). Once the server has answered, messages
+/// move through the rings and the pipe carries only one-byte wakeups: a
+/// consumer that found its ring empty raises `consumer_waiting` and sleeps on
+/// the pipe, and the producer that publishes the next record clears the flag
+/// and sends the wakeup. A producer facing a full ring does the same with
+/// `producer_waiting`.
+
+#include "SharedMemory.hpp"
+#include "MessageView.hpp"
+#include "errors.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <system_error>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \brief Cursors and wait flags of one ring, each side's fields on its own cache line.
+    struct RingControl {
+        alignas(64) std::atomic<uint64_t> head;             ///< Bytes published, written by the producer
+        alignas(64) std::atomic<uint64_t> tail;             ///< Bytes consumed, written by the consumer
+        alignas(64) std::atomic<uint32_t> consumer_waiting; ///< The consumer sleeps until a wakeup
+        std::atomic<uint32_t>             producer_waiting; ///< The producer waits for room
+    };
+
+    /// \class SharedRing
+    /// \brief One direction of a SharedChannel.
+    ///
+    /// A record is a 32-bit length and the payload, padded to 8 bytes; records
+    /// never wrap, the rest of the ring is skipped with a WRAP marker instead.
+    /// Each side uses either the producer or the consumer half. Lengths read
+    /// from the peer are checked, so a broken peer cannot make the consumer
+    /// read outside the ring.
+    class SharedRing {
+    public:
+        static constexpr uint32_t WRAP = 0xFFFFFFFF;
+        static constexpr size_t   HEADER_SIZE = sizeof(uint32_t);
+        static constexpr size_t   ALIGNMENT = 8;
+
+        void reset(RingControl* control, char* data, size_t capacity) {
+            m_control = control;
+            m_data = data;
+            m_capacity = capacity;
+            m_mask = capacity - 1;
+            m_head = m_cached_head = control ? control->head.load(std::memory_order_acquire) : 0;
+            m_tail = m_cached_tail = control ? control->tail.load(std::memory_order_acquire) : 0;
+            m_record_size = 0;
+        }
+
+        /// \brief Largest payload one record can carry.
+        size_t max_message_size() const {
+            return m_capacity - HEADER_SIZE;
+        }
+
+        static size_t record_size(size_t size) {
+            return (HEADER_SIZE + size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        // --- Producer ---
+
+        /// \brief Copies a message into the ring and publishes it.
+        /// \return false if there is no room; nothing is written then.
+        bool try_write(const char* data, size_t size) {
+            return try_write(nullptr, 0, data, size);
+        }
+
+        /// \brief Copies `header` followed by `data` into the ring as one message.
+        /// \return false if there is no room; nothing is written then.
+        bool try_write(const char* header, size_t header_size, const char* data, size_t data_size) {
+            const size_t size = header_size + data_size;
+            const size_t record = record_size(size);
+            size_t offset = static_cast<size_t>(m_head & m_mask);
+            const size_t contiguous = m_capacity - offset;
+            if (contiguous < record) {
+                // Published on its own, so the consumer frees the space even
+                // if the record itself does not fit yet
+                if (!has_room(contiguous)) return false;
+                store_length(offset, WRAP);
+                m_head += contiguous;
+                m_control->head.store(m_head, std::memory_order_release);
+                offset = 0;
+            }
+            if (!has_room(record)) return false;
+            store_length(offset, static_cast<uint32_t>(size));
+            if (header_size) std::memcpy(m_data + offset + HEADER_SIZE, header, header_size);
+            if (data_size) std::memcpy(m_data + offset + HEADER_SIZE + header_size, data, data_size);
+            m_head += record;
+            m_control->head.store(m_head, std::memory_order_release);
+            return true;
+        }
+
+        /// \brief Claims the consumer's wakeup after publishing.
+        /// \return true if the consumer sleeps and the caller must wake it.
+        bool take_consumer_wakeup() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return m_control->consumer_waiting.load(std::memory_order_relaxed) &&
+                m_control->consumer_waiting.exchange(0, std::memory_order_acq_rel);
+        }
+
+        /// \brief Asks the consumer for a wakeup once a message of `size` fits.
+        /// \return false if it already fits; retry the write then.
+        bool prepare_producer_wait(size_t size) {
+            m_control->producer_waiting.store(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_cached_tail = m_control->tail.load(std::memory_order_acquire);
+            const size_t record = record_size(size);
+            const size_t contiguous = m_capacity - static_cast<size_t>(m_head & m_mask);
+            if (!has_room(record + (contiguous < record ? contiguous : 0))) return true;
+            m_control->producer_waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        // --- Consumer ---
+
+        /// \brief Returns the oldest message without consuming it.
+        /// \param message Points into the ring until pop().
+        /// \param ec Set if the ring holds an invalid record.
+        /// \return false if the ring is empty or broken.
+        bool peek(MessageView& message, std::error_code& ec) {
+            for (;;) {
+                if (m_tail == m_cached_head) {
+                    m_cached_head = m_control->head.load(std::memory_order_acquire);
+                    if (m_tail == m_cached_head) return false;
+                }
+                const uint64_t available = m_cached_head - m_tail;
+                const size_t offset = static_cast<size_t>(m_tail & m_mask);
+                uint32_t length = 0;
+                if (available > m_capacity || available < HEADER_SIZE) return fail(ec);
+                std::memcpy(&length, m_data + offset, sizeof(length));
+                if (length == WRAP) {
+                    const size_t skip = m_capacity - offset;
+                    if (skip > available) return fail(ec);
+                    m_tail += skip;
+                    m_control->tail.store(m_tail, std::memory_order_release);
+                    continue;
+                }
+                if (length > max_message_size()) return fail(ec);
+                const size_t record = record_size(length);
+                if (record > m_capacity - offset || record > available) return fail(ec);
+                message = MessageView(m_data + offset + HEADER_SIZE, length);
+                m_record_size = record;
+                return true;
+            }
+        }
+
+        /// \brief Consumes the message returned by peek().
+        void pop() {
+            m_tail += m_record_size;
+            m_record_size = 0;
+            m_control->tail.store(m_tail, std::memory_order_release);
+        }
+
+        /// \brief Claims the producer's wakeup after consuming.
+        /// \return true if the producer waits for room and the caller must wake it.
+        bool take_producer_wakeup() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return m_control->producer_waiting.load(std::memory_order_relaxed) &&
+                m_control->producer_waiting.exchange(0, std::memory_order_acq_rel);
+        }
+
+        /// \brief Asks the producer for a wakeup with the next message.
+        /// \return false if a message arrived meanwhile; drain again then.
+        bool prepare_consumer_wait() {
+            m_control->consumer_waiting.store(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_cached_head = m_control->head.load(std::memory_order_acquire);
+            if (m_cached_head == m_tail) return true;
+            m_control->consumer_waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        /// \brief Checks for a published message without consuming it.
+        bool has_data() {
+            if (m_tail != m_cached_head) return true;
+            m_cached_head = m_control->head.load(std::memory_order_acquire);
+            return m_tail != m_cached_head;
+        }
+
+    private:
+        RingControl* m_control = nullptr;
+        char*        m_data = nullptr;
+        size_t       m_capacity = 0;
+        uint64_t     m_mask = 0;
+        uint64_t     m_head = 0;         ///< Producer: next write position
+        uint64_t     m_cached_tail = 0;  ///< Producer: last tail seen
+        uint64_t     m_tail = 0;         ///< Consumer: next read position
+        uint64_t     m_cached_head = 0;  ///< Consumer: last head seen
+        size_t       m_record_size = 0;  ///< Consumer: record returned by peek()
+
+        bool has_room(size_t bytes) {
+            for (int attempt = 0; attempt < 2; ++attempt) {
+                const uint64_t used = m_head - m_cached_tail;
+                if (used <= m_capacity && m_capacity - used >= bytes) return true;
+                if (attempt == 0) m_cached_tail = m_control->tail.load(std::memory_order_acquire);
+            }
+            return false;
+        }
+
+        void store_length(size_t offset, uint32_t length) {
+            std::memcpy(m_data + offset, &length, sizeof(length));
+        }
+
+        static bool fail(std::error_code& ec) {
+            ec = make_error_code(NamedPipeErrc::SharedMemoryFailed);
+            return false;
+        }
+    };
+
+    /// \class SharedChannel
+    /// \brief The shared region of one connection: a header and two rings.
+    class SharedChannel {
+    public:
+        static constexpr size_t MIN_RING_SIZE = 4096;
+        static constexpr size_t MAX_RING_SIZE = size_t(1) << 30;
+
+        /// \brief Rounds a requested ring size to a valid one.
+        static size_t ring_size_for(size_t size) {
+            size_t ring_size = MIN_RING_SIZE;
+            while (ring_size < size && ring_size < MAX_RING_SIZE) ring_size <<= 1;
+            return ring_size;
+        }
+
+        /// \brief Returns a fresh region name.
+        static std::string unique_name() {
+            static std::atomic<unsigned> sequence{0};
+            std::random_device random;
+            static const char digits[] = "0123456789abcdef";
+            std::string name = SharedMemory::prefix();
+            for (int i = 0; i < 4; ++i) {
+                unsigned value = random();
+                for (int j = 0; j < 8; ++j, value >>= 4) name += digits[value & 0xF];
+            }
+            return name + '-' + std::to_string(sequence.fetch_add(1, std::memory_order_relaxed));
+        }
+
+        /// \brief Checks that a name from the peer is one of ours.
+        static bool is_valid_name(const std::string& name) {
+            const std::string prefix = SharedMemory::prefix();
+            return name.size() > prefix.size() && name.size() < 128 &&
+                name.compare(0, prefix.size(), prefix) == 0 &&
+                name.find_first_of("/\\", prefix.size()) == std::string::npos;
+        }
+
+        /// \brief Creates the region; the creator produces into the first ring.
+        bool create(const std::string& name, size_t ring_size, std::error_code& ec) {
+            if (!is_lock_free(ec)) return false;
+            if (!m_memory.create(name, region_size(ring_size), ec)) return false;
+            char* base = m_memory.data();
+            for (int ring = 0; ring < 2; ++ring) {
+                RingControl* control = new (base + control_offset(ring_size, ring)) RingControl();
+                control->head.store(0, std::memory_order_relaxed);
+                control->tail.store(0, std::memory_order_relaxed);
+                // Both consumers start asleep, the first message wakes them
+                control->consumer_waiting.store(1, std::memory_order_relaxed);
+                control->producer_waiting.store(0, std::memory_order_relaxed);
+            }
+            Header header = {MAGIC, VERSION, static_cast<uint32_t>(ring_size)};
+            std::memcpy(base, &header, sizeof(header));
+            bind(ring_size, 0);
+            return true;
+        }
+
+        /// \brief Maps a region created by the peer; the opener produces into the second ring.
+        bool attach(const std::string& name, size_t ring_size, std::error_code& ec) {
+            if (!is_lock_free(ec)) return false;
+            if (!m_memory.open(name, region_size(ring_size), ec)) return false;
+            Header header;
+            std::memcpy(&header, m_memory.data(), sizeof(header));
+            if (header.magic != MAGIC || header.version != VERSION || header.ring_size != ring_size) {
+                m_memory.close();
+                ec = make_error_code(NamedPipeErrc::SharedMemoryFailed);
+                return false;
+            }
+            bind(ring_size, 1);
+            return true;
+        }
+
+        SharedRing& inbound() { return m_inbound; }
+        SharedRing& outbound() { return m_outbound; }
+
+    private:
+        struct Header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t ring_size;
+        };
+
+        static constexpr uint64_t MAGIC = 0x676E6972706E73ULL; // "snpring"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t   HEADER_SIZE = 64;
+
+        SharedMemory m_memory;
+        SharedRing   m_inbound;
+        SharedRing   m_outbound;
+
+        static size_t region_size(size_t ring_size) {
+            return HEADER_SIZE + 2 * (sizeof(RingControl) + ring_size);
+        }
+
+        static size_t control_offset(size_t ring_size, int ring) {
+            return HEADER_SIZE + ring * (sizeof(RingControl) + ring_size);
+        }
+
+        void bind(size_t ring_size, int produced) {
+            char* base = m_memory.data();
+            for (int ring = 0; ring < 2; ++ring) {
+                const size_t offset = control_offset(ring_size, ring);
+                RingControl* control = reinterpret_cast<RingControl*>(base + offset);
+                (ring == produced ? m_outbound : m_inbound).reset(control, base + offset + sizeof(RingControl), ring_size);
+            }
+        }
+
+        static bool is_lock_free(std::error_code& ec) {
+            // Only lock-free atomics work across processes
+            std::atomic<uint64_t> probe{0};
+            if (probe.is_lock_free()) return true;
+            ec = std::make_error_code(std::errc::not_supported);
+            return false;
+        }
+    };
+
+    // --- Handshake over the pipe ---
+
+    static constexpr char SHARED_MEMORY_MAGIC[7] = {'\0', 'S', 'N', 'P', 'S', 'H', 'M'};
+    static constexpr char SHARED_MEMORY_REQUEST = 1;
+    static constexpr char SHARED_MEMORY_REPLY = 2;
+
+    inline bool is_shared_memory_message(const char* data, size_t size, char kind) {
+        return size > sizeof(SHARED_MEMORY_MAGIC) &&
+            std::memcmp(data, SHARED_MEMORY_MAGIC, sizeof(SHARED_MEMORY_MAGIC)) == 0 &&
+            data[sizeof(SHARED_MEMORY_MAGIC)] == kind;
+    }
+
+    /// \brief First client message: magic, kind, ring size (LE), region name.
+    inline std::string make_shared_memory_request(size_t ring_size, const std::string& name) {
+        std::string message(SHARED_MEMORY_MAGIC, sizeof(SHARED_MEMORY_MAGIC));
+        message += SHARED_MEMORY_REQUEST;
+        for (int i = 0; i < 4; ++i) message += static_cast<char>((ring_size >> (8 * i)) & 0xFF);
+        return message + name;
+    }
+
+    inline bool parse_shared_memory_request(const char* data, size_t size, size_t& ring_size, std::string& name) {
+        const size_t fixed = sizeof(SHARED_MEMORY_MAGIC) + 1 + 4;
+        if (size <= fixed || !is_shared_memory_message(data, size, SHARED_MEMORY_REQUEST)) return false;
+        ring_size = 0;
+        for (int i = 0; i < 4; ++i) {
+            ring_size |= static_cast<size_t>(static_cast<unsigned char>(data[sizeof(SHARED_MEMORY_MAGIC) + 1 + i])) << (8 * i);
+        }
+        name.assign(data + fixed, size - fixed);
+        return true;
+    }
+
+    /// \brief Server answer: magic, kind, accepted flag.
+    inline std::string make_shared_memory_reply(bool accepted) {
+        std::string message(SHARED_MEMORY_MAGIC, sizeof(SHARED_MEMORY_MAGIC));
+        message += SHARED_MEMORY_REPLY;
+        message += static_cast<char>(accepted ? 1 : 0);
+        return message;
+    }
+
+    inline bool parse_shared_memory_reply(const char* data, size_t size, bool& accepted) {
+        if (size != sizeof(SHARED_MEMORY_MAGIC) + 2 || !is_shared_memory_message(data, size, SHARED_MEMORY_REPLY)) return false;
+        accepted = data[size - 1] != 0;
+        return true;
+    }
+
+    /// \brief Payload of a wakeup packet; the receiver ignores it.
+    static const char SHARED_MEMORY_WAKEUP = 0;
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_SHARED_RING_HPP_INCLUDED
@@ -0,0 +1,192 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_TIMER_WHEEL_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_TIMER_WHEEL_HPP_INCLUDED
+
+/// \file TimerWheel.hpp
+/// \brief Hashed timer wheel behind the server's timers.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace SimpleNamedPipe {
+
+    /// \brief Handle of a timer started with schedule() or send_after(); 0 is never used.
+    using TimerId = uint64_t;
+
+namespace detail {
+
+    /// \class TimerWheel
+    /// \brief Timers hashed by expiry tick into a ring of slots.
+    ///
+    /// Every slot holds an intrusive doubly linked list, so add() and cancel()
+    /// are O(1); a timer further away than one revolution stays in its slot
+    /// until its tick comes. A bitmap of occupied slots lets advance() and
+    /// next_tick() skip empty ones. Not thread-safe, the owner locks it.
+    class TimerWheel {
+    public:
+        using Callback = std::function<void()>;
+
+        static constexpr size_t   SLOT_COUNT = 256;
+        static constexpr uint64_t NO_TICK = ~uint64_t(0);
+
+        TimerWheel() {
+            m_heads.fill(uint32_t(NIL));
+        }
+
+        /// \brief Drops every timer and restarts at tick 0.
+        ///
+        /// Nodes are kept with their generations, so ids of dropped timers
+        /// never match a later one.
+        /// \param dropped Receives the callbacks, so the caller destroys them outside its lock.
+        void clear(std::vector<Callback>& dropped) {
+            for (size_t i = 0; i < m_nodes.size() && m_size > 0; ++i) {
+                if (!m_nodes[i].fn) continue;
+                dropped.push_back(std::move(m_nodes[i].fn));
+                release(static_cast<uint32_t>(i));
+            }
+            m_current = 0;
+        }
+
+        /// \brief Adds a timer; a tick already passed fires on the next advance().
+        /// \param fn Callback, must not be empty.
+        TimerId add(uint64_t tick, Callback fn) {
+            if (tick < m_current) tick = m_current;
+            uint32_t index = m_free;
+            if (index == NIL) {
+                index = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+            } else {
+                m_free = m_nodes[index].next;
+            }
+            Node& node = m_nodes[index];
+            node.tick = tick;
+            node.fn = std::move(fn);
+            link(index);
+            ++m_size;
+            return (static_cast<uint64_t>(node.generation) << 32) | (index + 1);
+        }
+
+        /// \brief Removes a pending timer.
+        /// \return Its callback, empty if the timer already fired or was cancelled.
+        Callback cancel(TimerId id) {
+            const uint64_t position = id & 0xFFFFFFFF;
+            if (position == 0 || position > m_nodes.size()) return Callback();
+            const uint32_t index = static_cast<uint32_t>(position - 1);
+            Node& node = m_nodes[index];
+            if (!node.fn || node.generation != static_cast<uint32_t>(id >> 32)) return Callback();
+            Callback fn = std::move(node.fn);
+            release(index);
+            return fn;
+        }
+
+        /// \brief Moves the callbacks of all timers due at `tick` or earlier to `due`.
+        void advance(uint64_t tick, std::vector<Callback>& due) {
+            if (tick < m_current) return;
+            if (m_size > 0) {
+                // A slot is visited once even if the wheel went round several times
+                const uint64_t steps = (std::min)(tick - m_current + 1, static_cast<uint64_t>(SLOT_COUNT));
+                for (uint64_t step = 0; step < steps && m_size > 0; ++step) {
+                    const size_t slot = static_cast<size_t>((m_current + step) & SLOT_MASK);
+                    if (!(m_occupied[slot / 64] & (uint64_t(1) << (slot % 64)))) continue;
+                    uint32_t index = m_heads[slot];
+                    while (index != NIL) {
+                        Node& node = m_nodes[index];
+                        const uint32_t next = node.next;
+                        if (node.tick <= tick) {
+                            due.push_back(std::move(node.fn));
+                            release(index);
+                        }
+                        index = next;
+                    }
+                }
+            }
+            m_current = tick + 1;
+        }
+
+        /// \brief Earliest tick a timer may be due at, NO_TICK if there are none.
+        ///
+        /// The tick of the nearest occupied slot; its timers may belong to a
+        /// later revolution, so the caller may wake up early and wait again.
+        uint64_t next_tick() const {
+            if (m_size == 0) return NO_TICK;
+            const size_t start = static_cast<size_t>(m_current & SLOT_MASK);
+            for (size_t i = 0; i <= WORD_COUNT; ++i) {
+                const size_t word = (start / 64 + i) % WORD_COUNT;
+                uint64_t bits = m_occupied[word];
+                // The first word is scanned from the current slot, the last
+                // pass picks up the slots before it
+                if (i == 0) bits &= ~uint64_t(0) << (start % 64);
+                else if (i == WORD_COUNT) bits &= (uint64_t(1) << (start % 64)) - 1;
+                if (!bits) continue;
+                const size_t slot = word * 64 + lowest_bit(bits);
+                return m_current + ((slot - start) & SLOT_MASK);
+            }
+            return NO_TICK;
+        }
+
+        size_t size() const { return m_size; }
+
+    private:
+        static constexpr uint32_t NIL = ~uint32_t(0);
+        static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+        static constexpr size_t   WORD_COUNT = SLOT_COUNT / 64;
+
+        struct Node {
+            uint64_t tick = 0;
+            uint32_t prev = NIL;
+            uint32_t next = NIL;     ///< Next free node while unused
+            uint32_t generation = 0; ///< Bumped on release, so an old TimerId misses
+            Callback fn;             ///< Empty while unused
+        };
+
+        std::vector<Node> m_nodes;
+        std::array<uint32_t, SLOT_COUNT> m_heads;
+        std::array<uint64_t, WORD_COUNT> m_occupied{};
+        uint32_t m_free = NIL;
+        size_t   m_size = 0;
+        uint64_t m_current = 0;      ///< Next tick advance() processes
+
+        static size_t lowest_bit(uint64_t bits) {
+            size_t n = 0;
+            while (!(bits & 1)) {
+                bits >>= 1;
+                ++n;
+            }
+            return n;
+        }
+
+        void link(uint32_t index) {
+            Node& node = m_nodes[index];
+            const size_t slot = static_cast<size_t>(node.tick & SLOT_MASK);
+            node.prev = NIL;
+            node.next = m_heads[slot];
+            if (node.next != NIL) m_nodes[node.next].prev = index;
+            m_heads[slot] = index;
+            m_occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+        }
+
+        void release(uint32_t index) {
+            Node& node = m_nodes[index];
+            const size_t slot = static_cast<size_t>(node.tick & SLOT_MASK);
+            if (node.prev != NIL) m_nodes[node.prev].next = node.next;
+            else m_heads[slot] = node.next;
+            if (node.next != NIL) m_nodes[node.next].prev = node.prev;
+            if (m_heads[slot] == NIL) m_occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+
+            node.fn = nullptr;
+            ++node.generation;
+            node.prev = NIL;
+            node.next = m_free;
+            m_free = index;
+            --m_size;
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_TIMER_WHEEL_HPP_INCLUDED
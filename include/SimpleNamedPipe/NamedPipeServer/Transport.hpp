@@ -0,0 +1,51 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_SERVER_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_SERVER_TRANSPORT_HPP_INCLUDED
+
+/// \file Transport.hpp
+/// \brief Completion-based transport abstraction used by NamedPipeServer.
+///
+/// A transport owns the OS-level objects (completion port or epoll instance,
+/// pipe handles or sockets) and reports finished operations as IoEvent records.
+/// Every backend exposes the same set of members:
+/// - `Endpoint`  — per-slot OS state, owned by the server;
+/// - `open(config)` / `close()` / `is_open()`;
+/// - `reconfigure(config)` — applies live settings to a running transport;
+/// - `listen(ep, ec)` — waits for a client on the slot, completes with `Connected`;
+/// - `read(ep, data, size, ec)` — completes with `Read`, `more_data` is set when
+///   the message did not fit into the buffer;
+/// - `write(ep, data, size, ec)` — completes with `Write`, one call is one message;
+///   `write(ep, header, header_size, data, size, ec)` sends both parts as one message;
+/// - `disconnect(ep)` / `release(ep)` — drops the client / frees the slot handle;
+/// - `post(key)` — thread-safe wakeup, completes with `Command`;
+/// - `wait(events, max_events, timeout_ms)` — dequeues completions;
+///   `WAIT_RESOLUTION_US` is how late a timed wait may return.
+///
+/// The backend is selected at compile time by defining either
+/// `SIMPLE_NAMED_PIPE_BACKEND_WIN32` or `SIMPLE_NAMED_PIPE_BACKEND_UNIX`.
+/// When neither is defined, the Win32 backend is used on Windows and
+/// the Unix backend everywhere else.
+
+#include "IoEvent.hpp"
+
+#if !defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32) && !defined(SIMPLE_NAMED_PIPE_BACKEND_UNIX)
+#   if defined(_WIN32)
+#       define SIMPLE_NAMED_PIPE_BACKEND_WIN32
+#   else
+#       define SIMPLE_NAMED_PIPE_BACKEND_UNIX
+#   endif
+#endif
+
+#if defined(SIMPLE_NAMED_PIPE_BACKEND_WIN32)
+#include "Win32PipeTransport.hpp"
+namespace SimpleNamedPipe { namespace detail {
+    using Transport = Win32PipeTransport;
+}}
+#else
+#include "UnixSocketTransport.hpp"
+namespace SimpleNamedPipe { namespace detail {
+    using Transport = UnixSocketTransport;
+}}
+#endif
+
+#endif // _SIMPLE_NAMED_PIPE_SERVER_TRANSPORT_HPP_INCLUDED
@@ -0,0 +1,573 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_UNIX_SOCKET_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_UNIX_SOCKET_TRANSPORT_HPP_INCLUDED
+
+/// \file UnixSocketTransport.hpp
+/// \brief Transport backend built on AF_UNIX/SOCK_SEQPACKET sockets and epoll.
+///
+/// SOCK_SEQPACKET keeps message boundaries the same way PIPE_TYPE_MESSAGE does:
+/// one write is delivered as one message. Readiness notifications from epoll
+/// are turned into IOCP-like completions so the server logic stays the same
+/// on every platform.
+
+#include "ServerConfig.hpp"
+#include "errors.hpp"
+#include "IoEvent.hpp"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \brief Maps a pipe name to the filesystem path of the AF_UNIX socket.
+    /// \param pipe_name Pipe name from ServerConfig; names containing '/' are used as is.
+    /// \return Socket path, e.g. "/tmp/ExamplePipe.sock".
+    inline std::string make_unix_socket_path(const std::string& pipe_name) {
+        if (pipe_name.find('/') != std::string::npos) return pipe_name;
+        return "/tmp/" + pipe_name + ".sock";
+    }
+
+    /// \class UnixSocketTransport
+    /// \brief AF_UNIX SOCK_SEQPACKET transport driven by an edge-triggered epoll loop.
+    ///
+    /// wait() may be called from several threads at once. Lock order is
+    /// listeners -> endpoint -> ready queue.
+    class UnixSocketTransport {
+    public:
+        /// \brief How late a timed wait() may return: epoll_wait() counts whole milliseconds.
+        static constexpr int64_t WAIT_RESOLUTION_US = 1000;
+
+        /// \brief Per-slot socket state.
+        struct Endpoint {
+            std::mutex  mutex;                ///< Guards the fields below
+            size_t      slot = 0;             ///< Slot index reported in events
+            int         fd = -1;              ///< Connected socket or -1
+            std::atomic<uint64_t> epoch{0};   ///< Incremented on disconnect to drop stale completions
+            bool        listening = false;    ///< Waiting in the accept queue (guarded by the listener lock)
+            bool        readable = false;     ///< Last known read readiness
+            bool        writable = false;     ///< Last known write readiness
+
+            char*       read_data = nullptr;
+            size_t      read_size = 0;
+            bool        read_pending = false;
+
+            const char* write_header = nullptr;   ///< Sent in front of write_data in the same message
+            size_t      write_header_size = 0;
+            const char* write_data = nullptr;
+            size_t      write_size = 0;
+            bool        write_pending = false;
+
+            std::vector<char> spill;          ///< Remainder of a message larger than the read buffer
+            size_t      spill_offset = 0;
+
+            /// \brief Restores the initial state after the transport was closed.
+            void reset() {
+                fd = -1;
+                listening = readable = writable = false;
+                read_data = nullptr;
+                read_size = 0;
+                read_pending = false;
+                write_header = nullptr;
+                write_header_size = 0;
+                write_data = nullptr;
+                write_size = 0;
+                write_pending = false;
+                std::vector<char>().swap(spill);
+                spill_offset = 0;
+            }
+        };
+
+        UnixSocketTransport() = default;
+        UnixSocketTransport(const UnixSocketTransport&) = delete;
+        UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+        ~UnixSocketTransport() {
+            close();
+        }
+
+        /// \brief Creates the epoll instance and the listening socket.
+        /// \throws std::system_error on failure.
+        void open(const ServerConfig& config) {
+            close();
+            m_path = make_unix_socket_path(config.pipe_name);
+            reconfigure(config);
+
+            m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (m_epoll_fd < 0) {
+                throw_last_error("Failed to create epoll instance");
+            }
+
+            int wakeup_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (wakeup_fd < 0) {
+                throw_last_error("Failed to create eventfd");
+            }
+            m_wakeup_fd.store(wakeup_fd, std::memory_order_release);
+            add_to_epoll(wakeup_fd, EPOLLIN, &m_wakeup_fd);
+
+            sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (m_path.size() >= sizeof(addr.sun_path)) {
+                throw std::system_error(std::make_error_code(std::errc::filename_too_long), "Socket path is too long");
+            }
+            std::memcpy(addr.sun_path, m_path.c_str(), m_path.size() + 1);
+
+            m_listen_fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (m_listen_fd < 0) {
+                throw_last_error("Failed to create socket");
+            }
+
+            ::unlink(m_path.c_str());
+            if (::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+                throw_last_error("Failed to bind socket");
+            }
+            if (::listen(m_listen_fd, SOMAXCONN) < 0) {
+                throw_last_error("Failed to listen on socket");
+            }
+            add_to_epoll(m_listen_fd, EPOLLIN | EPOLLET, &m_listen_fd);
+            std::lock_guard<std::mutex> lock(m_listen_mutex);
+            m_listen_ready = false;
+            m_is_open.store(true, std::memory_order_release);
+        }
+
+        /// \brief Applies the receive size limit to packets read from now on.
+        void reconfigure(const ServerConfig& config) {
+            m_max_message_size.store(config.read_limits.max_message_size, std::memory_order_relaxed);
+        }
+
+        /// \brief Closes the listening socket and the epoll instance.
+        void close() {
+            m_is_open.store(false, std::memory_order_release);
+            if (m_listen_fd >= 0) {
+                ::close(m_listen_fd);
+                m_listen_fd = -1;
+                ::unlink(m_path.c_str());
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+                int wakeup_fd = m_wakeup_fd.exchange(-1, std::memory_order_acq_rel);
+                if (wakeup_fd >= 0) ::close(wakeup_fd);
+            }
+            if (m_epoll_fd >= 0) {
+                ::close(m_epoll_fd);
+                m_epoll_fd = -1;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_listen_mutex);
+                m_listeners.clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_ready_mutex);
+                m_ready.clear();
+            }
+            std::lock_guard<std::mutex> lock(m_command_mutex);
+            m_commands.clear();
+        }
+
+        /// \brief Checks whether the transport is open.
+        bool is_open() const {
+            return m_is_open.load(std::memory_order_acquire);
+        }
+
+        /// \brief Puts the slot into the accept queue.
+        bool listen(Endpoint& ep, std::error_code& ec) {
+            ec.clear();
+            std::lock_guard<std::mutex> lock(m_listen_mutex);
+            if (ep.listening) return true;
+            ep.listening = true;
+            m_listeners.push_back(&ep);
+            if (m_listen_ready) accept_pending();
+            return true;
+        }
+
+        /// \brief Starts reading the next message into the buffer.
+        bool read(Endpoint& ep, char* data, size_t size, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            if (ep.fd < 0) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            ec.clear();
+            ep.read_data = data;
+            ep.read_size = size;
+            ep.read_pending = true;
+            if (ep.spill_offset < ep.spill.size()) {
+                read_spill(ep);
+            } else
+            if (ep.readable) {
+                do_read(ep);
+            }
+            return true;
+        }
+
+        /// \brief Starts sending one message.
+        bool write(Endpoint& ep, const char* data, size_t size, std::error_code& ec) {
+            return write(ep, nullptr, 0, data, size, ec);
+        }
+
+        /// \brief Starts sending `header` followed by `data` as one message.
+        bool write(Endpoint& ep, const char* header, size_t header_size,
+                   const char* data, size_t size, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            if (ep.fd < 0) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            ec.clear();
+            ep.write_header = header;
+            ep.write_header_size = header_size;
+            ep.write_data = data;
+            ep.write_size = size;
+            ep.write_pending = true;
+            if (ep.writable) do_write(ep);
+            return true;
+        }
+
+        /// \brief Closes the client socket. Pending operations are discarded.
+        void disconnect(Endpoint& ep) {
+            {
+                std::lock_guard<std::mutex> lock(m_listen_mutex);
+                if (ep.listening) {
+                    auto it = std::find(m_listeners.begin(), m_listeners.end(), &ep);
+                    if (it != m_listeners.end()) m_listeners.erase(it);
+                    ep.listening = false;
+                }
+            }
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            if (ep.fd >= 0) {
+                ::close(ep.fd);
+                ep.fd = -1;
+            }
+            ++ep.epoch;
+            ep.readable = ep.writable = false;
+            ep.read_pending = ep.write_pending = false;
+            ep.read_data = nullptr;
+            ep.write_header = nullptr;
+            ep.write_data = nullptr;
+            std::vector<char>().swap(ep.spill);
+            ep.spill_offset = 0;
+        }
+
+        /// \brief Releases all OS resources of the slot.
+        void release(Endpoint& ep) {
+            disconnect(ep);
+        }
+
+        /// \brief Posts a command key to the waiting thread. Thread-safe.
+        bool post(uintptr_t key) {
+            if (m_wakeup_fd.load(std::memory_order_acquire) < 0) return false;
+            {
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+                m_commands.push_back(key);
+            }
+            return wakeup();
+        }
+
+        /// \brief Waits for completions.
+        /// \param events Output array.
+        /// \param max_events Capacity of the output array.
+        /// \param timeout_ms Timeout in milliseconds, -1 waits infinitely.
+        /// \return Number of events written; 0 on timeout.
+        size_t wait(IoEvent* events, size_t max_events, int timeout_ms) {
+            size_t count = drain_ready(events, max_events);
+            if (count == max_events) return count;
+
+            epoll_event ready[MAX_EPOLL_EVENTS];
+            int n = ::epoll_wait(m_epoll_fd, ready, MAX_EPOLL_EVENTS, count ? 0 : timeout_ms);
+            if (n < 0) {
+                if (errno != EINTR) {
+                    complete(IoEvent(IoEventType::Error, 0, 0, last_error()));
+                }
+                return count + drain_ready(events + count, max_events - count);
+            }
+
+            for (int i = 0; i < n; ++i) {
+                void* ptr = ready[i].data.ptr;
+                uint32_t flags = ready[i].events;
+                if (ptr == &m_wakeup_fd) {
+                    read_commands();
+                    continue;
+                }
+                if (ptr == &m_listen_fd) {
+                    std::lock_guard<std::mutex> lock(m_listen_mutex);
+                    m_listen_ready = true;
+                    accept_pending();
+                    continue;
+                }
+                Endpoint& ep = *static_cast<Endpoint*>(ptr);
+                std::lock_guard<std::mutex> lock(ep.mutex);
+                if (ep.fd < 0) continue;
+                if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    ep.readable = true;
+                    if (ep.read_pending && ep.spill_offset >= ep.spill.size()) do_read(ep);
+                }
+                if (ep.fd >= 0 && (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR))) {
+                    ep.writable = true;
+                    if (ep.write_pending) do_write(ep);
+                }
+            }
+            return count + drain_ready(events + count, max_events - count);
+        }
+
+    private:
+        static constexpr int MAX_EPOLL_EVENTS = 64;
+
+        struct Completion {
+            IoEvent   event;
+            Endpoint* endpoint; ///< nullptr for events not bound to a slot
+            uint64_t  epoch;
+        };
+
+        std::atomic<bool>      m_is_open{false};
+        std::atomic<int>       m_wakeup_fd{-1};
+        std::mutex             m_wakeup_mutex;  ///< Guards writes to m_wakeup_fd against close()
+        int                    m_epoll_fd = -1;
+        int                    m_listen_fd = -1;
+        std::string            m_path;
+        std::atomic<size_t>    m_max_message_size{0}; ///< Larger packets are dropped unread
+        std::mutex             m_listen_mutex;
+        bool                   m_listen_ready = false;
+        std::deque<Endpoint*>  m_listeners;
+        std::mutex             m_ready_mutex;
+        std::deque<Completion> m_ready;
+        std::mutex             m_command_mutex;
+        std::vector<uintptr_t> m_commands;
+
+        static std::error_code last_error() {
+            return std::error_code(errno, std::system_category());
+        }
+
+        static void throw_last_error(const char* what) {
+            throw std::system_error(last_error(), what);
+        }
+
+        void add_to_epoll(int fd, uint32_t flags, void* ptr) {
+            epoll_event ev;
+            std::memset(&ev, 0, sizeof(ev));
+            ev.events = flags;
+            ev.data.ptr = ptr;
+            if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                throw_last_error("Failed to register descriptor in epoll");
+            }
+        }
+
+        void complete(Endpoint& ep, const IoEvent& event) {
+            std::lock_guard<std::mutex> lock(m_ready_mutex);
+            m_ready.push_back({event, &ep, ep.epoch.load(std::memory_order_relaxed)});
+        }
+
+        void complete(const IoEvent& event) {
+            std::lock_guard<std::mutex> lock(m_ready_mutex);
+            m_ready.push_back({event, nullptr, 0});
+        }
+
+        size_t drain_ready(IoEvent* events, size_t max_events) {
+            std::lock_guard<std::mutex> lock(m_ready_mutex);
+            size_t count = 0;
+            while (count < max_events && !m_ready.empty()) {
+                const Completion& c = m_ready.front();
+                if (!c.endpoint || c.endpoint->epoch.load(std::memory_order_relaxed) == c.epoch) {
+                    events[count++] = c.event;
+                }
+                m_ready.pop_front();
+            }
+            // Let another thread blocked in epoll_wait() pick up the rest
+            if (!m_ready.empty()) wakeup();
+            return count;
+        }
+
+        bool wakeup() {
+            // Keeps close() from recycling the descriptor under the write
+            std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+            int wakeup_fd = m_wakeup_fd.load(std::memory_order_acquire);
+            if (wakeup_fd < 0) return false;
+            uint64_t one = 1;
+            return ::write(wakeup_fd, &one, sizeof(one)) == sizeof(one);
+        }
+
+        void read_commands() {
+            int wakeup_fd = m_wakeup_fd.load(std::memory_order_acquire);
+            uint64_t value = 0;
+            while (::read(wakeup_fd, &value, sizeof(value)) > 0) {}
+            std::vector<uintptr_t> commands;
+            {
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+                commands.swap(m_commands);
+            }
+            std::lock_guard<std::mutex> lock(m_ready_mutex);
+            for (uintptr_t key : commands) {
+                m_ready.push_back({IoEvent(IoEventType::Command, key), nullptr, 0});
+            }
+        }
+
+        // Called with the listener lock held
+        void accept_pending() {
+            while (!m_listeners.empty()) {
+                int fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        m_listen_ready = false;
+                    } else {
+                        complete(IoEvent(IoEventType::Error, 0, 0, last_error()));
+                    }
+                    return;
+                }
+
+                Endpoint& ep = *m_listeners.front();
+                m_listeners.pop_front();
+                ep.listening = false;
+
+                std::lock_guard<std::mutex> lock(ep.mutex);
+                ep.fd = fd;
+                ep.readable = false;
+                ep.writable = true;
+
+                epoll_event ev;
+                std::memset(&ev, 0, sizeof(ev));
+                ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+                ev.data.ptr = &ep;
+                if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                    std::error_code ec = last_error();
+                    ::close(fd);
+                    ep.fd = -1;
+                    ep.listening = true;
+                    m_listeners.push_front(&ep);
+                    complete(IoEvent(IoEventType::Error, 0, 0, ec));
+                    return;
+                }
+                complete(ep, IoEvent(IoEventType::Connected, ep.slot));
+            }
+        }
+
+        void do_read(Endpoint& ep) {
+            // Probe the size of the next packet so that messages larger than
+            // the read buffer are not truncated by the kernel.
+            ssize_t length;
+            do {
+                length = ::recv(ep.fd, nullptr, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+            } while (length < 0 && errno == EINTR);
+
+            if (length < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    ep.readable = false;
+                    return;
+                }
+                ep.read_pending = false;
+                complete(ep, IoEvent(IoEventType::Disconnected, ep.slot, 0, last_error()));
+                return;
+            }
+
+            if (length == 0) {
+                ep.read_pending = false;
+                complete(ep, IoEvent(IoEventType::Disconnected, ep.slot, 0, std::make_error_code(std::errc::broken_pipe)));
+                return;
+            }
+
+            size_t size = static_cast<size_t>(length);
+            char* target = ep.read_data;
+            const size_t max_message_size = m_max_message_size.load(std::memory_order_relaxed);
+            if (max_message_size && size > max_message_size) {
+                // Drop the packet without buffering it: a short read discards the rest
+                ssize_t dropped;
+                do {
+                    dropped = ::recv(ep.fd, ep.read_data, ep.read_size, MSG_DONTWAIT);
+                } while (dropped < 0 && errno == EINTR);
+                ep.read_pending = false;
+                complete(ep, IoEvent(IoEventType::Read, ep.slot, 0, make_error_code(NamedPipeErrc::IncomingMessageTooLarge)));
+                return;
+            }
+            if (size > ep.read_size) {
+                ep.spill.resize(size);
+                target = ep.spill.data();
+            }
+
+            ssize_t received;
+            do {
+                received = ::recv(ep.fd, target, size, MSG_DONTWAIT);
+            } while (received < 0 && errno == EINTR);
+
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    ep.readable = false;
+                    return;
+                }
+                ep.read_pending = false;
+                complete(ep, IoEvent(IoEventType::Disconnected, ep.slot, 0, last_error()));
+                return;
+            }
+
+            if (target == ep.read_data) {
+                ep.read_pending = false;
+                complete(ep, IoEvent(IoEventType::Read, ep.slot, static_cast<size_t>(received)));
+                return;
+            }
+
+            ep.spill.resize(static_cast<size_t>(received));
+            ep.spill_offset = 0;
+            read_spill(ep);
+        }
+
+        void read_spill(Endpoint& ep) {
+            size_t remaining = ep.spill.size() - ep.spill_offset;
+            size_t chunk = (std::min)(remaining, ep.read_size);
+            std::memcpy(ep.read_data, ep.spill.data() + ep.spill_offset, chunk);
+            ep.spill_offset += chunk;
+
+            IoEvent event(IoEventType::Read, ep.slot, chunk);
+            event.more_data = ep.spill_offset < ep.spill.size();
+            if (!event.more_data) {
+                std::vector<char>().swap(ep.spill);
+                ep.spill_offset = 0;
+            }
+            ep.read_pending = false;
+            complete(ep, event);
+        }
+
+        void do_write(Endpoint& ep) {
+            iovec parts[2];
+            parts[0].iov_base = const_cast<char*>(ep.write_header);
+            parts[0].iov_len = ep.write_header_size;
+            parts[1].iov_base = const_cast<char*>(ep.write_data);
+            parts[1].iov_len = ep.write_size;
+            msghdr message{};
+            message.msg_iov = ep.write_header_size ? parts : parts + 1;
+            message.msg_iovlen = ep.write_header_size ? 2 : 1;
+            ssize_t sent;
+            do {
+                sent = ::sendmsg(ep.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+            } while (sent < 0 && errno == EINTR);
+
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    ep.writable = false;
+                    return;
+                }
+                ep.write_pending = false;
+                complete(ep, IoEvent(IoEventType::Write, ep.slot, 0, last_error()));
+                return;
+            }
+
+            ep.write_pending = false;
+            complete(ep, IoEvent(IoEventType::Write, ep.slot, static_cast<size_t>(sent)));
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_UNIX_SOCKET_TRANSPORT_HPP_INCLUDED
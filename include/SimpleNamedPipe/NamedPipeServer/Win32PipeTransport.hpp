@@ -0,0 +1,414 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_WIN32_PIPE_TRANSPORT_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_WIN32_PIPE_TRANSPORT_HPP_INCLUDED
+
+/// \file Win32PipeTransport.hpp
+/// \brief Transport backend built on Windows named pipes and IO Completion Port.
+
+#include "ServerConfig.hpp"
+#include "errors.hpp"
+#include "IoEvent.hpp"
+
+#include <windows.h>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <codecvt>
+#include <locale>
+#include <vector>
+
+namespace SimpleNamedPipe {
+namespace detail {
+
+    /// \class Win32PipeTransport
+    /// \brief Message-mode named pipe instances bound to a single completion port.
+    ///
+    /// wait() may be called from several threads at once; endpoint state is
+    /// guarded by the per-endpoint mutex.
+    class Win32PipeTransport {
+    public:
+        /// \brief How late a timed wait() may return: one tick of the default
+        /// 64 Hz system timer.
+        static constexpr int64_t WAIT_RESOLUTION_US = 15625;
+
+        struct Endpoint;
+
+        /// \brief Overlapped request bound to its endpoint.
+        struct IoRequest {
+            OVERLAPPED ov;       ///< Must be the first member
+            Endpoint*  endpoint;
+        };
+
+        /// \brief Per-slot pipe state.
+        struct Endpoint {
+            std::mutex mutex;                         ///< Guards the fields below
+            size_t    slot = 0;                       ///< Slot index reported in events
+            HANDLE    pipe = INVALID_HANDLE_VALUE;    ///< Pipe instance
+            size_t    buffer_size = 0;                ///< Buffer size the instance was created with
+            IoRequest connect_req{};
+            IoRequest read_req{};
+            IoRequest write_req{};
+            bool      connected = false;
+            bool      connect_pending = false;
+            bool      read_pending = false;
+            bool      write_pending = false;
+            bool      relisten = false;               ///< listen() deferred until aborted I/O drains
+            std::vector<char> write_buffer;           ///< Joins a two-part write, reused across writes
+
+            /// \brief Restores the initial state after the transport was closed.
+            void reset() {
+                pipe = INVALID_HANDLE_VALUE;
+                connect_req = IoRequest{};
+                read_req = IoRequest{};
+                write_req = IoRequest{};
+                connected = connect_pending = read_pending = write_pending = relisten = false;
+                std::vector<char>().swap(write_buffer);
+            }
+        };
+
+        Win32PipeTransport() = default;
+        Win32PipeTransport(const Win32PipeTransport&) = delete;
+        Win32PipeTransport& operator=(const Win32PipeTransport&) = delete;
+
+        ~Win32PipeTransport() {
+            close();
+        }
+
+        /// \brief Creates the completion port.
+        /// \throws std::system_error on failure.
+        void open(const ServerConfig& config) {
+            close();
+            reconfigure(config);
+            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> conv;
+            m_pipe_name = L"\\\\.\\pipe\\" + conv.from_bytes(config.pipe_name);
+
+            HANDLE completion_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 0);
+            if (!completion_port) {
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to create IO completion port");
+            }
+            m_completion_port.store(completion_port, std::memory_order_release);
+        }
+
+        /// \brief Applies the buffer size and timeout to instances created from now on.
+        ///
+        /// A listening instance with another buffer size is recreated before
+        /// it accepts its next client; connected clients keep theirs.
+        void reconfigure(const ServerConfig& config) {
+            m_buffer_size.store(config.buffer_size, std::memory_order_relaxed);
+            m_timeout.store(config.timeout, std::memory_order_relaxed);
+        }
+
+        /// \brief Closes the completion port.
+        void close() {
+            HANDLE completion_port = m_completion_port.exchange(nullptr, std::memory_order_acq_rel);
+            if (completion_port) {
+                CloseHandle(completion_port);
+            }
+        }
+
+        /// \brief Checks whether the transport is open.
+        bool is_open() const {
+            return m_completion_port.load(std::memory_order_acquire) != nullptr;
+        }
+
+        /// \brief Creates the pipe instance if needed and arms ConnectNamedPipe.
+        bool listen(Endpoint& ep, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            ec.clear();
+            if (ep.read_pending || ep.write_pending || ep.connect_pending) {
+                // Aborted operations still reference the OVERLAPPED structures
+                ep.relisten = true;
+                return true;
+            }
+            return start_connect(ep, ec);
+        }
+
+        /// \brief Starts an overlapped read.
+        bool read(Endpoint& ep, char* data, size_t size, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            if (!ep.connected) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            memset(&ep.read_req.ov, 0, sizeof(OVERLAPPED));
+            ep.read_req.endpoint = &ep;
+            ep.read_pending = true;
+
+            BOOL success = ReadFile(ep.pipe, data, static_cast<DWORD>(size), nullptr, &ep.read_req.ov);
+            DWORD err = GetLastError();
+            if (!success && err != ERROR_IO_PENDING && err != ERROR_MORE_DATA) {
+                ep.read_pending = false;
+                ec = std::error_code(static_cast<int>(err), std::system_category());
+                return false;
+            }
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Starts an overlapped write of one message.
+        bool write(Endpoint& ep, const char* data, size_t size, std::error_code& ec) {
+            return write(ep, nullptr, 0, data, size, ec);
+        }
+
+        /// \brief Starts sending `header` followed by `data` as one message.
+        ///
+        /// WriteFile() has no gather form for pipes, so the parts are joined
+        /// in a buffer of the endpoint; it keeps its capacity between writes.
+        bool write(Endpoint& ep, const char* header, size_t header_size,
+                   const char* data, size_t size, std::error_code& ec) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            if (!ep.connected) {
+                ec = make_error_code(NamedPipeErrc::NotConnected);
+                return false;
+            }
+            if (header_size) {
+                ep.write_buffer.assign(header, header + header_size);
+                ep.write_buffer.insert(ep.write_buffer.end(), data, data + size);
+                data = ep.write_buffer.data();
+                size = ep.write_buffer.size();
+            }
+            memset(&ep.write_req.ov, 0, sizeof(OVERLAPPED));
+            ep.write_req.endpoint = &ep;
+            ep.write_pending = true;
+
+            BOOL success = WriteFile(ep.pipe, data, static_cast<DWORD>(size), nullptr, &ep.write_req.ov);
+            DWORD err = GetLastError();
+            if (!success && err != ERROR_IO_PENDING) {
+                ep.write_pending = false;
+                ec = std::error_code(static_cast<int>(err), std::system_category());
+                return false;
+            }
+            ec.clear();
+            return true;
+        }
+
+        /// \brief Cancels pending I/O and disconnects the client.
+        void disconnect(Endpoint& ep) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            disconnect_locked(ep);
+        }
+
+        /// \brief Disconnects the client and closes the pipe instance.
+        void release(Endpoint& ep) {
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            disconnect_locked(ep);
+            if (ep.pipe != INVALID_HANDLE_VALUE) {
+                CloseHandle(ep.pipe);
+                ep.pipe = INVALID_HANDLE_VALUE;
+            }
+            // Pending flags stay set until the aborted completions are dequeued,
+            // so a reused slot defers ConnectNamedPipe until then.
+        }
+
+        /// \brief Posts a command key to the completion port. Thread-safe.
+        bool post(uintptr_t key) {
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            if (!completion_port) return false;
+            return PostQueuedCompletionStatus(completion_port, 0, static_cast<ULONG_PTR>(key), nullptr) != FALSE;
+        }
+
+        /// \brief Dequeues up to `max_events` completions with one system call.
+        /// \param events Output array.
+        /// \param max_events Capacity of the output array.
+        /// \param timeout_ms Timeout in milliseconds, -1 waits infinitely.
+        /// \return Number of events written; 0 on timeout or for internal completions.
+        size_t wait(IoEvent* events, size_t max_events, int timeout_ms) {
+            if (max_events == 0) return 0;
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            const DWORD timeout = timeout_ms < 0 ? INFINITE : static_cast<DWORD>(timeout_ms);
+
+            if (max_events == 1) {
+                DWORD bytes_transferred = 0;
+                ULONG_PTR key = 0;
+                OVERLAPPED* ov = nullptr;
+                BOOL ok = GetQueuedCompletionStatus(completion_port, &bytes_transferred, &key, &ov, timeout);
+                DWORD err = ok ? ERROR_SUCCESS : GetLastError();
+                return translate(ok, err, bytes_transferred, key, ov, events);
+            }
+
+            OVERLAPPED_ENTRY entries[MAX_COMPLETIONS];
+            ULONG removed = 0;
+            const ULONG capacity = max_events < MAX_COMPLETIONS ? static_cast<ULONG>(max_events) : static_cast<ULONG>(MAX_COMPLETIONS);
+            if (!GetQueuedCompletionStatusEx(completion_port, entries, capacity, &removed, timeout, FALSE)) {
+                DWORD err = GetLastError();
+                if (err == WAIT_TIMEOUT) return 0;
+                events[0] = IoEvent(IoEventType::Error, 0, 0, system_error_code(err));
+                return 1;
+            }
+
+            // Every completion yields at most one event
+            size_t count = 0;
+            for (ULONG i = 0; i < removed; ++i) {
+                OVERLAPPED* ov = entries[i].lpOverlapped;
+                DWORD bytes_transferred = entries[i].dwNumberOfBytesTransferred;
+                BOOL ok = TRUE;
+                DWORD err = ERROR_SUCCESS;
+                if (ov) {
+                    err = completion_error(*ov);
+                    ok = err == ERROR_SUCCESS;
+                }
+                count += translate(ok, err, bytes_transferred, entries[i].lpCompletionKey, ov, events + count);
+            }
+            return count;
+        }
+
+    private:
+        static constexpr size_t MAX_COMPLETIONS = 64;
+
+        std::atomic<HANDLE> m_completion_port{nullptr};
+        std::atomic<size_t> m_buffer_size{0};
+        std::atomic<size_t> m_timeout{0};
+        std::wstring        m_pipe_name;
+
+        /// \brief The error GetQueuedCompletionStatus would report for a completion.
+        ///
+        /// Read from the NTSTATUS the kernel left in the OVERLAPPED rather than
+        /// with GetOverlappedResult(), which needs the pipe handle that another
+        /// I/O thread may be closing.
+        static DWORD completion_error(const OVERLAPPED& ov) {
+            const LONG status = static_cast<LONG>(ov.Internal);
+            if (status >= 0) return ERROR_SUCCESS;
+            typedef ULONG (WINAPI *StatusToError)(LONG);
+            // Through void (*)() so GCC does not warn about the signature change
+            static const StatusToError to_error = reinterpret_cast<StatusToError>(reinterpret_cast<void (*)()>(
+                GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "RtlNtStatusToDosError")));
+            return to_error ? static_cast<DWORD>(to_error(status)) : ERROR_GEN_FAILURE;
+        }
+
+        static std::error_code system_error_code(DWORD err) {
+            return std::error_code(static_cast<int>(err), std::system_category());
+        }
+
+        void disconnect_locked(Endpoint& ep) {
+            ep.connected = false;
+            ep.relisten = false;
+            if (ep.pipe != INVALID_HANDLE_VALUE) {
+                CancelIoEx(ep.pipe, nullptr);
+                DisconnectNamedPipe(ep.pipe);
+            }
+        }
+
+        bool create_pipe(Endpoint& ep, std::error_code& ec) {
+            ep.buffer_size = m_buffer_size.load(std::memory_order_relaxed);
+            ep.pipe = CreateNamedPipeW(
+                m_pipe_name.c_str(),
+                PIPE_ACCESS_DUPLEX |
+                FILE_FLAG_OVERLAPPED,
+                PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+                PIPE_UNLIMITED_INSTANCES,
+                static_cast<DWORD>(ep.buffer_size),
+                static_cast<DWORD>(ep.buffer_size),
+                static_cast<DWORD>(m_timeout.load(std::memory_order_relaxed)),
+                nullptr
+            );
+            if (ep.pipe == INVALID_HANDLE_VALUE) {
+                ec = system_error_code(GetLastError());
+                return false;
+            }
+
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            if (!CreateIoCompletionPort(ep.pipe, completion_port, 0, 0)) {
+                ec = system_error_code(GetLastError());
+                CloseHandle(ep.pipe);
+                ep.pipe = INVALID_HANDLE_VALUE;
+                return false;
+            }
+            return true;
+        }
+
+        bool start_connect(Endpoint& ep, std::error_code& ec) {
+            if (ep.pipe != INVALID_HANDLE_VALUE && ep.buffer_size != m_buffer_size.load(std::memory_order_relaxed)) {
+                CloseHandle(ep.pipe);
+                ep.pipe = INVALID_HANDLE_VALUE;
+            }
+            if (ep.pipe == INVALID_HANDLE_VALUE && !create_pipe(ep, ec)) {
+                return false;
+            }
+
+            HANDLE completion_port = m_completion_port.load(std::memory_order_acquire);
+            for (;;) {
+                memset(&ep.connect_req.ov, 0, sizeof(OVERLAPPED));
+                ep.connect_req.endpoint = &ep;
+                ep.connect_pending = true;
+
+                BOOL connected = ConnectNamedPipe(ep.pipe, &ep.connect_req.ov);
+                DWORD err = connected ? ERROR_PIPE_CONNECTED : GetLastError();
+                if (err == ERROR_IO_PENDING) {
+                    return true;
+                }
+                if (err == ERROR_PIPE_CONNECTED) {
+                    // The client connected before ConnectNamedPipe was called
+                    PostQueuedCompletionStatus(completion_port, 0, 0, &ep.connect_req.ov);
+                    return true;
+                }
+                ep.connect_pending = false;
+                if (err == ERROR_NO_DATA) {
+                    // The client connected and already closed its handle
+                    DisconnectNamedPipe(ep.pipe);
+                    continue;
+                }
+                ec = system_error_code(err);
+                return false;
+            }
+        }
+
+        size_t translate(BOOL ok, DWORD err, DWORD bytes_transferred, ULONG_PTR key, OVERLAPPED* ov, IoEvent* events) {
+            if (ov == nullptr) {
+                if (ok) {
+                    events[0] = IoEvent(IoEventType::Command, static_cast<uintptr_t>(key));
+                    return 1;
+                }
+                if (err == WAIT_TIMEOUT) return 0;
+                events[0] = IoEvent(IoEventType::Error, 0, 0, system_error_code(err));
+                return 1;
+            }
+
+            IoRequest* req = reinterpret_cast<IoRequest*>(ov);
+            Endpoint& ep = *req->endpoint;
+            std::lock_guard<std::mutex> lock(ep.mutex);
+            size_t count = 0;
+
+            if (req == &ep.connect_req) {
+                ep.connect_pending = false;
+                if (ok || err == ERROR_PIPE_CONNECTED) {
+                    ep.connected = true;
+                    events[count++] = IoEvent(IoEventType::Connected, ep.slot);
+                } else
+                if (err != ERROR_OPERATION_ABORTED) {
+                    events[count++] = IoEvent(IoEventType::Error, ep.slot, 0, system_error_code(err));
+                    DisconnectNamedPipe(ep.pipe);
+                    ep.relisten = true;
+                }
+            } else
+            if (req == &ep.read_req) {
+                ep.read_pending = false;
+                if (ok || err == ERROR_MORE_DATA) {
+                    IoEvent event(IoEventType::Read, ep.slot, bytes_transferred);
+                    event.more_data = !ok;
+                    events[count++] = event;
+                } else
+                if (ep.connected) {
+                    events[count++] = IoEvent(IoEventType::Disconnected, ep.slot, 0, system_error_code(err));
+                }
+            } else
+            if (req == &ep.write_req) {
+                ep.write_pending = false;
+                events[count++] = IoEvent(IoEventType::Write, ep.slot, bytes_transferred, ok ? std::error_code() : system_error_code(err));
+            }
+
+            if (ep.relisten && !ep.connect_pending && !ep.read_pending && !ep.write_pending) {
+                ep.relisten = false;
+                std::error_code ec;
+                if (!start_connect(ep, ec) && count == 0) {
+                    events[count++] = IoEvent(IoEventType::Error, ep.slot, 0, ec);
+                }
+            }
+            return count;
+        }
+    };
+
+} // namespace detail
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_WIN32_PIPE_TRANSPORT_HPP_INCLUDED
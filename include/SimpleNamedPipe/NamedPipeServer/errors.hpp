@@ -11,7 +11,7 @@ namespace SimpleNamedPipe {
 
     /// \brief Error codes for NamedPipeServer operations.
     enum class NamedPipeErrc {
-        ClientIndexOutOfRange,           ///< Client index exceeds MAX_CLIENTS
+        ClientIndexOutOfRange,           ///< Client index exceeds the client table capacity
         InvalidPipeHandle,               ///< Pipe handle is invalid
         IoCompletionPortCreateFailed,    ///< Failed to create IO completion port
         NamedPipeCreateFailed,           ///< Failed to create named pipe
@@ -20,7 +20,19 @@ namespace SimpleNamedPipe {
         MessageTooLarge,                 ///< The message exceeds the allowed maximum size
         QueueFull,                       ///< The per-client write queue is full
         UnknownSystemError,              ///< Fallback for unexpected system errors
-        UnhandledException               ///< A generic std::exception was caught during runtime
+        UnhandledException,              ///< A generic std::exception was caught during runtime
+        IncomingMessageTooLarge,         ///< A client sent a message above ReadLimits::max_message_size
+        MessageDropped,                  ///< A queued message was dropped by SlowConsumerPolicy::DropOldest
+        SlowConsumer,                    ///< The client stayed above the high watermark for too long
+        Superseded,                      ///< A conflated message was replaced by a newer one with the same key
+        ClientStopped,                   ///< Operation aborted because the client is stopping or stopped
+        ReconnectFailed,                 ///< The client gave up after ReconnectPolicy::max_attempts
+        CallbackQueueFull,               ///< The callback queue overflowed under CallbackOverflowPolicy::Disconnect
+        SharedMemoryFailed,              ///< The shared memory fast path was refused or its ring is broken
+        IdleTimeout,                     ///< The client sent nothing for KeepAliveConfig::idle_timeout_ms
+        TimerCancelled,                  ///< A send_after() timer was cancelled or the server stopped before it fired
+        SessionFailed,                   ///< The session was refused or could not be resumed, messages may be missing
+        HeldForResume                    ///< The client dropped before the message was confirmed; its session keeps it for a resume
     };
 
     /// \brief Error category for NamedPipeErrc.
@@ -50,6 +62,32 @@ namespace SimpleNamedPipe {
                 return "Per-client write queue is full";
             case NamedPipeErrc::UnknownSystemError:
                 return "Unknown system error";
+            case NamedPipeErrc::UnhandledException:
+                return "Unhandled exception";
+            case NamedPipeErrc::IncomingMessageTooLarge:
+                return "Incoming message exceeds the receive limit";
+            case NamedPipeErrc::MessageDropped:
+                return "Queued message dropped for a slow consumer";
+            case NamedPipeErrc::SlowConsumer:
+                return "Client is too slow to read its messages";
+            case NamedPipeErrc::Superseded:
+                return "Message replaced by a newer one with the same key";
+            case NamedPipeErrc::ClientStopped:
+                return "Client has been stopped";
+            case NamedPipeErrc::ReconnectFailed:
+                return "Gave up reconnecting to the server";
+            case NamedPipeErrc::CallbackQueueFull:
+                return "Callback queue is full";
+            case NamedPipeErrc::SharedMemoryFailed:
+                return "Shared memory channel failed";
+            case NamedPipeErrc::IdleTimeout:
+                return "Client was idle for too long";
+            case NamedPipeErrc::TimerCancelled:
+                return "Scheduled send was cancelled";
+            case NamedPipeErrc::SessionFailed:
+                return "Session could not be resumed";
+            case NamedPipeErrc::HeldForResume:
+                return "Message held for the session to resume";
             default:
                 return "Unknown error";
             }
@@ -0,0 +1,10 @@
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4267)
+#endif
+
+#include "SimpleNamedPipe/NamedPipeClient/NamedPipeClient.ipp"
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
\ No newline at end of file
@@ -5,6 +5,10 @@
 
 #include "SimpleNamedPipe/NamedPipeServer/NamedPipeServer.ipp"
 
+namespace SimpleNamedPipe {
+    template class BasicNamedPipeServer<ServerCallbacks>;
+}
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
\ No newline at end of file
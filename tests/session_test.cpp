@@ -0,0 +1,232 @@
+/// \file session_test.cpp
+/// \brief Resumable sessions between NamedPipeServer and NamedPipeClient.
+///
+/// The server drops the client with its idle timeout, which keeps the
+/// session for the client to resume. The raw protocol checks speak the
+/// session handshake over a blocking client to control what is read.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "SimpleNamedPipe/NamedPipeClient.hpp"
+#include "bench_client.hpp"
+#include "test_util.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace SimpleNamedPipe;
+using test::check;
+using test::wait_until;
+
+namespace {
+
+    ServerConfig make_server_config(const std::string& pipe_name) {
+        ServerConfig config(pipe_name);
+        config.sessions.enabled = true;
+        config.sessions.resume_timeout_ms = 5000;
+        return config;
+    }
+
+    ClientConfig make_client_config(const std::string& pipe_name) {
+        ClientConfig config(pipe_name);
+        config.session.enabled = true;
+        config.reconnect.initial_delay_ms = 50;
+        config.reconnect.jitter = 0;
+        return config;
+    }
+
+    /// Opens a session over a raw connection; returns the welcome status.
+    bool open_raw_session(bench::BlockingClient& client, const std::string& pipe_name,
+                          std::string& token, uint64_t last_sequence, detail::SessionStatus& status) {
+        client.open(pipe_name);
+        std::string welcome;
+        return client.write(detail::make_session_hello(token, last_sequence)) && client.read(welcome) &&
+               detail::parse_session_welcome(welcome.data(), welcome.size(), token, status);
+    }
+
+    // Messages queued when the connection drops are held and arrive after
+    // the resume, once each and in order
+    void test_resume_delivers_missed_messages() {
+        ServerConfig config = make_server_config("SimpleNamedPipeSessionResume");
+        config.keep_alive.idle_timeout_ms = 200;
+        NamedPipeServer server(config);
+
+        std::atomic<int> live_id{-1};
+        std::atomic<int> previous_id{-1};
+        std::atomic<int> disconnects{0};
+        test::Recorder<std::error_code> held;
+        server.on_connected = [&](int client_id) {
+            live_id = client_id;
+        };
+        server.on_disconnected = [&](int client_id, const std::error_code&) {
+            // Still queued for this client when the session detaches
+            if (disconnects++ > 0) return;
+            for (int i = 1; i <= 3; ++i) {
+                server.send_to(client_id, "held-" + std::to_string(i), [&held](const std::error_code& ec) {
+                    held.add(ec);
+                });
+            }
+        };
+        server.on_session_resumed = [&](int, int previous_client_id) {
+            if (previous_id < 0) previous_id = previous_client_id;
+        };
+        server.start();
+
+        NamedPipeClient client(make_client_config(config.pipe_name));
+        test::Recorder<std::string> received;
+        test::Recorder<std::error_code> client_errors;
+        client.on_message = [&](const std::string& message) {
+            received.add(message);
+        };
+        client.on_error = [&](const std::error_code& ec) {
+            client_errors.add(ec);
+        };
+        client.start();
+
+        check(wait_until([&] { return live_id >= 0; }), "resume: client connected");
+        const int first_id = live_id;
+        for (int i = 1; i <= 3; ++i) server.send_to(first_id, "live-" + std::to_string(i));
+
+        check(wait_until([&] { return previous_id >= 0; }), "resume: session resumed after the idle timeout");
+        check(previous_id == first_id, "resume: on_session_resumed reports the previous client id");
+        check(wait_until([&] { return received.size() >= 6; }), "resume: missed messages arrive");
+        // Room for duplicates to show up
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        client.stop();
+        server.stop();
+
+        const std::vector<std::string> expected = {"live-1", "live-2", "live-3", "held-1", "held-2", "held-3"};
+        check(received.values() == expected, "resume: every message arrives exactly once and in order");
+        const std::vector<std::error_code> codes = held.values();
+        bool is_held = codes.size() == 3;
+        for (const auto& ec : codes) is_held = is_held && ec == NamedPipeErrc::HeldForResume;
+        check(is_held, "resume: held messages complete with HeldForResume");
+        check(client_errors.size() == 0, "resume: the client reports no error");
+    }
+
+    // A client returning after resume_timeout_ms gets a new session and says so
+    void test_expired_session_fails() {
+        ServerConfig config = make_server_config("SimpleNamedPipeSessionExpiry");
+        config.keep_alive.idle_timeout_ms = 200;
+        config.sessions.resume_timeout_ms = 50;
+        NamedPipeServer server(config);
+        std::atomic<int> resumes{0};
+        server.on_session_resumed = [&](int, int) {
+            ++resumes;
+        };
+        server.start();
+
+        ClientConfig client_config = make_client_config(config.pipe_name);
+        client_config.reconnect.initial_delay_ms = 400;
+        NamedPipeClient client(client_config);
+        test::Recorder<std::error_code> client_errors;
+        client.on_error = [&](const std::error_code& ec) {
+            client_errors.add(ec);
+        };
+        client.start();
+
+        check(wait_until([&] { return client_errors.size() > 0; }), "expiry: the client reports an error");
+        client.stop();
+        server.stop();
+
+        const std::vector<std::error_code> errors = client_errors.values();
+        check(!errors.empty() && errors.front() == NamedPipeErrc::SessionFailed, "expiry: the error is SessionFailed");
+        check(resumes == 0, "expiry: the server does not resume the session");
+    }
+
+    // Heartbeats are numbered but not kept, so a resume repeats only messages
+    void test_heartbeats_not_repeated() {
+        ServerConfig config = make_server_config("SimpleNamedPipeSessionHeartbeat");
+        config.keep_alive.heartbeat_interval_ms = 20;
+        NamedPipeServer server(config);
+        std::atomic<int> live_id{-1};
+        server.on_connected = [&](int client_id) {
+            live_id = client_id;
+        };
+        server.start();
+
+        bench::BlockingClient raw;
+        std::string token;
+        detail::SessionStatus status = detail::SessionStatus::Refused;
+        check(open_raw_session(raw, config.pipe_name, token, 0, status) && status == detail::SessionStatus::New,
+              "heartbeat: session opened");
+        check(wait_until([&] { return live_id >= 0; }), "heartbeat: client connected");
+
+        // Several heartbeats go out unread before the message
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        std::atomic<bool> is_sent{false};
+        server.send_to(live_id, "payload", [&](const std::error_code&) {
+            is_sent = true;
+        });
+        wait_until([&] { return is_sent.load(); });
+        raw.close();
+        wait_until([&] { return !server.is_connected(live_id); });
+
+        // Everything after sequence 0 is asked for again
+        check(open_raw_session(raw, config.pipe_name, token, 0, status) && status == detail::SessionStatus::Resumed,
+              "heartbeat: session resumed");
+        std::string message;
+        const bool is_read = raw.read(message) && message.size() >= detail::SEQUENCE_SIZE;
+        check(is_read && message.substr(detail::SEQUENCE_SIZE) == "payload",
+              "heartbeat: the first repeated message is the payload");
+        check(is_read && detail::read_sequence(message.data()) > 1,
+              "heartbeat: the heartbeats before it were numbered");
+        raw.close();
+        server.stop();
+    }
+
+    // Only the first chunk of a message could carry the sequence number
+    void test_message_above_buffer_size() {
+        ServerConfig config = make_server_config("SimpleNamedPipeSessionLarge");
+        config.buffer_size = 1024;
+        NamedPipeServer server(config);
+        std::atomic<int> live_id{-1};
+        server.on_connected = [&](int client_id) {
+            live_id = client_id;
+        };
+        server.start();
+
+        NamedPipeClient client(make_client_config(config.pipe_name));
+        test::Recorder<std::string> received;
+        client.on_message = [&](const std::string& message) {
+            received.add(message);
+        };
+        client.start();
+        check(wait_until([&] { return live_id >= 0; }), "large: client connected");
+        // Give the server time to read the hello and open the session
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        server.send_to(live_id, "first");
+        check(wait_until([&] { return received.size() >= 1; }), "large: first message arrives");
+
+        test::Recorder<std::error_code> results;
+        const std::string fitting(config.buffer_size - detail::SEQUENCE_SIZE, 'f');
+        server.send_to(live_id, std::string(4 * config.buffer_size, 'x'), [&](const std::error_code& ec) {
+            results.add(ec);
+        });
+        server.send_to(live_id, fitting, [&](const std::error_code& ec) {
+            results.add(ec);
+        });
+        server.send_to(live_id, "last", [&](const std::error_code& ec) {
+            results.add(ec);
+        });
+        check(wait_until([&] { return received.size() >= 3; }), "large: the messages behind it arrive");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        client.stop();
+        server.stop();
+
+        const std::vector<std::error_code> codes = results.values();
+        check(codes.size() == 3 && codes[0] == NamedPipeErrc::MessageTooLarge && !codes[1] && !codes[2],
+              "large: a message above buffer_size fails with MessageTooLarge");
+        const std::vector<std::string> expected = {"first", fitting, "last"};
+        check(received.values() == expected, "large: nothing of it reaches the client");
+    }
+
+} // namespace
+
+int main() {
+    test_resume_delivers_missed_messages();
+    test_expired_session_fails();
+    test_heartbeats_not_repeated();
+    test_message_above_buffer_size();
+    return test::finish();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef _SIMPLE_NAMED_PIPE_TEST_UTIL_HPP_INCLUDED
+#define _SIMPLE_NAMED_PIPE_TEST_UTIL_HPP_INCLUDED
+
+/// \file test_util.hpp
+/// \brief Checks and waits shared by the tests.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+namespace SimpleNamedPipe {
+namespace test {
+
+    /// \brief Number of failed checks so far.
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    /// \brief Prints the outcome of one check and counts a failure.
+    inline void check(bool condition, const std::string& what) {
+        std::cout << (condition ? "ok      " : "FAILED  ") << what << std::endl;
+        if (!condition) ++failures();
+    }
+
+    /// \brief Polls `condition` until it holds or `timeout_ms` passes.
+    /// \return Whether the condition held.
+    template <class Condition>
+    bool wait_until(Condition condition, int timeout_ms = 5000) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /// \brief Exit code of a test: prints the summary, non-zero on failure.
+    inline int finish() {
+        if (failures()) {
+            std::cout << failures() << " check(s) failed" << std::endl;
+            return 1;
+        }
+        std::cout << "all checks passed" << std::endl;
+        return 0;
+    }
+
+    /// \class Recorder
+    /// \brief Collects values from callbacks running on other threads.
+    template <class T>
+    class Recorder {
+    public:
+        void add(const T& value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_values.push_back(value);
+        }
+
+        std::vector<T> values() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_values;
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_values.size();
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<T>     m_values;
+    };
+
+} // namespace test
+} // namespace SimpleNamedPipe
+
+#endif // _SIMPLE_NAMED_PIPE_TEST_UTIL_HPP_INCLUDED
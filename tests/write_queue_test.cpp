@@ -0,0 +1,276 @@
+/// \file write_queue_test.cpp
+/// \brief Slow-consumer policies, on_writable and priority lanes.
+///
+/// A blocking client that stops reading lets the server's writes stall, so
+/// messages stay queued for the policies and the priority lanes to act on.
+
+#include "SimpleNamedPipe/NamedPipeServer.hpp"
+#include "bench_client.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace SimpleNamedPipe;
+using test::check;
+using test::wait_until;
+
+namespace {
+
+    const size_t MESSAGE_SIZE = 1000;
+    const size_t MESSAGE_COUNT = 2000;
+
+    ServerConfig make_config(const std::string& pipe_name, SlowConsumerPolicy policy) {
+        ServerConfig config(pipe_name);
+        config.write_limits.max_pending_writes_per_client = 100000;
+        config.write_limits.max_message_size = 8 * 1024 * 1024;
+        config.write_limits.high_watermark_bytes = 64 * 1024;
+        config.write_limits.low_watermark_bytes = 16 * 1024;
+        config.write_limits.slow_consumer = policy;
+        return config;
+    }
+
+    /// A numbered message of MESSAGE_SIZE bytes.
+    std::string make_message(size_t number) {
+        std::string message = std::to_string(number);
+        message.resize(MESSAGE_SIZE, ' ');
+        return message;
+    }
+
+    size_t message_number(const std::string& message) {
+        return static_cast<size_t>(std::strtoul(message.c_str(), nullptr, 10));
+    }
+
+    /// Connects a client that does not read until told to.
+    int connect_client(NamedPipeServer& server, bench::BlockingClient& client, const std::string& pipe_name) {
+        std::atomic<int> client_id{-1};
+        server.on_connected = [&client_id](int id) {
+            client_id = id;
+        };
+        client.open(pipe_name);
+        wait_until([&] { return client_id >= 0; });
+        server.on_connected = nullptr;
+        return client_id;
+    }
+
+    // Reject: sends above the high watermark fail at once, on_writable
+    // follows once the client catches up
+    void test_reject() {
+        ServerConfig config = make_config("SimpleNamedPipeQueueReject", SlowConsumerPolicy::Reject);
+        NamedPipeServer server(config);
+        test::Recorder<std::string> events;
+        server.on_writable = [&](int) {
+            events.add("writable");
+        };
+        server.start();
+        bench::BlockingClient client;
+        const int client_id = connect_client(server, client, config.pipe_name);
+
+        std::atomic<size_t> completed{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<size_t> rejected{0};
+        size_t accepted = 0;
+        for (size_t i = 0; i < 100 * MESSAGE_COUNT && rejected == 0; ++i) {
+            server.send_to(client_id, make_message(i), [&](const std::error_code& ec) {
+                if (ec == NamedPipeErrc::QueueFull) {
+                    // Completes inside send_to()
+                    events.add("rejected");
+                    ++rejected;
+                    return;
+                }
+                if (ec) ++failed;
+                ++completed;
+            });
+            if (rejected == 0) ++accepted;
+        }
+        check(rejected == 1, "reject: a send above the high watermark fails with QueueFull");
+        check(server.get_queue_depth(client_id).bytes <= config.write_limits.high_watermark_bytes,
+              "reject: the queue stays within the high watermark");
+
+        std::string message;
+        size_t received = 0;
+        while (received < accepted && client.read(message)) ++received;
+        check(received == accepted, "reject: every accepted message arrives");
+        check(wait_until([&] { return completed == accepted; }) && failed == 0, "reject: accepted messages complete without error");
+        check(wait_until([&] { return events.size() >= 2; }) &&
+              events.values() == std::vector<std::string>{"rejected", "writable"},
+              "reject: on_writable follows the rejection");
+        client.close();
+        server.stop();
+    }
+
+    // DropOldest: queued messages give way to newer ones, the newest arrives
+    void test_drop_oldest() {
+        ServerConfig config = make_config("SimpleNamedPipeQueueDropOldest", SlowConsumerPolicy::DropOldest);
+        NamedPipeServer server(config);
+        server.start();
+        bench::BlockingClient client;
+        const int client_id = connect_client(server, client, config.pipe_name);
+
+        std::vector<std::error_code> results(MESSAGE_COUNT);
+        std::atomic<size_t> completed{0};
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+            server.send_to(client_id, make_message(i), [&results, &completed, i](const std::error_code& ec) {
+                results[i] = ec;
+                ++completed;
+            });
+        }
+
+        std::vector<size_t> received;
+        std::string message;
+        while (client.read(message)) {
+            received.push_back(message_number(message));
+            if (received.back() == MESSAGE_COUNT - 1) break;
+        }
+        check(wait_until([&] { return completed == MESSAGE_COUNT; }), "drop oldest: every send completes");
+        client.close();
+        server.stop();
+
+        size_t dropped = 0;
+        bool is_known = true;
+        std::vector<size_t> delivered;
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+            if (results[i] == NamedPipeErrc::MessageDropped) {
+                ++dropped;
+            } else if (!results[i]) {
+                delivered.push_back(i);
+            } else {
+                is_known = false;
+            }
+        }
+        check(dropped > 0, "drop oldest: messages above the high watermark fail with MessageDropped");
+        check(is_known, "drop oldest: no other error is reported");
+        check(received == delivered, "drop oldest: exactly the messages not dropped arrive, in order");
+        check(!received.empty() && received.back() == MESSAGE_COUNT - 1, "drop oldest: the newest message arrives");
+    }
+
+    // Disconnect: a client above the high watermark for slow_consumer_timeout_ms is dropped
+    void test_disconnect() {
+        ServerConfig config = make_config("SimpleNamedPipeQueueDisconnect", SlowConsumerPolicy::Disconnect);
+        config.write_limits.slow_consumer_timeout_ms = 100;
+        NamedPipeServer server(config);
+        test::Recorder<std::string> events;
+        std::atomic<bool> is_disconnected{false};
+        std::error_code reason;
+        server.on_disconnected = [&](int, const std::error_code& ec) {
+            reason = ec;
+            events.add("disconnected");
+            is_disconnected = true;
+        };
+        server.start();
+        bench::BlockingClient client;
+        const int client_id = connect_client(server, client, config.pipe_name);
+
+        std::atomic<size_t> completed{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<size_t> other{0};
+        const auto started = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+            server.send_to(client_id, make_message(i), [&](const std::error_code& ec) {
+                if (ec == NamedPipeErrc::NotConnected) {
+                    if (failed++ == 0) events.add("failed");
+                } else if (ec) {
+                    ++other;
+                }
+                ++completed;
+            });
+        }
+
+        check(wait_until([&] { return is_disconnected.load(); }), "disconnect: the slow client is dropped");
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        check(reason == NamedPipeErrc::SlowConsumer, "disconnect: on_disconnected reports SlowConsumer");
+        check(elapsed >= std::chrono::milliseconds(config.write_limits.slow_consumer_timeout_ms),
+              "disconnect: not before slow_consumer_timeout_ms");
+        check(wait_until([&] { return completed == MESSAGE_COUNT; }), "disconnect: every send completes");
+        check(failed > 0 && other == 0, "disconnect: queued messages fail with NotConnected");
+        const std::vector<std::string> order = events.values();
+        check(order.size() == 2 && order[0] == "disconnected" && order[1] == "failed",
+              "disconnect: on_disconnected comes before the failed sends");
+        client.close();
+        server.stop();
+    }
+
+    // Priority lanes: High messages go ahead of queued Normal ones and between
+    // the chunks of a large message, each of them overtaken at most max_overtakes times
+    void test_max_overtakes() {
+        ServerConfig config = make_config("SimpleNamedPipeQueuePriority", SlowConsumerPolicy::Reject);
+        config.buffer_size = 1024;
+        config.write_limits.high_watermark_bytes = 0;
+        config.write_limits.max_overtakes = 2;
+        NamedPipeServer server(config);
+        server.start();
+        bench::BlockingClient client;
+        const int client_id = connect_client(server, client, config.pipe_name);
+
+        // More than the socket holds, so it stalls between two chunks
+        const size_t chunks = 4096;
+        server.send_to(client_id, std::string(chunks * config.buffer_size, 'B'));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // Interleaved; the send order is the order within each lane
+        std::vector<std::string> sent;
+        for (int i = 0; i < 8; ++i) {
+            sent.push_back("N" + std::to_string(i));
+            server.send_to(client_id, sent.back());
+            sent.push_back("H" + std::to_string(i));
+            server.send_to(client_id, sent.back(), SendPriority::High);
+        }
+
+        // "B" stands for each chunk of the large message
+        std::vector<std::string> received;
+        std::string message;
+        while (received.size() < chunks + sent.size() && client.read(message)) {
+            received.push_back(message[0] == 'B' ? std::string("B") : message);
+        }
+        client.close();
+        server.stop();
+        check(received.size() == chunks + sent.size(), "priority: every message arrives");
+
+        std::map<std::string, size_t> sent_at;
+        for (size_t i = 0; i < sent.size(); ++i) sent_at[sent[i]] = i;
+        std::vector<std::string> normal;
+        std::vector<std::string> high;
+        size_t most_overtaken = 0;
+        size_t chunks_received = 0;
+        for (size_t i = 0; i < received.size(); ++i) {
+            if (received[i][0] == 'H') {
+                high.push_back(received[i]);
+                continue;
+            }
+            if (received[i][0] == 'N') {
+                normal.push_back(received[i]);
+            } else if (++chunks_received < chunks) {
+                // The large message is overtaken by the time its last chunk arrives
+                continue;
+            }
+            // High messages sent after this one but delivered before it
+            size_t overtaken = 0;
+            for (size_t j = 0; j < i; ++j) {
+                if (received[j][0] == 'H' && (received[i] == "B" || sent_at[received[j]] > sent_at[received[i]])) {
+                    ++overtaken;
+                }
+            }
+            most_overtaken = (std::max)(most_overtaken, overtaken);
+        }
+
+        check(high == std::vector<std::string>{"H0", "H1", "H2", "H3", "H4", "H5", "H6", "H7"} &&
+              normal == std::vector<std::string>{"N0", "N1", "N2", "N3", "N4", "N5", "N6", "N7"},
+              "priority: each lane keeps its order");
+        check(most_overtaken > 0, "priority: High messages go ahead of queued ones");
+        check(most_overtaken <= config.write_limits.max_overtakes,
+              "priority: no message is overtaken more than max_overtakes times");
+    }
+
+} // namespace
+
+int main() {
+    test_reject();
+    test_drop_oldest();
+    test_disconnect();
+    test_max_overtakes();
+    return test::finish();
+}